@@ -0,0 +1,258 @@
+// Compiler throughput benchmark: time every phase across input sizes.
+//
+// Usage: bench/compilebench [--sizes 1K,10K,...] [--out FILE] [--baseline FILE]
+// For each size, bench/gensrc writes a synthetic program, and ./acompiler
+// compiles it with --stats=json, several times for small sizes (the fastest
+// run counts). Each result is appended to FILE (default
+// bench/results.jsonl) as one JSON line holding the size and the
+// compiler's statistics, and printed as nanoseconds per input byte by
+// phase.
+//
+// Time per byte should stay flat as the input grows. If a phase takes more
+// than twice as long per byte at a larger size as at 1 MB, it scales
+// superlinearly (like a quadratic lookup would) and the benchmark fails.
+// --baseline compares the total time of each size with an earlier results
+// file.
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE  // mkstemps
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define MAX_SIZES 16
+#define SCALING_LIMIT 2.0
+
+static char *phases[] = {"read", "tokenize", "parse", "fold", "ir", "codegen"};
+#define NUM_PHASES (sizeof(phases) / sizeof(*phases))
+
+typedef struct Result {
+    char *size_arg;
+    long size;
+    long bytes;
+    int runs;
+    double phase_ms[NUM_PHASES];
+    double total_ms;
+    long peak_rss_kb;
+    char *json;       // Statistics line of the fastest run
+} Result;
+
+static long parse_size(char *s) {
+    char *end;
+    long size = strtol(s, &end, 10);
+    if (*end == 'K' || *end == 'k')
+        size <<= 10;
+    else if (*end == 'M' || *end == 'm')
+        size <<= 20;
+    else if (*end == 'G' || *end == 'g')
+        size <<= 30;
+    return size;
+}
+
+// Run argv with standard output to out_path (unless NULL) and standard
+// error into a new string. Exits if the command fails.
+static char *run(char **argv, char *out_path) {
+    int pipefd[2];
+    if (pipe(pipefd)) {
+        perror("pipe");
+        exit(1);
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        if (out_path) {
+            int fd = open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0) {
+                perror(out_path);
+                _exit(1);
+            }
+            dup2(fd, 1);
+        }
+        dup2(pipefd[1], 2);
+        close(pipefd[0]);
+        execv(argv[0], argv);
+        perror(argv[0]);
+        _exit(1);
+    }
+    close(pipefd[1]);
+
+    long len = 0, cap = 4096;
+    char *buf = malloc(cap);
+    for (;;) {
+        if (len + 1 == cap)
+            buf = realloc(buf, cap *= 2);
+        ssize_t n = read(pipefd[0], buf + len, cap - len - 1);
+        if (n <= 0)
+            break;
+        len += n;
+    }
+    buf[len] = '\0';
+    close(pipefd[0]);
+
+    int status;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status)) {
+        fprintf(stderr, "%s failed:\n%s", argv[0], buf);
+        exit(1);
+    }
+    return buf;
+}
+
+// The number after "key": in json, searching from after
+static double number(char *json, char *after, char *key) {
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"%s\": ", key);
+    char *p = strstr(after ? strstr(json, after) : json, pattern);
+    return p ? atof(p + strlen(pattern)) : 0;
+}
+
+static void measure(Result *r, char *compiler, char *source) {
+    char *argv[] = {compiler, "--stats=json", "-o", "/dev/null", source, NULL};
+    r->runs = r->size >= (4 << 20) ? 1 : r->size >= (256 << 10) ? 3 : 10;
+    for (int i = 0; i < r->runs; i++) {
+        char *json = run(argv, NULL);
+        double total = 0, phase_ms[NUM_PHASES];
+        for (int j = 0; j < NUM_PHASES; j++) {
+            char after[32];
+            snprintf(after, sizeof(after), "\"%s\": {", phases[j]);
+            phase_ms[j] = number(json, after, "wall_ms");
+            total += phase_ms[j];
+        }
+        if (r->json && total >= r->total_ms) {
+            free(json);
+            continue;
+        }
+        free(r->json);
+        r->json = json;
+        r->total_ms = total;
+        memcpy(r->phase_ms, phase_ms, sizeof(phase_ms));
+        r->peak_rss_kb = number(json, NULL, "peak_rss_kb");
+    }
+    r->json[strcspn(r->json, "\n")] = '\0';
+}
+
+static double ns_per_byte(Result *r, double ms) {
+    return ms * 1e6 / r->bytes;
+}
+
+// Total time of size in an earlier results file, or 0
+static double baseline_ms(char *path, long size) {
+    FILE *fp = fopen(path, "r");
+    if (!fp)
+        return 0;
+    char *line = NULL;
+    size_t cap = 0;
+    double ms = 0;
+    while (getline(&line, &cap, fp) > 0) {
+        if ((long)number(line, NULL, "size") != size)
+            continue;
+        ms = 0;
+        for (int j = 0; j < NUM_PHASES; j++) {
+            char after[32];
+            snprintf(after, sizeof(after), "\"%s\": {", phases[j]);
+            ms += number(line, after, "wall_ms");
+        }
+    }
+    free(line);
+    fclose(fp);
+    return ms;
+}
+
+int main(int argc, char **argv) {
+    char *sizes = "1K,10K,100K,1M,10M,100M";
+    char *out_path = "bench/results.jsonl";
+    char *baseline = NULL;
+    char *compiler = "./acompiler";
+    char *generator = "bench/gensrc";
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--sizes"))
+            sizes = argv[i + 1];
+        else if (!strcmp(argv[i], "--out"))
+            out_path = argv[i + 1];
+        else if (!strcmp(argv[i], "--baseline"))
+            baseline = argv[i + 1];
+        else {
+            fprintf(stderr, "Usage: %s [--sizes 1K,10K,...] [--out FILE] [--baseline FILE]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    char source[] = "/tmp/acompiler-bench-XXXXXX.c";
+    int fd = mkstemps(source, 2);
+    if (fd < 0) {
+        perror("mkstemps");
+        return 1;
+    }
+    close(fd);
+    FILE *out = fopen(out_path, "a");
+    if (!out) {
+        perror(out_path);
+        return 1;
+    }
+
+    Result results[MAX_SIZES] = {0};
+    int n = 0;
+    char *list = strdup(sizes);
+    printf("%8s %10s %5s %10s %8s", "size", "bytes", "runs", "total ms", "MB/s");
+    for (int j = 0; j < NUM_PHASES; j++)
+        printf(" %8s", phases[j]);
+    printf(" %9s\n", "peak RSS");
+    printf("%45s%s\n", "", "(ns per byte)");
+
+    for (char *s = strtok(list, ","); s && n < MAX_SIZES; s = strtok(NULL, ",")) {
+        Result *r = &results[n++];
+        r->size_arg = s;
+        r->size = parse_size(s);
+        char *gen_argv[] = {generator, s, NULL};
+        free(run(gen_argv, source));
+        struct stat st;
+        stat(source, &st);
+        r->bytes = st.st_size;
+        measure(r, compiler, source);
+
+        fprintf(out, "{\"size\": %ld, \"bytes\": %ld, \"runs\": %d, \"stats\": %s}\n",
+                r->size, r->bytes, r->runs, r->json);
+        fflush(out);
+        printf("%8s %10ld %5d %10.2f %8.2f", s, r->bytes, r->runs, r->total_ms,
+               r->bytes / 1048576.0 / (r->total_ms / 1e3));
+        for (int j = 0; j < NUM_PHASES; j++)
+            printf(" %8.1f", ns_per_byte(r, r->phase_ms[j]));
+        printf(" %6ld MB", r->peak_rss_kb / 1024);
+        if (baseline) {
+            double old = baseline_ms(baseline, r->size);
+            if (old > 0)
+                printf("  %.2fx baseline", r->total_ms / old);
+        }
+        printf("\n");
+        fflush(stdout);
+    }
+    fclose(out);
+    unlink(source);
+
+    // Compare time per byte with the first size of at least 1 MB, where
+    // fixed costs no longer matter
+    int ref = -1;
+    for (int i = 0; i < n && ref < 0; i++)
+        if (results[i].bytes >= (1 << 20))
+            ref = i;
+    int failed = 0;
+    for (int i = ref + 1; ref >= 0 && i < n; i++) {
+        for (int j = 0; j < NUM_PHASES; j++) {
+            if (results[ref].phase_ms[j] < 1)
+                continue;
+            double ratio = ns_per_byte(&results[i], results[i].phase_ms[j]) /
+                           ns_per_byte(&results[ref], results[ref].phase_ms[j]);
+            if (ratio > SCALING_LIMIT) {
+                printf("superlinear: %s takes %.1fx as long per byte at %s as at %s\n",
+                       phases[j], ratio, results[i].size_arg, results[ref].size_arg);
+                failed = 1;
+            }
+        }
+    }
+    printf("Results appended to %s\n", out_path);
+    return failed;
+}
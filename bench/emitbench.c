@@ -0,0 +1,108 @@
+// Emitter benchmark: bytes per second of assembly text.
+//
+// Usage: bench/emitbench [blocks]
+// The same instruction mix is written once with fprintf, as the code
+// generators used to, and once through the buffered emitter. Both outputs
+// go to temporary files, which must come out identical.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../src/compiler.h"
+#include <time.h>
+#include <unistd.h>
+
+int opt_jobs = 1;
+int opt_peephole = 0;
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void stdio_block(FILE *fp, int i) {
+    fprintf(fp, ".Lbench.%d:\n", i);
+    fprintf(fp, "  mov rax, [rbp-%d]\n", 8 + i % 64 * 8);
+    fprintf(fp, "  add rax, %d\n", i);
+    fprintf(fp, "  mov %s, rax\n", "r12");
+    fprintf(fp, "  cmp rax, %d\n", -i);
+    fprintf(fp, "  %s al\n", "setl");
+    fprintf(fp, "  movzb rax, al\n");
+    fprintf(fp, "  je .Lbench.%d\n", i + 1);
+    fprintf(fp, "  push %s\n", "rdi");
+    fprintf(fp, "  call %s\n", "helper_function");
+    fprintf(fp, "  mov [rdi], rax\n");
+}
+
+static void emit_block(int i) {
+    emit_label(i);
+    emit2(I_MOV, op_reg(RAX), op_mem(RBP, -(8 + i % 64 * 8)));
+    emit2(I_ADD, op_reg(RAX), op_imm(i));
+    emit2(I_MOV, op_reg(R12), op_reg(RAX));
+    emit2(I_CMP, op_reg(RAX), op_imm(-i));
+    emit1(I_SETL, op_reg(RAX));
+    emit2(I_MOVZB, op_reg(RAX), op_reg(RAX));
+    emit1(I_JE, op_label(i + 1));
+    emit1(I_PUSH, op_reg(RDI));
+    emit1(I_CALL, op_sym("helper_function"));
+    emit2(I_MOV, op_mem(RDI, 0), op_reg(RAX));
+}
+
+static long file_size(char *path) {
+    FILE *fp = fopen(path, "r");
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fclose(fp);
+    return size;
+}
+
+static int same_file(char *a, char *b) {
+    FILE *fa = fopen(a, "r");
+    FILE *fb = fopen(b, "r");
+    int ca, cb;
+    do {
+        ca = getc(fa);
+        cb = getc(fb);
+    } while (ca == cb && ca != EOF);
+    fclose(fa);
+    fclose(fb);
+    return ca == cb;
+}
+
+int main(int argc, char **argv) {
+    int blocks = argc > 1 ? atoi(argv[1]) : 300000;
+    char stdio_path[] = "/tmp/emitbench.stdio.XXXXXX";
+    char emit_path[] = "/tmp/emitbench.emit.XXXXXX";
+    close(mkstemp(stdio_path));
+    close(mkstemp(emit_path));
+
+    double start = now();
+    FILE *fp = fopen(stdio_path, "w");
+    fprintf(fp, ".globl bench\nbench:\n");
+    for (int i = 0; i < blocks; i++)
+        stdio_block(fp, i);
+    fclose(fp);
+    double stdio_time = now() - start;
+
+    start = now();
+    emit_open(emit_path, OUT_ASM);
+    emit_func("bench");
+    for (int i = 0; i < blocks; i++)
+        emit_block(i);
+    emit_close();
+    double emit_time = now() - start;
+
+    long bytes = file_size(emit_path);
+    int same = same_file(stdio_path, emit_path);
+    unlink(stdio_path);
+    unlink(emit_path);
+    if (!same) {
+        fprintf(stderr, "emitter output differs from stdio output\n");
+        return 1;
+    }
+
+    printf("output:  %.1f MB, %d instructions\n", bytes / 1e6, blocks * 10);
+    printf("stdio    %.3f s, %.1f MB/s\n", stdio_time, bytes / stdio_time / 1e6);
+    printf("emitter  %.3f s, %.1f MB/s\n", emit_time, bytes / emit_time / 1e6);
+    return 0;
+}
@@ -0,0 +1,147 @@
+// Synthetic input generator for the compiler benchmarks.
+//
+// Usage: bench/gensrc <size>[K|M|G]
+// Writes a program of about size bytes in the supported C subset to
+// standard output. It cycles through function shapes that each stress a
+// different part of the compiler:
+//
+//   arith    short functions with loops, branches and calls (the common case)
+//   deep     expressions nested DEPTH levels deep
+//   block    long runs of statements in nested blocks
+//   locals   many locals, each declared and used
+//   strings  many string literals
+//
+// One more function gets a twentieth of the size as locals and statements,
+// so that behavior that is quadratic within a function shows up as
+// superlinear scaling of the whole input. The program ends with main and
+// compiles with gcc as well. The output depends only on the size.
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEPTH 40
+#define BLOCK_DEPTH 8
+#define NUM_LOCALS 64
+#define NUM_STRINGS 16
+
+static long written;
+static unsigned long seed = 12345;
+
+static void out(char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    written += vprintf(fmt, ap);
+    va_end(ap);
+}
+
+// Small pseudo-random numbers, the same on every run
+static int rnd(int n) {
+    seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+    return (seed >> 33) % n;
+}
+
+static void gen_arith(int id, int prev) {
+    int k = rnd(90) + 10;
+    out("int f%d(int a, int b) {\n", id);
+    out("    int x;\n    int y;\n");
+    out("    x = a * %d + b - %d;\n", k, rnd(100));
+    if (prev >= 0)
+        out("    x = x + f%d(b, a) %% %d;\n", prev, k);
+    out("    y = 0;\n");
+    out("    while (x > %d) { x = x - %d; y = y + 1; }\n", k, k + 1);
+    out("    for (y = y; y < %d; y = y + 1) x = x + y;\n", rnd(20));
+    out("    if (x < y) return y - x;\n    else return x + y;\n}\n");
+}
+
+static void gen_deep(int id) {
+    static char *ops[] = {"+", "-", "*"};
+    out("int d%d(int a, int b) {\n    return ", id);
+    for (int i = 0; i < DEPTH; i++)
+        out("(");
+    out("a");
+    for (int i = 0; i < DEPTH; i++) {
+        if (i % 2)
+            out(" %s %d)", ops[rnd(3)], rnd(9) + 1);
+        else
+            out(" %s (b - %d))", ops[rnd(3)], rnd(9));
+    }
+    out(";\n}\n");
+}
+
+static void gen_block(int id) {
+    out("int b%d(int a) {\n    int s;\n    int t;\n    s = a;\n    t = 1;\n", id);
+    for (int i = 0; i < BLOCK_DEPTH; i++) {
+        out("%*s{\n", 4 + 4 * i, "");
+        for (int j = 0; j < 6; j++)
+            out("%*ss = s + t * %d;\n%*st = t + s %% %d;\n",
+                8 + 4 * i, "", rnd(50), 8 + 4 * i, "", rnd(50) + 1);
+    }
+    for (int i = BLOCK_DEPTH - 1; i >= 0; i--)
+        out("%*s}\n", 4 + 4 * i, "");
+    out("    return s + t;\n}\n");
+}
+
+static void gen_locals(char *name, int n) {
+    out("int %s(int a) {\n", name);
+    for (int i = 0; i < n; i++)
+        out("    int v%d;\n", i);
+    out("    v0 = a;\n");
+    for (int i = 1; i < n; i++)
+        out("    v%d = v%d + %d;\n", i, rnd(i), rnd(100));
+    out("    return v%d;\n}\n", n - 1);
+}
+
+static void gen_strings(int id) {
+    out("int s%d(int a) {\n", id);
+    for (int i = 0; i < NUM_STRINGS; i++)
+        out("    char *s%d;\n", i);
+    for (int i = 0; i < NUM_STRINGS; i++)
+        out("    s%d = \"string %d of function %d\\twith an escape\\n\";\n", i, i, id);
+    out("    return a + *s%d + *s%d;\n}\n", rnd(NUM_STRINGS), rnd(NUM_STRINGS));
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <size>[K|M|G]\n", argv[0]);
+        return 1;
+    }
+    char *end;
+    long size = strtol(argv[1], &end, 10);
+    if (*end == 'K' || *end == 'k')
+        size <<= 10;
+    else if (*end == 'M' || *end == 'm')
+        size <<= 20;
+    else if (*end == 'G' || *end == 'g')
+        size <<= 30;
+    static char buf[1 << 16];
+    setvbuf(stdout, buf, _IOFBF, sizeof(buf));
+
+    // The function that grows with the input takes about 42 bytes a local
+    long grow_locals = size / 20 / 42;
+    if (grow_locals < 2)
+        grow_locals = 2;
+    long budget = size - grow_locals * 42;
+
+    int last_arith = -1;
+    for (int id = 0; written < budget || last_arith < 0; id++) {
+        char name[32];
+        switch (id % 8) {
+        case 2: gen_deep(id); break;
+        case 4: gen_block(id); break;
+        case 5:
+            sprintf(name, "l%d", id);
+            gen_locals(name, NUM_LOCALS);
+            break;
+        case 7: gen_strings(id); break;
+        default:
+            gen_arith(id, last_arith);
+            last_arith = id;
+            break;
+        }
+    }
+    gen_locals("grow", grow_locals);
+    out("int main() {\n    return (f0(3, 4) + grow(1)) %% 256;\n}\n");
+    return 0;
+}
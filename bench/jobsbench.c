@@ -0,0 +1,97 @@
+// Parallel code generation benchmark: code generation time against -j.
+//
+// Usage: bench/jobsbench [functions] [max-threads]
+// The input has thousands of small functions with loops and calls. It is
+// parsed once and then compiled with 1, 2, 4, ... threads; each output
+// must be identical to the one-thread output.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../src/compiler.h"
+#include <time.h>
+#include <unistd.h>
+
+int opt_regalloc = 1;
+int opt_ir = 0;
+int opt_fold = 1;
+int opt_peephole = 1;
+int opt_report = 0;
+int opt_jobs = 1;
+int opt_inline_threshold = 0;
+
+static char *synthesize(int num_funcs) {
+    char *buf = malloc(num_funcs * 256 + 64);
+    int len = 0;
+    for (int i = 0; i < num_funcs; i++) {
+        len += sprintf(buf + len,
+                       "int f%d(int n) {\n"
+                       "    int s;\n    int i;\n    s = %d;\n"
+                       "    for (i = 0; i < n; i = i + 1)\n"
+                       "        if (i * %d > s) s = s + i * 3 - %d; else s = s - 1;\n"
+                       "    return s;\n}\n",
+                       i, i, i % 7 + 1, i % 5);
+    }
+    sprintf(buf + len, "int main() {\n    return f0(10);\n}\n");
+    return buf;
+}
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static char *read_file(char *path, long *size) {
+    FILE *fp = fopen(path, "r");
+    fseek(fp, 0, SEEK_END);
+    *size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    char *data = malloc(*size);
+    fread(data, 1, *size, fp);
+    fclose(fp);
+    return data;
+}
+
+int main(int argc, char **argv) {
+    int num_funcs = argc > 1 ? atoi(argv[1]) : 20000;
+    int max_jobs = argc > 2 ? atoi(argv[2]) : 8;
+    char path[] = "/tmp/jobsbench.XXXXXX";
+    close(mkstemp(path));
+
+    user_input = synthesize(num_funcs);
+    tokenize(user_input);
+    Function *prog = program();
+    fold(prog);
+
+    printf("%d functions, %ld CPUs online\n", num_funcs, sysconf(_SC_NPROCESSORS_ONLN));
+    printf("%8s %10s %8s\n", "threads", "codegen ms", "speedup");
+    char *serial = NULL;
+    long serial_size = 0;
+    double serial_time = 0;
+    for (int jobs = 1; jobs <= max_jobs; jobs *= 2) {
+        opt_jobs = jobs;
+        double start = now();
+        emit_open(path, OUT_ASM);
+        codegen(prog);
+        emit_close();
+        double elapsed = now() - start;
+
+        long size;
+        char *out = read_file(path, &size);
+        if (!serial) {
+            serial = out;
+            serial_size = size;
+            serial_time = elapsed;
+        } else {
+            if (size != serial_size || memcmp(out, serial, size)) {
+                fprintf(stderr, "output with %d threads differs from serial output\n", jobs);
+                unlink(path);
+                return 1;
+            }
+            free(out);
+        }
+        printf("%8d %10.2f %7.2fx\n", jobs, elapsed * 1e3, serial_time / elapsed);
+    }
+    unlink(path);
+    return 0;
+}
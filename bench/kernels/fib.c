@@ -0,0 +1,11 @@
+// Kernel: recursive Fibonacci (calls and returns)
+
+int fib(int n) {
+    if (n <= 1)
+        return n;
+    return fib(n - 1) + fib(n - 2);
+}
+
+int main() {
+    return fib(35) % 256;
+}
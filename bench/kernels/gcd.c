@@ -0,0 +1,22 @@
+// Kernel: Euclid's algorithm over all pairs (division and branches)
+
+int gcd(int a, int b) {
+    int temp;
+    while (b != 0) {
+        temp = b;
+        b = a % b;
+        a = temp;
+    }
+    return a;
+}
+
+int main() {
+    int i;
+    int j;
+    int sum;
+    sum = 0;
+    for (i = 1; i < 2000; i = i + 1)
+        for (j = 1; j < 2000; j = j + 1)
+            sum = (sum + gcd(i, j)) % 1000003;
+    return sum % 256;
+}
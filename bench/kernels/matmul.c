@@ -0,0 +1,60 @@
+// Kernel: matrix multiply through pointers (loads, multiplies, nested loops)
+//
+// Matrices are n * n ints, row by row, sizeof(int) bytes apart from a
+// char pointer.
+
+int fill(char *m, int n, int seed) {
+    int *p;
+    int i;
+    for (i = 0; i < n * n; i = i + 1) {
+        p = m + i * sizeof(int);
+        seed = (seed * 1103 + 12345) % 65536;
+        *p = seed % 100;
+    }
+    return seed;
+}
+
+int multiply(char *c, char *a, char *b, int n) {
+    int *p;
+    int *q;
+    int i;
+    int j;
+    int k;
+    int sum;
+    for (i = 0; i < n; i = i + 1) {
+        for (j = 0; j < n; j = j + 1) {
+            sum = 0;
+            for (k = 0; k < n; k = k + 1) {
+                p = a + (i * n + k) * sizeof(int);
+                q = b + (k * n + j) * sizeof(int);
+                sum = sum + *p * *q;
+            }
+            p = c + (i * n + j) * sizeof(int);
+            *p = sum % 1000;
+        }
+    }
+    return 0;
+}
+
+int main() {
+    char *a;
+    char *b;
+    char *c;
+    int *p;
+    int n;
+    int i;
+    int sum;
+    n = 400;
+    a = calloc(n * n, sizeof(int));
+    b = calloc(n * n, sizeof(int));
+    c = calloc(n * n, sizeof(int));
+    fill(a, n, 1);
+    fill(b, n, 2);
+    multiply(c, a, b, n);
+    sum = 0;
+    for (i = 0; i < n * n; i = i + 1) {
+        p = c + i * sizeof(int);
+        sum = (sum + *p) % 65536;
+    }
+    return sum % 256;
+}
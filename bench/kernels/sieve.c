@@ -0,0 +1,37 @@
+// Kernel: sieve of Eratosthenes (memory stores in a loop)
+//
+// Elements are sizeof(int) bytes apart from a char pointer, which
+// addresses them the same way in every compiler.
+
+int sieve(char *flags, int n) {
+    int *p;
+    int i;
+    int j;
+    int count;
+    for (i = 2; i < n; i = i + 1) {
+        p = flags + i * sizeof(int);
+        *p = 1;
+    }
+    count = 0;
+    for (i = 2; i < n; i = i + 1) {
+        p = flags + i * sizeof(int);
+        if (*p) {
+            count = count + 1;
+            for (j = i + i; j < n; j = j + i) {
+                p = flags + j * sizeof(int);
+                *p = 0;
+            }
+        }
+    }
+    return count;
+}
+
+int main() {
+    char *flags;
+    int round;
+    int count;
+    flags = calloc(2000000, sizeof(int));
+    for (round = 0; round < 5; round = round + 1)
+        count = sieve(flags, 2000000);
+    return count % 256;
+}
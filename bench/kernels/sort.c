@@ -0,0 +1,44 @@
+// Kernel: Shell sort of pseudo-random ints (compares and swaps)
+
+int *at(char *base, int i) {
+    return base + i * sizeof(int);
+}
+
+int main() {
+    char *a;
+    int n;
+    int i;
+    int j;
+    int gap;
+    int v;
+    int seed;
+    int moving;
+    n = 300000;
+    a = calloc(n, sizeof(int));
+    seed = 3;
+    for (i = 0; i < n; i = i + 1) {
+        seed = (seed * 1103 + 12345) % 1000003;
+        *at(a, i) = seed;
+    }
+    for (gap = n / 2; gap > 0; gap = gap / 2) {
+        for (i = gap; i < n; i = i + 1) {
+            v = *at(a, i);
+            j = i;
+            moving = 1;
+            while (moving) {
+                moving = 0;
+                if (j >= gap)
+                    if (*at(a, j - gap) > v) {
+                        *at(a, j) = *at(a, j - gap);
+                        j = j - gap;
+                        moving = 1;
+                    }
+            }
+            *at(a, j) = v;
+        }
+    }
+    for (i = 1; i < n; i = i + 1)
+        if (*at(a, i - 1) > *at(a, i))
+            return 255;
+    return *at(a, n / 2) % 256;
+}
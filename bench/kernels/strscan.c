@@ -0,0 +1,91 @@
+// Kernel: string scanning (byte loads, compares, a string literal)
+//
+// Characters are read as *s % 256, the low byte of whatever the load
+// returns, so that the kernel works whether *s loads one byte or a word.
+// The text is ASCII and padded, and is written front to back.
+
+int length(char *s) {
+    int n;
+    n = 0;
+    while (*s % 256 != 0) {
+        s = s + 1;
+        n = n + 1;
+    }
+    return n;
+}
+
+int count_words(char *s) {
+    int words;
+    int in_word;
+    int c;
+    words = 0;
+    in_word = 0;
+    c = *s % 256;
+    while (c != 0) {
+        if (c == 32) {
+            in_word = 0;
+        } else if (in_word == 0) {
+            in_word = 1;
+            words = words + 1;
+        }
+        s = s + 1;
+        c = *s % 256;
+    }
+    return words;
+}
+
+// Occurrences of pattern in s, by naive search
+int count_matches(char *s, char *pattern) {
+    int matches;
+    int i;
+    int c;
+    int more;
+    matches = 0;
+    while (*s % 256 != 0) {
+        i = 0;
+        more = 1;
+        while (more) {
+            more = 0;
+            c = *(pattern + i) % 256;
+            if (c != 0)
+                if (c == *(s + i) % 256) {
+                    i = i + 1;
+                    more = 1;
+                }
+        }
+        if (*(pattern + i) % 256 == 0)
+            matches = matches + 1;
+        s = s + 1;
+    }
+    return matches;
+}
+
+int main() {
+    char *text;
+    char *p;
+    char *words;
+    int n;
+    int i;
+    int seed;
+    int total;
+    n = 1000000;
+    text = calloc(n + 16, 1);
+    words = "the quick brown fox jumps over the lazy dog ";
+    seed = 7;
+    p = text;
+    for (i = 0; i < n; i = i + 1) {
+        seed = (seed * 1103 + 12345) % 65536;
+        if (seed % 7 == 0)
+            *p = 32;
+        else
+            *p = *(words + seed % 44) % 256;
+        p = p + 1;
+    }
+    total = 0;
+    for (i = 0; i < 10; i = i + 1) {
+        total = total + length(text) % 1000;
+        total = total + count_words(text) % 1000;
+        total = total + count_matches(text, "the") % 1000;
+    }
+    return total % 256;
+}
@@ -0,0 +1,100 @@
+// Lexer micro-benchmark: tokens per second on a multi-megabyte input.
+//
+// Usage: bench/lexbench [file|-] [iterations] [scanner]
+// Without a file (or with "-"), a synthetic source of about 8 MB is
+// generated. Every scanner the CPU supports is measured unless one is named.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../src/compiler.h"
+#include <time.h>
+
+static char *read_file(char *path) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        perror(path);
+        exit(1);
+    }
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    char *buf = calloc(1, size + 1);
+    fread(buf, 1, size, fp);
+    fclose(fp);
+    return buf;
+}
+
+// Build a source that mixes identifiers, keywords, numbers, operators,
+// strings and comments in proportions typical of generated code
+static char *synthesize(long target) {
+    char *buf = malloc(target + 4096);
+    long len = 0;
+    for (int f = 0; len < target; f++) {
+        len += sprintf(buf + len,
+            "// helper %d\n"
+            "int helper_%d(int alpha, int beta) {\n"
+            "    int counter_%d;\n"
+            "    char *message;\n"
+            "    counter_%d = alpha * %d + beta / 3 - (alpha %% 7);\n"
+            "    message = \"value of helper %d\";\n"
+            "    /* loop until the counter settles */\n"
+            "    while (counter_%d >= 100) {\n"
+            "        counter_%d = counter_%d - sizeof(int);\n"
+            "    }\n"
+            "    if (counter_%d != beta) return counter_%d <= alpha;\n"
+            "    for (alpha = 0; alpha < 10; alpha = alpha + 1) beta = beta + alpha;\n"
+            "    return *&beta == counter_%d;\n"
+            "}\n\n",
+            f, f, f, f, f % 97, f, f, f, f, f, f, f);
+    }
+    buf[len] = '\0';
+    return buf;
+}
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Best of several runs of the lexer with the current scanner
+static double measure(int iterations) {
+    double best = 0;
+    for (int i = 0; i < iterations; i++) {
+        arena_reset(&token_arena);
+        tokens.capacity = 0;
+        double start = now();
+        tokenize(user_input);
+        double elapsed = now() - start;
+        if (i == 0 || elapsed < best)
+            best = elapsed;
+    }
+    return best;
+}
+
+int main(int argc, char **argv) {
+    int synthetic = argc < 2 || !strcmp(argv[1], "-");
+    user_input = synthetic ? synthesize(8 << 20) : read_file(argv[1]);
+    int iterations = argc > 2 ? atoi(argv[2]) : 5;
+    long bytes = strlen(user_input);
+
+    char *names[MAX_SCANNERS];
+    int num_names = supported_scanners(names);
+    if (argc > 3) {
+        names[0] = argv[3];
+        num_names = 1;
+    }
+
+    printf("input:     %.1f MB, %d tokens, best of %d runs\n",
+           bytes / 1e6, (tokenize(user_input), tokens.count), iterations);
+    for (int i = 0; i < num_names; i++) {
+        if (!select_scanner(names[i])) {
+            fprintf(stderr, "scanner %s is not supported\n", names[i]);
+            return 1;
+        }
+        double best = measure(iterations);
+        printf("%-8s   %.3f s, %.1f M tokens/s, %.1f MB/s\n", names[i], best,
+               tokens.count / best / 1e6, bytes / best / 1e6);
+    }
+    return 0;
+}
@@ -0,0 +1,49 @@
+// Parser benchmark: parse time of functions with thousands of locals.
+//
+// Usage: bench/parsebench [max-locals]
+// Each input is one function that declares N locals and then assigns each
+// from the previous one. Parse time per local should stay flat as N grows.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "../src/compiler.h"
+#include <time.h>
+
+static char *synthesize(int num_locals) {
+    char *buf = malloc(num_locals * 64 + 64);
+    int len = sprintf(buf, "int main() {\n");
+    for (int i = 0; i < num_locals; i++)
+        len += sprintf(buf + len, "    int local_%d;\n", i);
+    len += sprintf(buf + len, "    local_0 = 1;\n");
+    for (int i = 1; i < num_locals; i++)
+        len += sprintf(buf + len, "    local_%d = local_%d + 1;\n", i, i - 1);
+    sprintf(buf + len, "    return local_%d;\n}\n", num_locals - 1);
+    return buf;
+}
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv) {
+    int max_locals = argc > 1 ? atoi(argv[1]) : 16000;
+
+    printf("%8s %10s %14s\n", "locals", "parse ms", "ns per local");
+    for (int n = 1000; n <= max_locals; n *= 2) {
+        user_input = synthesize(n);
+        tokenize(user_input);
+
+        double start = now();
+        program();
+        double elapsed = now() - start;
+
+        printf("%8d %10.2f %14.1f\n", n, elapsed * 1e3, elapsed * 1e9 / n);
+        arena_reset(&token_arena);
+        arena_reset(&node_arena);
+        tokens.capacity = 0;
+        free(user_input);
+    }
+    return 0;
+}
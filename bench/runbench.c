@@ -0,0 +1,220 @@
+// Runtime benchmark of generated code against gcc.
+//
+// Usage: bench/runbench [--runs N] [kernel.c ...]
+// Compiles each kernel (by default bench/kernels/*.c) to an object file
+// with ./acompiler, ./acompiler --ir and gcc -O0, -O1 and -O2, links it
+// statically and runs it N times (default 5). It reports the fastest run's
+// user plus system time, the instructions it retired (when the kernel
+// allows hardware counters) and the size of the object's code, then how
+// many times faster than acompiler's code each binary ran. The geometric
+// mean of those ratios over all kernels sums up a run.
+//
+// Every binary must exit with the same status as the gcc -O0 one, which
+// also checks the generated code. gcc compiles the kernels with stdlib.h
+// included, since the subset has no declarations.
+
+#define _GNU_SOURCE  // wait4
+
+#include <elf.h>
+#include <glob.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <linux/perf_event.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+typedef struct Config {
+    char *name;
+    char *compile;   // Command compiling %s (the kernel) to %s (the object)
+} Config;
+
+static Config configs[] = {
+    {"acompiler", "./acompiler -c -o %2$s %1$s"},
+    {"acompiler --ir", "./acompiler --ir -c -o %2$s %1$s"},
+    {"gcc -O0", "gcc -w -include stdlib.h -O0 -c -o %2$s %1$s"},
+    {"gcc -O1", "gcc -w -include stdlib.h -O1 -c -o %2$s %1$s"},
+    {"gcc -O2", "gcc -w -include stdlib.h -O2 -c -o %2$s %1$s"},
+};
+
+#define NUM_CONFIGS (sizeof(configs) / sizeof(*configs))
+#define REFERENCE 2  // gcc -O0 decides the expected exit status
+
+typedef struct Result {
+    double ms;
+    long insns;      // -1 without hardware counters
+    long code_size;
+    int status;
+} Result;
+
+static int system_quiet(char *cmd) {
+    char buf[4096];
+    snprintf(buf, sizeof(buf), "%s >/dev/null 2>&1", cmd);
+    return system(buf);
+}
+
+// Size of the executable sections of an ELF object
+static long code_size(char *path) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp)
+        return 0;
+    Elf64_Ehdr eh;
+    long size = 0;
+    if (fread(&eh, sizeof(eh), 1, fp) == 1 && !memcmp(eh.e_ident, ELFMAG, SELFMAG)) {
+        for (int i = 0; i < eh.e_shnum; i++) {
+            Elf64_Shdr sh;
+            fseek(fp, eh.e_shoff + i * eh.e_shentsize, SEEK_SET);
+            if (fread(&sh, sizeof(sh), 1, fp) == 1 && (sh.sh_flags & SHF_EXECINSTR))
+                size += sh.sh_size;
+        }
+    }
+    fclose(fp);
+    return size;
+}
+
+static int open_counter(pid_t pid) {
+    struct perf_event_attr attr = {0};
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    attr.disabled = 1;
+    attr.enable_on_exec = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return syscall(SYS_perf_event_open, &attr, pid, -1, -1, 0);
+}
+
+// Run path once, counting its instructions from exec to exit
+static Result run(char *path) {
+    int go[2];
+    if (pipe(go)) {
+        perror("pipe");
+        exit(1);
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        // Wait until the counter is attached
+        char c;
+        close(go[1]);
+        if (read(go[0], &c, 1) < 0)
+            _exit(127);
+        execl(path, path, (char *)NULL);
+        _exit(127);
+    }
+    close(go[0]);
+    int counter = open_counter(pid);
+    close(go[1]);
+
+    int status;
+    struct rusage usage;
+    wait4(pid, &status, 0, &usage);
+    Result r = {0};
+    r.ms = usage.ru_utime.tv_sec * 1e3 + usage.ru_utime.tv_usec / 1e3 +
+           usage.ru_stime.tv_sec * 1e3 + usage.ru_stime.tv_usec / 1e3;
+    r.status = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+    r.insns = -1;
+    if (counter >= 0) {
+        long long count;
+        if (read(counter, &count, sizeof(count)) == sizeof(count))
+            r.insns = count;
+        close(counter);
+    }
+    return r;
+}
+
+// Build kernel with config and keep its fastest of runs
+static int measure(char *kernel, Config *config, int runs, Result *r) {
+    char object[] = "/tmp/acompiler-run-XXXXXX";
+    int fd = mkstemp(object);
+    if (fd < 0) {
+        perror("mkstemp");
+        exit(1);
+    }
+    close(fd);
+    char binary[sizeof(object) + 4];
+    snprintf(binary, sizeof(binary), "%s.bin", object);
+
+    char cmd[4096];
+    snprintf(cmd, sizeof(cmd), config->compile, kernel, object);
+    int ok = !system_quiet(cmd);
+    if (ok) {
+        r->code_size = code_size(object);
+        snprintf(cmd, sizeof(cmd), "gcc -static -o %s %s", binary, object);
+        ok = !system_quiet(cmd);
+    }
+    for (int i = 0; ok && i < runs; i++) {
+        Result run_result = run(binary);
+        if (i == 0 || run_result.ms < r->ms) {
+            r->ms = run_result.ms;
+            r->insns = run_result.insns;
+            r->status = run_result.status;
+        }
+    }
+    unlink(object);
+    unlink(binary);
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    int runs = 5;
+    int first = 1;
+    if (argc > 2 && !strcmp(argv[1], "--runs")) {
+        runs = atoi(argv[2]);
+        first = 3;
+    }
+    glob_t kernels = {0};
+    if (first == argc)
+        glob("bench/kernels/*.c", 0, NULL, &kernels);
+    char **paths = first == argc ? kernels.gl_pathv : argv + first;
+    int num_kernels = first == argc ? kernels.gl_pathc : argc - first;
+    if (!num_kernels || runs < 1) {
+        fprintf(stderr, "Usage: %s [--runs N] [kernel.c ...]\n", argv[0]);
+        return 1;
+    }
+
+    printf("%-10s %-15s %10s %14s %10s %8s\n", "kernel", "compiler", "ms", "instructions",
+           "code", "ratio");
+    double log_ratio[NUM_CONFIGS] = {0};
+    int failed = 0;
+    for (int k = 0; k < num_kernels; k++) {
+        char *kernel = paths[k];
+        char *name = strrchr(kernel, '/') ? strrchr(kernel, '/') + 1 : kernel;
+        Result results[NUM_CONFIGS] = {0};
+        int built[NUM_CONFIGS];
+        for (int c = 0; c < NUM_CONFIGS; c++)
+            built[c] = measure(kernel, &configs[c], runs, &results[c]);
+
+        for (int c = 0; c < NUM_CONFIGS; c++) {
+            Result *r = &results[c];
+            printf("%-10.*s %-15s ", (int)(strcspn(name, ".")), name, configs[c].name);
+            if (!built[c]) {
+                printf("%10s\n", "build failed");
+                failed = 1;
+                continue;
+            }
+            double ratio = results[0].ms / (r->ms > 0 ? r->ms : 1e-3);
+            log_ratio[c] += log(ratio);
+            printf("%10.1f ", r->ms);
+            if (r->insns >= 0)
+                printf("%14ld ", r->insns);
+            else
+                printf("%14s ", "n/a");
+            printf("%10ld %7.2fx", r->code_size, ratio);
+            if (built[REFERENCE] && r->status != results[REFERENCE].status) {
+                printf("  exit %d, expected %d", r->status, results[REFERENCE].status);
+                failed = 1;
+            }
+            printf("\n");
+        }
+        fflush(stdout);
+    }
+
+    printf("\nacompiler's time relative to each compiler (geometric mean):\n");
+    for (int c = 1; c < NUM_CONFIGS; c++)
+        printf("  %-15s %6.2fx\n", configs[c].name, exp(log_ratio[c] / num_kernels));
+    globfree(&kernels);
+    return failed;
+}
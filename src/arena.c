@@ -0,0 +1,135 @@
+#include "compiler.h"
+
+// Bump-pointer arena allocator.
+//
+// Objects with the same lifetime are carved out of large chunks and never
+// freed individually. An arena can be rewound with arena_reset() to reuse
+// its chunks, and all arenas are released together at exit.
+
+#define CHUNK_SIZE (64 * 1024)
+#define ALIGN 8
+
+struct ArenaChunk {
+    struct ArenaChunk *next;
+    size_t size;
+    size_t used;
+    char data[];
+};
+
+_Thread_local Arena token_arena = {"tokens"};
+_Thread_local Arena node_arena = {"ast"};
+_Thread_local Arena ir_arena = {"ir"};
+_Thread_local Arena gen_arena = {"codegen"};
+_Thread_local Arena name_arena = {"names"};
+
+static ArenaChunk *new_chunk(Arena *arena, size_t min_size) {
+    size_t size = min_size > CHUNK_SIZE ? min_size : CHUNK_SIZE;
+    ArenaChunk *chunk = malloc(sizeof(ArenaChunk) + size);
+    if (!chunk)
+        error("Out of memory");
+    chunk->next = NULL;
+    chunk->size = size;
+    chunk->used = 0;
+    arena->capacity += size;
+    arena->num_chunks++;
+    return chunk;
+}
+
+// Allocate zeroed memory from an arena
+void *arena_alloc(Arena *arena, size_t size) {
+    size = (size + ALIGN - 1) & ~(size_t)(ALIGN - 1);
+
+    ArenaChunk *chunk = arena->cur;
+    while (chunk && chunk->used + size > chunk->size) {
+        // Chunks after cur are free after a reset
+        if (chunk->next && size <= chunk->next->size) {
+            chunk = chunk->next;
+            chunk->used = 0;
+            continue;
+        }
+        ArenaChunk *fresh = new_chunk(arena, size);
+        fresh->next = chunk->next;
+        chunk->next = fresh;
+        chunk = fresh;
+    }
+    if (!chunk) {
+        chunk = new_chunk(arena, size);
+        arena->chunks = chunk;
+    }
+    arena->cur = chunk;
+
+    void *ptr = chunk->data + chunk->used;
+    chunk->used += size;
+    arena->used += size;
+    arena->num_allocs++;
+    if (arena->used > arena->peak)
+        arena->peak = arena->used;
+    memset(ptr, 0, size);
+    return ptr;
+}
+
+// Copy len bytes into a NUL-terminated arena string
+char *arena_strndup(Arena *arena, char *s, int len) {
+    char *p = arena_alloc(arena, len + 1);
+    memcpy(p, s, len);
+    return p;
+}
+
+// Rewind an arena, keeping its chunks for reuse
+void arena_reset(Arena *arena) {
+    if (arena->chunks)
+        arena->chunks->used = 0;
+    arena->cur = arena->chunks;
+    arena->used = 0;
+}
+
+// Free the chunks of an arena and clear its statistics
+static void release(Arena *arena) {
+    ArenaChunk *chunk = arena->chunks;
+    while (chunk) {
+        ArenaChunk *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    *arena = (Arena){arena->name};
+}
+
+// Free every chunk of every arena of this thread
+void arena_release_all() {
+    Arena *arenas[] = THREAD_ARENAS;
+    for (int i = 0; i < NUM_ARENAS; i++)
+        release(arenas[i]);
+}
+
+// Rewind every arena of this thread except the interned names, keeping
+// the chunks for the next compilation (--server)
+void arena_reset_all() {
+    Arena *arenas[] = THREAD_ARENAS;
+    for (int i = 0; i < NUM_ARENAS; i++)
+        if (arenas[i] != &name_arena)
+            arena_reset(arenas[i]);
+}
+
+// Free the chunks of another thread's arena and add its statistics to
+// those of arena
+void arena_merge(Arena *arena, Arena *from) {
+    arena->capacity += from->capacity;
+    arena->num_chunks += from->num_chunks;
+    arena->num_allocs += from->num_allocs;
+    if (from->peak > arena->peak)
+        arena->peak = from->peak;
+    release(from);
+}
+
+// Print per-arena statistics of this thread (--arena-stats)
+void arena_report() {
+    Arena *arenas[] = THREAD_ARENAS;
+    fprintf(stderr, "%-8s %12s %12s %12s %8s %10s\n",
+            "arena", "used", "peak", "reserved", "chunks", "allocs");
+    for (int i = 0; i < NUM_ARENAS; i++) {
+        Arena *arena = arenas[i];
+        fprintf(stderr, "%-8s %12zu %12zu %12zu %8d %10ld\n",
+                arena->name, arena->used, arena->peak, arena->capacity,
+                arena->num_chunks, arena->num_allocs);
+    }
+}
@@ -0,0 +1,421 @@
+#define _DEFAULT_SOURCE  // flock
+
+#include "compiler.h"
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Content-addressed compilation cache (--cache DIR).
+//
+// The key of a compilation is a 128-bit hash of the compiler binary's
+// identity (its size and modification time), the options that change the
+// output, and the source bytes. The output (.s or .o) is stored as
+// DIR/xx/<rest of key>; on a hit it is copied to the destination and the
+// front end never runs.
+//
+// An entry's modification time is its last use, which is what eviction
+// goes by: when the cache grows past its limit, the least recently used
+// entries are deleted until it is back under 90% of it. Hit and miss
+// counts, the total size and the number of entries are kept in DIR/stats
+// and updated under flock(), since several compilers may share a cache.
+//
+// Incremental compilation (incremental.c) keeps one more entry per input
+// file, holding the code of each of its functions.
+
+#define KEY_LEN 32
+#define DEFAULT_LIMIT (256L << 20)
+
+static char *cache_dir;
+static long cache_limit = DEFAULT_LIMIT;
+
+// Counts of this process, added to DIR/stats by cache_close()
+static atomic_long num_hits;
+static atomic_long num_misses;
+static atomic_long bytes_added;
+static atomic_long entries_added;
+static atomic_long functions_reused;
+static atomic_long functions_compiled;
+
+typedef struct CacheStats {
+    long hits;
+    long misses;
+    long size;
+    long entries;
+    long functions_reused;
+    long functions_compiled;
+} CacheStats;
+
+// MurmurHash3 x64 128-bit, with a running state so that the key can be
+// built from several pieces
+
+typedef struct Hasher {
+    uint64_t h1, h2;
+    unsigned char tail[16];
+    int tail_len;
+    long len;
+} Hasher;
+
+static uint64_t rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static uint64_t fmix(uint64_t k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+static const uint64_t C1 = 0x87c37b91114253d5ULL;
+static const uint64_t C2 = 0x4cf5ad432745937fULL;
+
+static void hash_block(Hasher *h, unsigned char *p) {
+    uint64_t k1, k2;
+    memcpy(&k1, p, 8);
+    memcpy(&k2, p + 8, 8);
+    k1 *= C1; k1 = rotl(k1, 31); k1 *= C2; h->h1 ^= k1;
+    h->h1 = rotl(h->h1, 27); h->h1 += h->h2; h->h1 = h->h1 * 5 + 0x52dce729;
+    k2 *= C2; k2 = rotl(k2, 33); k2 *= C1; h->h2 ^= k2;
+    h->h2 = rotl(h->h2, 31); h->h2 += h->h1; h->h2 = h->h2 * 5 + 0x38495ab5;
+}
+
+static void hash_update(Hasher *h, void *data, long len) {
+    unsigned char *p = data;
+    h->len += len;
+    while (len > 0 && h->tail_len) {
+        h->tail[h->tail_len++] = *p++;
+        len--;
+        if (h->tail_len == 16) {
+            hash_block(h, h->tail);
+            h->tail_len = 0;
+        }
+    }
+    for (; len >= 16; p += 16, len -= 16)
+        hash_block(h, p);
+    memcpy(h->tail, p, len);
+    h->tail_len += len;
+}
+
+static void hash_final(Hasher *h, char *key) {
+    uint64_t k1 = 0, k2 = 0;
+    for (int i = h->tail_len - 1; i >= 8; i--)
+        k2 = (k2 << 8) | h->tail[i];
+    for (int i = (h->tail_len < 8 ? h->tail_len : 8) - 1; i >= 0; i--)
+        k1 = (k1 << 8) | h->tail[i];
+    if (h->tail_len > 8) {
+        k2 *= C2; k2 = rotl(k2, 33); k2 *= C1; h->h2 ^= k2;
+    }
+    if (h->tail_len) {
+        k1 *= C1; k1 = rotl(k1, 31); k1 *= C2; h->h1 ^= k1;
+    }
+    h->h1 ^= h->len;
+    h->h2 ^= h->len;
+    h->h1 += h->h2;
+    h->h2 += h->h1;
+    h->h1 = fmix(h->h1);
+    h->h2 = fmix(h->h2);
+    h->h1 += h->h2;
+    h->h2 += h->h1;
+    sprintf(key, "%016llx%016llx", (unsigned long long)h->h1, (unsigned long long)h->h2);
+}
+
+// Paths
+
+static char *path_of(char *key, char *suffix) {
+    char *path = malloc(strlen(cache_dir) + KEY_LEN + strlen(suffix) + 4);
+    if (!path)
+        error("Out of memory");
+    sprintf(path, "%s/%.2s/%s%s", cache_dir, key, key + 2, suffix);
+    return path;
+}
+
+static void make_dir(char *path) {
+    if (mkdir(path, 0755) && errno != EEXIST)
+        error("Cannot create %s: %s", path, strerror(errno));
+}
+
+// Use dir as the cache, holding at most limit bytes (0 for the default).
+// A NULL dir turns the cache off.
+void cache_open(char *dir, long limit) {
+    cache_dir = dir;
+    cache_limit = limit ? limit : DEFAULT_LIMIT;
+    if (dir)
+        make_dir(dir);
+}
+
+int cache_enabled() {
+    return cache_dir != NULL;
+}
+
+// The running compiler binary, whose size and modification time stand in
+// for a version: a rebuilt compiler does not reuse old entries
+static struct stat exe;
+static pthread_once_t exe_once = PTHREAD_ONCE_INIT;
+
+static void stat_exe() {
+    if (stat("/proc/self/exe", &exe))
+        memset(&exe, 0, sizeof(exe));
+}
+
+// Key of a compilation of source with the given options, as KEY_LEN hex
+// digits plus a NUL in key (CACHE_KEY_SIZE bytes)
+void cache_key(char *options, char *source, long len, char *key) {
+    pthread_once(&exe_once, stat_exe);
+
+    Hasher h = {0x9368e53c2f6af274ULL, 0x586dcd208f7cd3fdULL};
+    long identity[3] = {exe.st_size, exe.st_mtim.tv_sec, exe.st_mtim.tv_nsec};
+    hash_update(&h, identity, sizeof(identity));
+    hash_update(&h, options, strlen(options) + 1);
+    hash_update(&h, source, len);
+    hash_final(&h, key);
+}
+
+static int copy_file(int from, int to) {
+    char buf[65536];
+    for (;;) {
+        ssize_t n = read(from, buf, sizeof(buf));
+        if (n < 0)
+            return -1;
+        if (n == 0)
+            return 0;
+        for (char *p = buf; n > 0;) {
+            ssize_t m = write(to, p, n);
+            if (m < 0)
+                return -1;
+            p += m;
+            n -= m;
+        }
+    }
+}
+
+// Copy the entry for key to output (standard output if NULL), marking it
+// as just used. Returns 0 if there is no such entry.
+int cache_fetch(char *key, char *output) {
+    char *path = path_of(key, "");
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        free(path);
+        return 0;
+    }
+    int out = 1;
+    if (output) {
+        out = open(output, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (out < 0)
+            error("Cannot open %s: %s", output, strerror(errno));
+    }
+    if (copy_file(fd, out))
+        error("Cannot copy %s: %s", path, strerror(errno));
+    close(fd);
+    if (out != 1)
+        close(out);
+    utimensat(AT_FDCWD, path, NULL, 0);
+    free(path);
+    return 1;
+}
+
+// Read the entry for key into a new buffer, marking it as just used.
+// Returns NULL if there is no such entry.
+char *cache_read(char *key, long *len) {
+    char *path = path_of(key, "");
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st)) {
+        if (fd >= 0)
+            close(fd);
+        free(path);
+        return NULL;
+    }
+    char *buf = malloc(st.st_size + 1);
+    if (!buf)
+        error("Out of memory");
+    long done = 0;
+    while (done < st.st_size) {
+        ssize_t n = read(fd, buf + done, st.st_size - done);
+        if (n <= 0)
+            break;
+        done += n;
+    }
+    close(fd);
+    utimensat(AT_FDCWD, path, NULL, 0);
+    free(path);
+    *len = done;
+    return buf;
+}
+
+// Count a lookup as a hit or a miss
+void cache_count(int hit) {
+    atomic_fetch_add(hit ? &num_hits : &num_misses, 1);
+}
+
+// Count the functions of an incremental compilation
+void cache_count_functions(long reused, long compiled) {
+    atomic_fetch_add(&functions_reused, reused);
+    atomic_fetch_add(&functions_compiled, compiled);
+}
+
+// Path to write a new entry for key to, before cache_store()
+char *cache_temp_path(char *key) {
+    char dir[4096];
+    snprintf(dir, sizeof(dir), "%s/%.2s", cache_dir, key);
+    make_dir(dir);
+    char suffix[64];
+    snprintf(suffix, sizeof(suffix), ".tmp%ld.%lx", (long)getpid(), (unsigned long)pthread_self());
+    return path_of(key, suffix);
+}
+
+// Move a complete output written to temp into the cache as key's entry,
+// replacing any entry there
+void cache_store(char *key, char *temp) {
+    char *path = path_of(key, "");
+    struct stat st, old;
+    int replaced = stat(path, &old) == 0;
+    if (stat(temp, &st) == 0 && rename(temp, path) == 0) {
+        atomic_fetch_add(&bytes_added, st.st_size - (replaced ? old.st_size : 0));
+        atomic_fetch_add(&entries_added, !replaced);
+    } else {
+        unlink(temp);
+    }
+    free(path);
+}
+
+// Statistics file
+
+static int open_stats(CacheStats *stats) {
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/stats", cache_dir);
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+        error("Cannot open %s: %s", path, strerror(errno));
+    flock(fd, LOCK_EX);
+
+    char buf[256] = {0};
+    *stats = (CacheStats){0};
+    if (read(fd, buf, sizeof(buf) - 1) > 0)
+        sscanf(buf, "hits %ld misses %ld size %ld entries %ld functions reused %ld compiled %ld",
+               &stats->hits, &stats->misses, &stats->size, &stats->entries,
+               &stats->functions_reused, &stats->functions_compiled);
+    return fd;
+}
+
+static void close_stats(int fd, CacheStats *stats) {
+    char buf[256];
+    int len = snprintf(buf, sizeof(buf), "hits %ld misses %ld size %ld entries %ld functions reused %ld compiled %ld\n",
+                       stats->hits, stats->misses, stats->size, stats->entries,
+                       stats->functions_reused, stats->functions_compiled);
+    ftruncate(fd, 0);
+    pwrite(fd, buf, len, 0);
+    close(fd);  // Releases the lock
+}
+
+typedef struct Entry {
+    char *path;
+    long size;
+    struct timespec used;
+} Entry;
+
+static int by_use(const void *a, const void *b) {
+    const struct timespec *x = &((Entry *)a)->used;
+    const struct timespec *y = &((Entry *)b)->used;
+    if (x->tv_sec != y->tv_sec)
+        return x->tv_sec < y->tv_sec ? -1 : 1;
+    return (x->tv_nsec > y->tv_nsec) - (x->tv_nsec < y->tv_nsec);
+}
+
+// Delete the least recently used entries until the cache is below 90% of
+// its limit, and recount its size and entries
+static void evict(CacheStats *stats) {
+    Entry *entries = NULL;
+    int num_entries = 0, capacity = 0;
+    long size = 0;
+
+    DIR *top = opendir(cache_dir);
+    if (!top)
+        return;
+    for (struct dirent *d; (d = readdir(top));) {
+        if (strlen(d->d_name) != 2)
+            continue;
+        char dir[4096];
+        snprintf(dir, sizeof(dir), "%s/%s", cache_dir, d->d_name);
+        DIR *sub = opendir(dir);
+        if (!sub)
+            continue;
+        for (struct dirent *e; (e = readdir(sub));) {
+            // Skip ".", ".." and temporary files of running compilations
+            if (strlen(e->d_name) != KEY_LEN - 2)
+                continue;
+            char path[sizeof(dir) + sizeof(e->d_name)];
+            snprintf(path, sizeof(path), "%s/%s", dir, e->d_name);
+            struct stat st;
+            if (stat(path, &st))
+                continue;
+            if (num_entries == capacity) {
+                capacity = capacity ? capacity * 2 : 256;
+                entries = realloc(entries, capacity * sizeof(Entry));
+                if (!entries)
+                    error("Out of memory");
+            }
+            entries[num_entries++] = (Entry){strdup(path), st.st_size, st.st_mtim};
+            size += st.st_size;
+        }
+        closedir(sub);
+    }
+    closedir(top);
+
+    qsort(entries, num_entries, sizeof(Entry), by_use);
+    int kept = num_entries;
+    for (int i = 0; i < num_entries && size > cache_limit / 10 * 9; i++) {
+        if (unlink(entries[i].path) == 0) {
+            size -= entries[i].size;
+            kept--;
+        }
+    }
+    for (int i = 0; i < num_entries; i++)
+        free(entries[i].path);
+    free(entries);
+
+    stats->size = size;
+    stats->entries = kept;
+}
+
+// Add this process's counts to the statistics and evict entries if the
+// cache is over its limit
+void cache_close() {
+    if (!cache_dir)
+        return;
+    CacheStats stats;
+    int fd = open_stats(&stats);
+    stats.hits += atomic_exchange(&num_hits, 0);
+    stats.misses += atomic_exchange(&num_misses, 0);
+    stats.size += atomic_exchange(&bytes_added, 0);
+    stats.entries += atomic_exchange(&entries_added, 0);
+    stats.functions_reused += atomic_exchange(&functions_reused, 0);
+    stats.functions_compiled += atomic_exchange(&functions_compiled, 0);
+    if (stats.size > cache_limit)
+        evict(&stats);
+    close_stats(fd, &stats);
+}
+
+// Print the cache statistics (--cache-stats)
+void cache_report() {
+    CacheStats stats;
+    int fd = open_stats(&stats);
+    close_stats(fd, &stats);
+    long lookups = stats.hits + stats.misses;
+    fprintf(stderr, "cache: %s\n", cache_dir);
+    fprintf(stderr, "  hits     %10ld  (%.1f%%)\n", stats.hits,
+            lookups ? 100.0 * stats.hits / lookups : 0.0);
+    fprintf(stderr, "  misses   %10ld\n", stats.misses);
+    fprintf(stderr, "  entries  %10ld\n", stats.entries);
+    fprintf(stderr, "  size     %10ld of %ld bytes\n", stats.size, cache_limit);
+    if (stats.functions_reused + stats.functions_compiled)
+        fprintf(stderr, "  functions %9ld reused, %ld compiled\n",
+                stats.functions_reused, stats.functions_compiled);
+}
@@ -1,23 +1,72 @@
 #include "compiler.h"
 
-static int label_seq = 0;
-static char *current_func = NULL;
+// State of the function being generated, one per code generation thread
+static _Thread_local int return_label;   // Target of return statements
+
+// Register assignment of the current function; all fields are zero in
+// stack mode, which makes gen_push()/gen_pop() plain push/pop
+static _Thread_local RegInfo ra;
+static _Thread_local int tmp_depth = 0;
+
+// Number of 8-byte values pushed below the frame at this point of the
+// function; the frame itself is a multiple of 16 bytes, so rsp is 16-byte
+// aligned whenever this is even
+static _Thread_local int stack_depth = 0;
+
+static Reg arg_regs[] = {RDI, RSI, RDX, RCX, R8, R9};
+
+// Register holding a local variable, or REG_NONE if it lives in memory
+static Reg lvar_reg(Node *node) {
+    if (!opt_regalloc)
+        return REG_NONE;
+    return ra.lvar_reg[node->offset / 8];
+}
 
 // Generate code to push to stack
 void gen_push() {
-    printf("  push rax\n");
+    int level = tmp_depth++;
+    if (level < ra.num_tmp_regs) {
+        emit2(I_MOV, op_reg(ra.tmp_regs[level]), op_reg(RAX));
+        return;
+    }
+    emit1(I_PUSH, op_reg(RAX));
+    stack_depth++;
 }
 
 // Generate code to pop from stack
-void gen_pop(char *reg) {
-    printf("  pop %s\n", reg);
+void gen_pop(Reg reg) {
+    int level = --tmp_depth;
+    if (level < ra.num_tmp_regs) {
+        emit2(I_MOV, op_reg(reg), op_reg(ra.tmp_regs[level]));
+        return;
+    }
+    emit1(I_POP, op_reg(reg));
+    stack_depth--;
+}
+
+// Save caller-saved temporaries that are live across a call
+static void gen_save_tmps() {
+    for (int i = 0; i < tmp_depth && i < ra.num_tmp_regs; i++)
+        if (regalloc_is_caller_saved(ra.tmp_regs[i])) {
+            emit1(I_PUSH, op_reg(ra.tmp_regs[i]));
+            stack_depth++;
+        }
+}
+
+static void gen_restore_tmps() {
+    int n = tmp_depth < ra.num_tmp_regs ? tmp_depth : ra.num_tmp_regs;
+    for (int i = n - 1; i >= 0; i--)
+        if (regalloc_is_caller_saved(ra.tmp_regs[i])) {
+            emit1(I_POP, op_reg(ra.tmp_regs[i]));
+            stack_depth--;
+        }
 }
 
 // Generate address of a variable
 void gen_lval(Node *node) {
     if (node->kind == ND_LVAR) {
-        printf("  mov rax, rbp\n");
-        printf("  sub rax, %d\n", node->offset);
+        emit2(I_MOV, op_reg(RAX), op_reg(RBP));
+        emit2(I_SUB, op_reg(RAX), op_imm(node->offset));
         gen_push();
         return;
     }
@@ -31,93 +80,220 @@ void gen_lval(Node *node) {
     error("Not an lvalue");
 }
 
+// Condition code of a comparison; swapped when the operands are reversed
+static Opcode setcc(NodeKind kind, int swapped) {
+    switch (kind) {
+    case ND_EQ: return I_SETE;
+    case ND_NE: return I_SETNE;
+    case ND_LT: return swapped ? I_SETG : I_SETL;
+    default: return swapped ? I_SETGE : I_SETLE;
+    }
+}
+
+// Jumps on the condition of each setcc, and on its opposite
+static Opcode true_jumps[] = {I_JE, I_JNE, I_JL, I_JLE, I_JG, I_JGE};
+static Opcode false_jumps[] = {I_JNE, I_JE, I_JGE, I_JG, I_JLE, I_JL};
+
+// Materialize the flags of a comparison as 0 or 1 in rax
+static void gen_setcc(Opcode op) {
+    emit1(op, op_reg(RAX));
+    emit2(I_MOVZB, op_reg(RAX), op_reg(RAX));
+}
+
+// Evaluate the operands of a binary operator, lhs into rdi and rhs into rax
+static void gen_operands(Node *node) {
+    gen(node->lhs);
+    if (opt_regalloc && regalloc_is_leaf(node->rhs)) {
+        emit2(I_MOV, op_reg(RDI), op_reg(RAX));
+        gen(node->rhs);
+    } else {
+        gen_push();
+        gen(node->rhs);
+        gen_pop(RDI);
+    }
+}
+
+// Register of node if it is a local kept in one, or REG_NONE
+static Reg reg_of(Node *node) {
+    return node->kind == ND_LVAR ? lvar_reg(node) : REG_NONE;
+}
+
+// Set the flags by comparing the operands of a comparison; returns the
+// setcc of its condition. Constants become immediates, and locals in
+// registers are compared where they are.
+static Opcode gen_compare(Node *node) {
+    Node *lhs = node->lhs;
+    Node *rhs = node->rhs;
+    int swapped = 0;
+    if (lhs->kind == ND_NUM && rhs->kind != ND_NUM) {
+        lhs = node->rhs;
+        rhs = node->lhs;
+        swapped = 1;
+    }
+
+    Reg reg = reg_of(lhs);
+    if (rhs->kind == ND_NUM || reg_of(rhs) != REG_NONE) {
+        if (reg == REG_NONE) {
+            gen(lhs);
+            reg = RAX;
+        }
+        if (rhs->kind == ND_NUM)
+            emit2(I_CMP, op_reg(reg), op_imm(rhs->val));
+        else
+            emit2(I_CMP, op_reg(reg), op_reg(reg_of(rhs)));
+        return setcc(node->kind, swapped);
+    }
+    gen_operands(node);
+    emit2(I_CMP, op_reg(RDI), op_reg(RAX));
+    return setcc(node->kind, 0);
+}
+
+// Jump to label if the condition node is false, or if it is true when
+// when_true is set. Comparisons jump on the flags of their cmp instead of
+// computing 0 or 1 and testing that.
+static void gen_branch(Node *node, int when_true, int label) {
+    if (is_compare(node->kind)) {
+        int cond = gen_compare(node) - I_SETE;
+        emit1(when_true ? true_jumps[cond] : false_jumps[cond], op_label(label));
+        return;
+    }
+    gen(node);
+    emit2(I_TEST, op_reg(RAX), op_reg(RAX));
+    emit1(when_true ? I_JNE : I_JE, op_label(label));
+}
+
+// Generate "lhs op imm"; returns 0 if op has no immediate form
+static int gen_binary_imm(Node *node) {
+    int imm = node->rhs->val;
+    switch (node->kind) {
+    case ND_ADD:
+        gen(node->lhs);
+        emit2(I_ADD, op_reg(RAX), op_imm(imm));
+        return 1;
+    case ND_SUB:
+        gen(node->lhs);
+        emit2(I_SUB, op_reg(RAX), op_imm(imm));
+        return 1;
+    case ND_MUL:
+        gen(node->lhs);
+        emit2(I_IMUL, op_reg(RAX), op_imm(imm));
+        return 1;
+    default:
+        return 0;
+    }
+}
+
 // Generate code for an expression
 void gen(Node *node) {
     switch (node->kind) {
     case ND_NUM:
-        printf("  mov rax, %d\n", node->val);
+        emit2(I_MOV, op_reg(RAX), op_imm(node->val));
         return;
     
     case ND_STRING:
-        printf("  lea rax, [rip + .LC%d]\n", node->str_label);
+        emit2(I_LEA, op_reg(RAX), op_str(node->str_label));
         return;
     
     case ND_LVAR:
+        if (opt_regalloc) {
+            Reg reg = lvar_reg(node);
+            if (reg != REG_NONE)
+                emit2(I_MOV, op_reg(RAX), op_reg(reg));
+            else
+                emit2(I_MOV, op_reg(RAX), op_mem(RBP, -node->offset));
+            return;
+        }
         gen_lval(node);
-        gen_pop("rax");
-        printf("  mov rax, [rax]\n");
+        gen_pop(RAX);
+        emit2(I_MOV, op_reg(RAX), op_mem(RAX, 0));
         return;
     
     case ND_ASSIGN:
+        if (opt_regalloc && node->lhs->kind == ND_LVAR) {
+            gen(node->rhs);
+            Reg reg = lvar_reg(node->lhs);
+            if (reg != REG_NONE)
+                emit2(I_MOV, op_reg(reg), op_reg(RAX));
+            else
+                emit2(I_MOV, op_mem(RBP, -node->lhs->offset), op_reg(RAX));
+            return;
+        }
         gen_lval(node->lhs);
         gen(node->rhs);
-        gen_pop("rdi");
-        printf("  mov [rdi], rax\n");
+        gen_pop(RDI);
+        emit2(I_MOV, op_mem(RDI, 0), op_reg(RAX));
         return;
     
     case ND_ADDR:
         gen_lval(node->lhs);
-        gen_pop("rax");
+        gen_pop(RAX);
         return;
     
     case ND_DEREF:
         gen(node->lhs);
-        printf("  mov rax, [rax]\n");
+        emit2(I_MOV, op_reg(RAX), op_mem(RAX, 0));
+        return;
+    
+    case ND_NEG:
+        gen(node->lhs);
+        emit1(I_NEG, op_reg(RAX));
         return;
     
     case ND_RETURN:
         gen(node->lhs);
-        printf("  jmp .L.return.%s\n", current_func);
+        emit1(I_JMP, op_label(return_label));
         return;
     
     case ND_IF: {
-        int seq = label_seq++;
+        int end = new_label();
         if (node->els) {
-            gen(node->cond);
-            printf("  cmp rax, 0\n");
-            printf("  je .L.else.%d\n", seq);
+            int els = new_label();
+            gen_branch(node->cond, 0, els);
             gen(node->then);
-            printf("  jmp .L.end.%d\n", seq);
-            printf(".L.else.%d:\n", seq);
+            emit1(I_JMP, op_label(end));
+            emit_label(els);
             gen(node->els);
-            printf(".L.end.%d:\n", seq);
+            emit_label(end);
         } else {
-            gen(node->cond);
-            printf("  cmp rax, 0\n");
-            printf("  je .L.end.%d\n", seq);
+            gen_branch(node->cond, 0, end);
             gen(node->then);
-            printf(".L.end.%d:\n", seq);
+            emit_label(end);
         }
         return;
     }
     
+    // Loops test their condition at the bottom, so that each iteration
+    // takes one conditional jump back instead of a jump and a branch. A
+    // condition folded away as always true leaves cond NULL.
     case ND_WHILE: {
-        int seq = label_seq++;
-        printf(".L.begin.%d:\n", seq);
-        gen(node->cond);
-        printf("  cmp rax, 0\n");
-        printf("  je .L.end.%d\n", seq);
+        int body = new_label();
+        int test = new_label();
+        emit1(I_JMP, op_label(test));
+        emit_label(body);
         gen(node->then);
-        printf("  jmp .L.begin.%d\n", seq);
-        printf(".L.end.%d:\n", seq);
+        emit_label(test);
+        if (node->cond)
+            gen_branch(node->cond, 1, body);
+        else
+            emit1(I_JMP, op_label(body));
         return;
     }
     
     case ND_FOR: {
-        int seq = label_seq++;
+        int body = new_label();
+        int test = new_label();
         if (node->init)
             gen(node->init);
-        printf(".L.begin.%d:\n", seq);
-        if (node->cond) {
-            gen(node->cond);
-            printf("  cmp rax, 0\n");
-            printf("  je .L.end.%d\n", seq);
-        }
+        emit1(I_JMP, op_label(test));
+        emit_label(body);
         gen(node->then);
         if (node->inc)
             gen(node->inc);
-        printf("  jmp .L.begin.%d\n", seq);
-        printf(".L.end.%d:\n", seq);
+        emit_label(test);
+        if (node->cond)
+            gen_branch(node->cond, 1, body);
+        else
+            emit1(I_JMP, op_label(body));
         return;
     }
     
@@ -126,7 +302,20 @@ void gen(Node *node) {
             gen(node->stmts[i]);
         return;
     
+    // The return statements of an inlined body jump to its end
+    case ND_INLINE: {
+        int caller_return = return_label;
+        return_label = new_label();
+        for (int i = 0; i < node->num_stmts; i++)
+            gen(node->stmts[i]);
+        emit_label(return_label);
+        return_label = caller_return;
+        return;
+    }
+    
     case ND_FUNCALL: {
+        gen_save_tmps();
+
         // Push arguments in reverse order (following x86-64 calling convention)
         for (int i = node->num_args - 1; i >= 0; i--) {
             gen(node->args[i]);
@@ -134,97 +323,74 @@ void gen(Node *node) {
         }
         
         // Pop arguments to registers (up to 6 arguments)
-        char *regs[] = {"rdi", "rsi", "rdx", "rcx", "r8", "r9"};
         for (int i = 0; i < node->num_args && i < 6; i++) {
-            gen_pop(regs[i]);
+            gen_pop(arg_regs[i]);
         }
         
-        // Call function
-        // Align stack to 16 bytes
-        printf("  mov rax, rsp\n");
-        printf("  and rax, 15\n");
-        printf("  jnz .L.call.%d\n", label_seq);
-        printf("  mov rax, 0\n");
-        printf("  call %s\n", node->funcname);
-        printf("  jmp .L.end.%d\n", label_seq);
-        printf(".L.call.%d:\n", label_seq);
-        printf("  sub rsp, 8\n");
-        printf("  mov rax, 0\n");
-        printf("  call %s\n", node->funcname);
-        printf("  add rsp, 8\n");
-        printf(".L.end.%d:\n", label_seq);
-        label_seq++;
+        // Call function, padding the stack to 16 bytes if an odd number
+        // of values is pushed
+        int pad = stack_depth % 2;
+        if (pad)
+            emit2(I_SUB, op_reg(RSP), op_imm(8));
+        emit2(I_MOV, op_reg(RAX), op_imm(0));
+        emit1(I_CALL, op_sym(node->funcname));
+        if (pad)
+            emit2(I_ADD, op_reg(RSP), op_imm(8));
+        gen_restore_tmps();
         return;
     }
     
     case ND_SIZEOF:
-        printf("  mov rax, %d\n", node->val);
+        emit2(I_MOV, op_reg(RAX), op_imm(node->val));
+        return;
+    }
+    
+    if (is_compare(node->kind)) {
+        gen_setcc(gen_compare(node));
         return;
     }
+
+    // Binary operators with a constant operand use immediates
+    if (node->rhs->kind == ND_NUM && gen_binary_imm(node))
+        return;
     
     // Binary operators
-    gen(node->lhs);
-    gen_push();
-    gen(node->rhs);
-    gen_pop("rdi");
+    gen_operands(node);
     
     switch (node->kind) {
     case ND_ADD:
-        printf("  add rax, rdi\n");
+        emit2(I_ADD, op_reg(RAX), op_reg(RDI));
         return;
     case ND_SUB:
-        printf("  sub rdi, rax\n");
-        printf("  mov rax, rdi\n");
+        emit2(I_SUB, op_reg(RDI), op_reg(RAX));
+        emit2(I_MOV, op_reg(RAX), op_reg(RDI));
         return;
     case ND_MUL:
-        printf("  imul rax, rdi\n");
+        emit2(I_IMUL, op_reg(RAX), op_reg(RDI));
         return;
     case ND_DIV:
-        printf("  mov rcx, rax\n");
-        printf("  mov rax, rdi\n");
-        printf("  cqo\n");
-        printf("  idiv rcx\n");
-        return;
     case ND_MOD:
-        printf("  mov rcx, rax\n");
-        printf("  mov rax, rdi\n");
-        printf("  cqo\n");
-        printf("  idiv rcx\n");
-        printf("  mov rax, rdx\n");
-        return;
-    case ND_EQ:
-        printf("  cmp rdi, rax\n");
-        printf("  sete al\n");
-        printf("  movzb rax, al\n");
-        return;
-    case ND_NE:
-        printf("  cmp rdi, rax\n");
-        printf("  setne al\n");
-        printf("  movzb rax, al\n");
-        return;
-    case ND_LT:
-        printf("  cmp rdi, rax\n");
-        printf("  setl al\n");
-        printf("  movzb rax, al\n");
+        emit2(I_MOV, op_reg(RCX), op_reg(RAX));
+        emit2(I_MOV, op_reg(RAX), op_reg(RDI));
+        emit0(I_CQO);
+        emit1(I_IDIV, op_reg(RCX));
+        if (node->kind == ND_MOD)
+            emit2(I_MOV, op_reg(RAX), op_reg(RDX));
         return;
-    case ND_LE:
-        printf("  cmp rdi, rax\n");
-        printf("  setle al\n");
-        printf("  movzb rax, al\n");
+    default:
         return;
     }
 }
 
-// Generate string literals
-void gen_strings(Function *prog) {
-    printf(".data\n");
-    
-    // Collect all string literals
-    for (Function *fn = prog; fn; fn = fn->next) {
-        for (int i = 0; i < fn->num_stmts; i++) {
-            gen_strings_node(fn->stmts[i]);
-        }
-    }
+// Generate the string literals of fn into .data, after its code, so that
+// the text of a function is self-contained
+void gen_strings(Function *fn) {
+    if (!fn->num_strings)
+        return;
+    emit_directive(".data");
+    for (int i = 0; i < fn->num_stmts; i++)
+        gen_strings_node(fn->stmts[i]);
+    emit_directive(".text");
 }
 
 void gen_strings_node(Node *node) {
@@ -232,19 +398,9 @@ void gen_strings_node(Node *node) {
         return;
     
     if (node->kind == ND_STRING) {
-        printf(".LC%d:\n", node->str_label);
-        printf("  .string \"");
-        for (char *p = node->str_val; *p; p++) {
-            if (*p == '\n') printf("\\n");
-            else if (*p == '\t') printf("\\t");
-            else if (*p == '\\') printf("\\\\");
-            else if (*p == '"') printf("\\\"");
-            else printf("%c", *p);
-        }
-        printf("\"\n");
+        emit_string(node->str_label, node->str_val);
         return;
     }
-    
     gen_strings_node(node->lhs);
     gen_strings_node(node->rhs);
     gen_strings_node(node->cond);
@@ -264,41 +420,70 @@ void gen_strings_node(Node *node) {
     }
 }
 
+// Generate code for function funcs[i]
+static void gen_func(void *funcs, int i) {
+    Function *fn = ((Function **)funcs)[i];
+    if (fn->code) {
+        emit_text(fn->code, fn->code_len);
+        return;
+    }
+    emit_func(fn->name);
+    return_label = new_label();
+    if (opt_regalloc)
+        regalloc(fn, &ra);
+    else
+        ra.frame_size = fn->stack_size;
+    ra.frame_size = (ra.frame_size + 15) / 16 * 16;
+    tmp_depth = 0;
+    stack_depth = 0;
+    
+    // Prologue
+    emit1(I_PUSH, op_reg(RBP));
+    emit2(I_MOV, op_reg(RBP), op_reg(RSP));
+    emit2(I_SUB, op_reg(RSP), op_imm(ra.frame_size));
+    for (int i = 0; i < ra.num_saved; i++)
+        emit2(I_MOV, op_mem(RBP, -ra.saved_offsets[i]), op_reg(ra.saved_regs[i]));
+    
+    // Save arguments to local variables
+    for (int i = 0; i < fn->num_params && i < 6; i++) {
+        Reg reg = lvar_reg(fn->params[i]);
+        if (reg != REG_NONE)
+            emit2(I_MOV, op_reg(reg), op_reg(arg_regs[i]));
+        else
+            emit2(I_MOV, op_mem(RBP, -fn->params[i]->offset), op_reg(arg_regs[i]));
+    }
+    
+    // Generate code for statements
+    for (int i = 0; i < fn->num_stmts; i++) {
+        gen(fn->stmts[i]);
+    }
+    
+    // Epilogue (with function-specific label)
+    emit_label(return_label);
+    for (int i = 0; i < ra.num_saved; i++)
+        emit2(I_MOV, op_reg(ra.saved_regs[i]), op_mem(RBP, -ra.saved_offsets[i]));
+    memset(&ra, 0, sizeof(ra));
+    arena_reset(&gen_arena);
+    emit2(I_MOV, op_reg(RSP), op_reg(RBP));
+    emit1(I_POP, op_reg(RBP));
+    emit0(I_RET);
+    gen_strings(fn);
+}
+
 // Generate code for entire program
 void codegen(Function *prog) {
     // Output assembly header
-    printf(".intel_syntax noprefix\n");
-    
-    // Generate string literals
-    gen_strings(prog);
+    emit_directive(".intel_syntax noprefix");
     
-    // Generate code for each function
-    printf(".text\n");
-    for (Function *fn = prog; fn; fn = fn->next) {
-        current_func = fn->name;
-        printf(".globl %s\n", fn->name);
-        printf("%s:\n", fn->name);
-        
-        // Prologue
-        printf("  push rbp\n");
-        printf("  mov rbp, rsp\n");
-        printf("  sub rsp, %d\n", fn->stack_size);
-        
-        // Save arguments to local variables
-        char *regs[] = {"rdi", "rsi", "rdx", "rcx", "r8", "r9"};
-        for (int i = 0; i < fn->num_params && i < 6; i++) {
-            printf("  mov [rbp-%d], %s\n", fn->params[i]->offset, regs[i]);
-        }
-        
-        // Generate code for statements
-        for (int i = 0; i < fn->num_stmts; i++) {
-            gen(fn->stmts[i]);
-        }
-        
-        // Epilogue (with function-specific label)
-        printf(".L.return.%s:\n", fn->name);
-        printf("  mov rsp, rbp\n");
-        printf("  pop rbp\n");
-        printf("  ret\n");
-    }
+    // Generate code for each function, possibly in parallel (-j)
+    emit_directive(".text");
+    int n = 0;
+    for (Function *fn = prog; fn; fn = fn->next)
+        n++;
+    Function **funcs = calloc(n, sizeof(Function *));
+    n = 0;
+    for (Function *fn = prog; fn; fn = fn->next)
+        funcs[n++] = fn;
+    emit_functions(n, gen_func, funcs);
+    free(funcs);
 }
@@ -5,6 +5,41 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <setjmp.h>
+
+// Arena allocator: bump allocation, freed all at once
+typedef struct ArenaChunk ArenaChunk;
+
+typedef struct Arena {
+    char *name;
+    ArenaChunk *chunks;
+    ArenaChunk *cur;    // Chunk currently being filled
+    size_t used;        // Bytes allocated since the last reset
+    size_t peak;        // Highest value of used
+    size_t capacity;    // Bytes reserved in chunks
+    int num_chunks;
+    long num_allocs;
+} Arena;
+
+// Each thread has its own arenas, since a compilation runs on one thread
+extern _Thread_local Arena token_arena;  // Token arrays
+extern _Thread_local Arena node_arena;   // AST nodes, locals, functions, strings
+extern _Thread_local Arena ir_arena;     // IR instructions and basic blocks
+extern _Thread_local Arena gen_arena;    // Per-function code generator scratch
+extern _Thread_local Arena name_arena;   // Interned identifiers
+
+// The arenas of the calling thread. Their addresses differ per thread, so
+// the list is built where it is used.
+#define THREAD_ARENAS {&token_arena, &node_arena, &ir_arena, &gen_arena, &name_arena}
+#define NUM_ARENAS 5
+
+void *arena_alloc(Arena *arena, size_t size);
+char *arena_strndup(Arena *arena, char *s, int len);
+void arena_reset(Arena *arena);
+void arena_release_all();
+void arena_reset_all();
+void arena_merge(Arena *arena, Arena *from);
+void arena_report();
 
 // Token types
 typedef enum {
@@ -44,14 +79,15 @@ typedef enum {
     TK_EOF,      // End of file
 } TokenKind;
 
-// Token structure
-typedef struct Token {
-    TokenKind kind;
-    struct Token *next;
-    int val;         // For TK_NUM
-    char *str;       // Token string
-    int len;         // Token length
-} Token;
+// Tokens, stored as parallel arrays indexed by token number
+typedef struct TokenArray {
+    unsigned char *kind;  // TokenKind
+    int *offset;          // Byte offset into user_input
+    int *len;             // Token length
+    int *val;             // Value of TK_NUM, interned name of TK_IDENT
+    int count;
+    int capacity;
+} TokenArray;
 
 // AST node types
 typedef enum {
@@ -60,6 +96,7 @@ typedef enum {
     ND_MUL,       // *
     ND_DIV,       // /
     ND_MOD,       // %
+    ND_NEG,       // Unary -
     ND_EQ,        // ==
     ND_NE,        // !=
     ND_LT,        // <
@@ -77,6 +114,7 @@ typedef enum {
     ND_DEREF,     // Unary *
     ND_SIZEOF,    // sizeof
     ND_STRING,    // String literal
+    ND_INLINE,    // Inlined call: stmts, returning through the slot at offset
 } NodeKind;
 
 // AST node structure
@@ -92,11 +130,11 @@ typedef struct Node {
     struct Node *init;
     struct Node *inc;
     
-    // For ND_BLOCK
+    // For ND_BLOCK and ND_INLINE
     struct Node **stmts;
     int num_stmts;
     
-    // For ND_FUNCALL
+    // For ND_FUNCALL (funcname also names the callee of ND_INLINE)
     char *funcname;
     struct Node **args;
     int num_args;
@@ -104,11 +142,11 @@ typedef struct Node {
     // For ND_NUM
     int val;
     
-    // For ND_LVAR and ND_STRING
+    // For ND_LVAR, ND_STRING and ND_INLINE
     int offset;      // Offset from RBP for local variables
     
     // For ND_STRING
-    int str_label;   // Label number for string literal
+    int str_label;   // Number of the string literal in its function
     char *str_val;   // String value
     
     // Type information
@@ -118,8 +156,7 @@ typedef struct Node {
 // Local variable
 typedef struct LVar {
     struct LVar *next;
-    char *name;
-    int len;
+    int name;       // Interned name
     int offset;
 } LVar;
 
@@ -129,24 +166,147 @@ typedef struct Function {
     char *name;
     Node **params;
     int num_params;
+    int num_calls;   // Calls in the body, as parsed
     Node **locals;
     int num_locals;
     Node **stmts;
     int num_stmts;
     int stack_size;
+    int num_strings;
+    char *code;      // Assembly reused by incremental compilation, if any
+    long code_len;
 } Function;
 
-// Global variables
-extern char *user_input;
-extern Token *token;
-extern LVar *locals;
-extern int label_count;
-extern int str_count;
+// x86-64 general-purpose registers, numbered as in instruction encodings
+typedef enum {
+    REG_NONE = -1,
+    RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI,
+    R8, R9, R10, R11, R12, R13, R14, R15,
+} Reg;
+
+// Register assignment for one function (regalloc.c)
+typedef struct RegInfo {
+    Reg *lvar_reg;        // Register per stack slot (offset / 8), or REG_NONE
+    int num_slots;
+    Reg tmp_regs[7];      // Registers holding expression temporaries
+    int num_tmp_regs;
+    Reg saved_regs[5];    // Callee-saved registers used by the function
+    int saved_offsets[5]; // Their save slots relative to RBP
+    int num_saved;
+    int frame_size;       // stack_size plus callee-save slots
+} RegInfo;
+
+// IR opcodes (three-address code over virtual registers)
+typedef enum {
+    IR_IMM,       // dst = imm
+    IR_ADD,       // dst = a + b
+    IR_SUB,       // dst = a - b
+    IR_MUL,       // dst = a * b
+    IR_DIV,       // dst = a / b
+    IR_MOD,       // dst = a % b
+    IR_NEG,       // dst = -a
+    IR_EQ,        // dst = a == b
+    IR_NE,        // dst = a != b
+    IR_LT,        // dst = a < b
+    IR_LE,        // dst = a <= b
+    IR_LOADVAR,   // dst = local at offset imm
+    IR_STOREVAR,  // local at offset imm = a
+    IR_LVADDR,    // dst = address of local at offset imm
+    IR_STRADDR,   // dst = address of string literal imm
+    IR_LOAD,      // dst = [a]
+    IR_STORE,     // [a] = b
+    IR_CALL,      // dst = name(args...)
+    IR_RET,       // return a
+    IR_JMP,       // goto bb1
+    IR_BR,        // if a goto bb1 else goto bb2
+} IrOp;
+
+struct BasicBlock;
+
+// IR instruction
+typedef struct IrInsn {
+    IrOp op;
+    int dst;                // Destination vreg, or -1
+    int a;                  // First source vreg
+    int b;                  // Second source vreg
+    int imm;                // Constant, local offset or string label
+    char *name;             // Callee for IR_CALL
+    int *args;              // Argument vregs for IR_CALL
+    int num_args;
+    struct BasicBlock *bb1; // Jump target / branch taken
+    struct BasicBlock *bb2; // Branch not taken
+    struct IrInsn *next;
+} IrInsn;
+
+// Basic block: straight-line code ending in IR_JMP, IR_BR or IR_RET
+typedef struct BasicBlock {
+    int id;
+    IrInsn *first;
+    IrInsn *last;
+    struct BasicBlock *succs[2];
+    int num_succs;
+    struct BasicBlock **preds;
+    int num_preds;
+    int reachable;
+    struct BasicBlock *next;  // Layout order
+} BasicBlock;
+
+// Function in IR form
+typedef struct IrFunc {
+    struct IrFunc *next;
+    Function *fn;
+    char *name;
+    BasicBlock *blocks;
+    int num_blocks;
+    int num_vregs;
+} IrFunc;
+
+// State of the current compilation. A compilation runs on one thread, so
+// several files can be compiled at once (see main.c).
+extern _Thread_local char *input_path;    // For error messages
+extern _Thread_local jmp_buf *error_jmp;  // Where error() returns to, if set
+extern _Thread_local char *user_input;
+extern _Thread_local TokenArray tokens;
+extern _Thread_local int tok;          // Index of the current token
+extern _Thread_local LVar *locals;
+extern _Thread_local int str_count;
+
+// Compiler options
+extern int opt_regalloc;
+extern int opt_ir;
+extern int opt_fold;
+extern int opt_peephole;
+extern int opt_report;
+extern int opt_jobs;       // Code generation threads (-j)
+extern int opt_inline_threshold;  // Largest callee inlined, in nodes; 0 disables
+
+#define INLINE_THRESHOLD 20       // Default of --inline-threshold
+
+// String interner (intern.c)
+int intern(char *s, int len);
+char *name_str(int id);
+int name_len(int id);
+void intern_reset();
+
+// Run scanners used by the lexer (scan.c)
+typedef struct Scanner {
+    char *name;
+    char *(*skip_space)(char *p);   // Past whitespace
+    char *(*skip_line)(char *p);    // To the next '\n' or end of input
+    char *(*skip_ident)(char *p);   // Past identifier characters
+} Scanner;
+
+#define MAX_SCANNERS 3
+
+extern Scanner *scanner;
+int select_scanner(char *name);
+int supported_scanners(char **names);
 
 // Lexer functions
-Token *tokenize(char *p);
+void tokenize(char *p);
+char *tok_str(int i);
 int consume(TokenKind kind);
-Token *consume_ident();
+int consume_ident();
 void expect(TokenKind kind);
 int expect_number();
 int at_eof();
@@ -163,17 +323,179 @@ Node *add();
 Node *mul();
 Node *unary();
 Node *primary();
+Node *new_node(NodeKind kind);
+Node *new_num(int val);
 Node *new_node_addr(Node *node);
 Node *new_node_deref(Node *node);
 
+// Machine instructions, in the subset the code generators use
+typedef enum {
+    I_MOV,
+    I_MOVZB,      // Zero-extend the low byte of src
+    I_LEA,
+    I_ADD,
+    I_SUB,
+    I_IMUL,       // With an immediate: dst = dst * imm
+    I_IDIV,
+    I_CQO,
+    I_NEG,
+    I_AND,
+    I_CMP,
+    I_TEST,
+    I_SETE,       // setcc write the low byte of their operand
+    I_SETNE,
+    I_SETL,
+    I_SETLE,
+    I_SETG,
+    I_SETGE,
+    I_PUSH,
+    I_POP,
+    I_JMP,
+    I_JE,
+    I_JNE,
+    I_JL,
+    I_JLE,
+    I_JG,
+    I_JGE,
+    I_CALL,
+    I_RET,
+} Opcode;
+
+typedef enum {
+    OP_NONE,
+    OP_REG,       // reg
+    OP_IMM,       // imm
+    OP_MEM,       // [reg + imm]
+    OP_LABEL,     // Code label number imm
+    OP_STR,       // Address of string literal imm, RIP-relative
+    OP_SYM,       // Function name
+} OperandKind;
+
+typedef struct Operand {
+    OperandKind kind;
+    Reg reg;
+    int imm;
+    char *sym;
+} Operand;
+
+// Where the emitter sends the generated code
+typedef enum {
+    OUT_ASM,      // Assembly text
+    OUT_OBJECT,   // Relocatable ELF object file (-c)
+    OUT_MEMORY,   // Machine code kept in memory for elf_load (--run)
+} OutputKind;
+
+// Assembly emitter (emit.c)
+Operand op_reg(Reg reg);
+Operand op_imm(int imm);
+Operand op_mem(Reg base, int disp);
+Operand op_label(int label);
+Operand op_str(int str_label);
+Operand op_sym(char *name);
+void emit_open(char *path, OutputKind kind);
+void emit_close();
+void emit_abort();
+void emit0(Opcode op);
+void emit1(Opcode op, Operand a);
+void emit2(Opcode op, Operand dst, Operand src);
+void emit_label(int label);
+void emit_func(char *name);
+void emit_string(int str_label, char *str);
+void emit_directive(char *text);
+int new_label();
+int new_labels(int n);
+void emit_text(char *text, long len);
+void emit_record(void (*record)(void *arg, int i, char *code, long len), void *arg);
+void emit_functions(int n, void (*gen)(void *arg, int i), void *arg);
+
+// An instruction, or the definition of code label `label` if that is not
+// -1, as held for the peephole optimizer
+typedef struct Insn {
+    Opcode op;
+    Operand dst;
+    Operand src;
+    int label;
+} Insn;
+
+// Peephole optimizer (peephole.c)
+int peephole(Insn *insns, int n);
+long *peephole_counts();
+void peephole_merge(long *into);
+void peephole_report();
+
+// Object file writer (elf.c)
+void elf_insn(Opcode op, Operand *dst, Operand *src);
+void elf_label(int label);
+void elf_func(char *name);
+void elf_string(int str_label, char *str);
+void elf_write(int fd);
+void *elf_load(char *entry);
+void elf_reset();
+
+// Driver (main.c)
+int compile_request(int argc, char **argv, char *source);
+
+// Compile server (server.c)
+void serve(char *path);
+int client(char *socket_path, int argc, char **argv, char *source_path, char *output);
+
+// Compilation cache (cache.c)
+#define CACHE_KEY_SIZE 33
+void cache_open(char *dir, long limit);
+int cache_enabled();
+void cache_key(char *options, char *source, long len, char *key);
+int cache_fetch(char *key, char *output);
+char *cache_read(char *key, long *len);
+void cache_count(int hit);
+void cache_count_functions(long reused, long compiled);
+char *cache_temp_path(char *key);
+void cache_store(char *key, char *temp);
+void cache_close();
+void cache_report();
+
+// Compile statistics (stats.c)
+typedef enum {
+    PHASE_READ,
+    PHASE_TOKENIZE,
+    PHASE_PARSE,
+    PHASE_FOLD,
+    PHASE_IR,
+    PHASE_CODEGEN,   // Including writing the output
+    NUM_PHASES,
+} Phase;
+
+void stats_start(int thread_cpu);
+void stats_phase(Phase phase);
+void stats_count(Function *prog);
+void stats_report(char *path, int json);
+
+// Incremental compilation (incremental.c)
+void incremental(char *path, char *options, char *output);
+
 // Code generator functions
 void codegen(Function *prog);
 void gen(Node *node);
-void gen_strings(Function *prog);
+void gen_strings(Function *fn);
 void gen_strings_node(Node *node);
 
+// Optimization passes
+void fold(Function *prog);
+int is_compare(NodeKind kind);
+void inline_functions(Function *prog);
+
+// IR functions
+IrFunc *gen_ir(Function *prog);
+void dump_ir(IrFunc *prog);
+void codegen_ir(IrFunc *prog);
+
+// Register allocator functions
+void regalloc(Function *fn, RegInfo *ri);
+int regalloc_is_leaf(Node *node);
+int regalloc_is_caller_saved(Reg reg);
+
 // Utility functions
 void error(char *fmt, ...);
 void error_at(char *loc, char *fmt, ...);
+void fail();
 
 #endif
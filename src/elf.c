@@ -0,0 +1,642 @@
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE  // MAP_ANONYMOUS
+
+#include "compiler.h"
+#include <dlfcn.h>
+#include <elf.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Direct object file output (-c) and in-memory loading (--run).
+//
+// In object mode the emitter hands every instruction to elf_insn(), which
+// encodes it as x86-64 machine code into .text. String literals go to
+// .data. Jumps to labels are always rel32 and are patched at the end of
+// each function, since label numbers are local to a function. Calls and
+// references to string literals become relocations; a string literal is
+// defined after the code of its function, so the offset in .data is added
+// to the relocation at the end of the function too.
+// elf_write() then lays out a relocatable ELF64 file with .text, .data,
+// .rela.text, .symtab, .strtab and an empty .note.GNU-stack.
+//
+// For --run, elf_load() instead copies .text and .data into an mmap'd
+// region and applies the same relocations itself, resolving calls to
+// functions that are not defined in the program with dlsym().
+
+typedef struct Bytes {
+    unsigned char *data;
+    int len;
+    int capacity;
+} Bytes;
+
+typedef struct Fixup {
+    int offset;   // Position of a rel32 in .text
+    int label;
+} Fixup;
+
+typedef struct StrFixup {
+    int reloc;    // Index of a relocation against .data
+    int str_label;
+} StrFixup;
+
+typedef struct Reloc {
+    int offset;   // Position of the field in .text
+    int type;     // R_X86_64_*
+    char *sym;    // Function name, or NULL for .data
+    int addend;
+} Reloc;
+
+typedef struct Symbol {
+    char *name;
+    int offset;   // Offset in .text, or -1 if undefined
+} Symbol;
+
+// Encoder state of the current compilation
+static _Thread_local Bytes text;
+static _Thread_local Bytes data;
+
+static _Thread_local int *label_offsets;  // Label of the current function -> offset in .text, or -1
+static _Thread_local int num_label_offsets;
+static _Thread_local int *str_offsets;    // String literal of the current function -> offset in .data
+static _Thread_local int num_str_offsets;
+
+static _Thread_local Fixup *fixups;
+static _Thread_local int num_fixups;
+static _Thread_local int fixups_capacity;
+
+static _Thread_local StrFixup *str_fixups;
+static _Thread_local int num_str_fixups;
+static _Thread_local int str_fixups_capacity;
+
+static _Thread_local Reloc *relocs;
+static _Thread_local int num_relocs;
+static _Thread_local int relocs_capacity;
+
+static _Thread_local Symbol *symbols;     // Functions, defined or called
+static _Thread_local int num_symbols;
+static _Thread_local int symbols_capacity;
+static _Thread_local int *symbol_by_name; // Interned name -> symbols index + 1
+static _Thread_local int symbol_by_name_capacity;
+
+static void *grow(void *arr, int *capacity, int need, size_t elem_size) {
+    if (need <= *capacity)
+        return arr;
+    int cap = *capacity ? *capacity : 64;
+    while (cap < need)
+        cap *= 2;
+    arr = realloc(arr, cap * elem_size);
+    if (!arr)
+        error("Out of memory");
+    memset((char *)arr + *capacity * elem_size, 0, (cap - *capacity) * elem_size);
+    *capacity = cap;
+    return arr;
+}
+
+static void put_byte(Bytes *b, int c) {
+    b->data = grow(b->data, &b->capacity, b->len + 1, 1);
+    b->data[b->len++] = c;
+}
+
+static void put_bytes(Bytes *b, void *p, int len) {
+    b->data = grow(b->data, &b->capacity, b->len + len, 1);
+    memcpy(b->data + b->len, p, len);
+    b->len += len;
+}
+
+static void put32(Bytes *b, int val) {
+    unsigned char v[4] = {val, val >> 8, val >> 16, val >> 24};
+    put_bytes(b, v, 4);
+}
+
+static void align(Bytes *b, int n) {
+    while (b->len % n)
+        put_byte(b, 0);
+}
+
+// Symbol table entry of a function name, created on first use
+static Symbol *symbol(char *name) {
+    int id = intern(name, strlen(name));
+    symbol_by_name = grow(symbol_by_name, &symbol_by_name_capacity, id + 1, sizeof(int));
+    if (!symbol_by_name[id]) {
+        symbols = grow(symbols, &symbols_capacity, num_symbols + 1, sizeof(Symbol));
+        symbols[num_symbols] = (Symbol){name, -1};
+        symbol_by_name[id] = ++num_symbols;
+    }
+    return &symbols[symbol_by_name[id] - 1];
+}
+
+static void add_reloc(int type, char *sym, int addend) {
+    relocs = grow(relocs, &relocs_capacity, num_relocs + 1, sizeof(Reloc));
+    relocs[num_relocs++] = (Reloc){text.len, type, sym, addend};
+}
+
+static void set_offset(int **arr, int *n, int index, int offset) {
+    if (index >= *n) {
+        int old = *n;
+        *arr = grow(*arr, n, index + 1, sizeof(int));
+        for (int i = old; i < *n; i++)
+            (*arr)[i] = -1;
+    }
+    (*arr)[index] = offset;
+}
+
+// Instruction encoding
+
+static int fits8(int val) {
+    return val >= -128 && val <= 127;
+}
+
+// REX prefix; W selects 64-bit operands, r and b are the registers in the
+// ModRM reg and rm fields
+static void rex(int w, int r, int b) {
+    int prefix = 0x40 | (w << 3) | ((r >> 3) << 2) | (b >> 3);
+    if (prefix != 0x40)
+        put_byte(&text, prefix);
+}
+
+// ModRM (and SIB and displacement) for a register or [base + disp]
+static void modrm(int reg, Operand *rm) {
+    reg &= 7;
+    if (rm->kind == OP_REG) {
+        put_byte(&text, 0xc0 | (reg << 3) | (rm->reg & 7));
+        return;
+    }
+
+    if (rm->kind == OP_STR) {
+        // [rip + disp32]
+        put_byte(&text, (reg << 3) | 5);
+        str_fixups = grow(str_fixups, &str_fixups_capacity, num_str_fixups + 1, sizeof(StrFixup));
+        str_fixups[num_str_fixups++] = (StrFixup){num_relocs, rm->imm};
+        add_reloc(R_X86_64_PC32, NULL, -4);
+        put32(&text, 0);
+        return;
+    }
+
+    int base = rm->reg & 7;
+    int disp = rm->imm;
+    int mod;
+    // rbp and r13 have no form without a displacement
+    if (disp == 0 && base != 5)
+        mod = 0;
+    else if (fits8(disp))
+        mod = 1;
+    else
+        mod = 2;
+    put_byte(&text, (mod << 6) | (reg << 3) | base);
+    // rsp and r12 need a SIB byte
+    if (base == 4)
+        put_byte(&text, 0x24);
+    if (mod == 1)
+        put_byte(&text, disp);
+    else if (mod == 2)
+        put32(&text, disp);
+}
+
+static int rm_reg(Operand *op) {
+    return op->kind == OP_REG || op->kind == OP_MEM ? op->reg : 0;
+}
+
+// 64-bit instruction with opcode bytes op[0..len) and ModRM reg field reg
+static void insn_rm(int len, int op0, int op1, int reg, Operand *rm) {
+    rex(1, reg, rm_reg(rm));
+    put_byte(&text, op0);
+    if (len == 2)
+        put_byte(&text, op1);
+    modrm(reg, rm);
+}
+
+// Arithmetic group: add, sub, and, cmp; ext is the /digit of the
+// immediate form, op the opcode of "r/m64, r64"
+static void arith(int op, int ext, Operand *dst, Operand *src) {
+    if (src->kind == OP_IMM) {
+        if (fits8(src->imm)) {
+            insn_rm(1, 0x83, 0, ext, dst);
+            put_byte(&text, src->imm);
+        } else {
+            insn_rm(1, 0x81, 0, ext, dst);
+            put32(&text, src->imm);
+        }
+        return;
+    }
+    insn_rm(1, op, 0, src->reg, dst);
+}
+
+static void jump(int op0, int op1, Operand *target) {
+    put_byte(&text, op0);
+    if (op1)
+        put_byte(&text, op1);
+    fixups = grow(fixups, &fixups_capacity, num_fixups + 1, sizeof(Fixup));
+    fixups[num_fixups++] = (Fixup){text.len, target->imm};
+    put32(&text, 0);
+}
+
+static int setcc_code(Opcode op) {
+    switch (op) {
+    case I_SETE: return 0x94;
+    case I_SETNE: return 0x95;
+    case I_SETL: return 0x9c;
+    case I_SETLE: return 0x9e;
+    case I_SETG: return 0x9f;
+    default: return 0x9d;  // I_SETGE
+    }
+}
+
+// Encode one instruction into .text
+void elf_insn(Opcode op, Operand *dst, Operand *src) {
+    switch (op) {
+    case I_MOV:
+        if (src->kind == OP_IMM) {
+            insn_rm(1, 0xc7, 0, 0, dst);
+            put32(&text, src->imm);
+        } else if (src->kind == OP_REG) {
+            insn_rm(1, 0x89, 0, src->reg, dst);
+        } else {
+            insn_rm(1, 0x8b, 0, dst->reg, src);
+        }
+        return;
+    case I_MOVZB:
+        // Any REX prefix selects sil/dil rather than dh/bh; REX.W has one
+        insn_rm(2, 0x0f, 0xb6, dst->reg, src);
+        return;
+    case I_LEA:
+        insn_rm(1, 0x8d, 0, dst->reg, src);
+        return;
+    case I_ADD:
+        arith(0x01, 0, dst, src);
+        return;
+    case I_SUB:
+        arith(0x29, 5, dst, src);
+        return;
+    case I_AND:
+        arith(0x21, 4, dst, src);
+        return;
+    case I_CMP:
+        arith(0x39, 7, dst, src);
+        return;
+    case I_TEST:
+        insn_rm(1, 0x85, 0, src->reg, dst);
+        return;
+    case I_IMUL:
+        if (src->kind == OP_IMM) {
+            if (fits8(src->imm)) {
+                insn_rm(1, 0x6b, 0, dst->reg, dst);
+                put_byte(&text, src->imm);
+            } else {
+                insn_rm(1, 0x69, 0, dst->reg, dst);
+                put32(&text, src->imm);
+            }
+            return;
+        }
+        insn_rm(2, 0x0f, 0xaf, dst->reg, src);
+        return;
+    case I_IDIV:
+        insn_rm(1, 0xf7, 0, 7, dst);
+        return;
+    case I_NEG:
+        insn_rm(1, 0xf7, 0, 3, dst);
+        return;
+    case I_CQO:
+        put_byte(&text, 0x48);
+        put_byte(&text, 0x99);
+        return;
+    case I_SETE:
+    case I_SETNE:
+    case I_SETL:
+    case I_SETLE:
+    case I_SETG:
+    case I_SETGE:
+        // Byte registers above bl need a REX prefix to mean spl..dil
+        if (dst->reg >= 4)
+            put_byte(&text, 0x40 | (dst->reg >> 3));
+        put_byte(&text, 0x0f);
+        put_byte(&text, setcc_code(op));
+        modrm(0, dst);
+        return;
+    case I_PUSH:
+    case I_POP:
+        rex(0, 0, dst->reg);
+        put_byte(&text, (op == I_PUSH ? 0x50 : 0x58) + (dst->reg & 7));
+        return;
+    case I_JMP:
+        jump(0xe9, 0, dst);
+        return;
+    case I_JE:
+        jump(0x0f, 0x84, dst);
+        return;
+    case I_JNE:
+        jump(0x0f, 0x85, dst);
+        return;
+    case I_JL:
+        jump(0x0f, 0x8c, dst);
+        return;
+    case I_JLE:
+        jump(0x0f, 0x8e, dst);
+        return;
+    case I_JG:
+        jump(0x0f, 0x8f, dst);
+        return;
+    case I_JGE:
+        jump(0x0f, 0x8d, dst);
+        return;
+    case I_CALL:
+        put_byte(&text, 0xe8);
+        symbol(dst->sym);
+        add_reloc(R_X86_64_PLT32, dst->sym, -4);
+        put32(&text, 0);
+        return;
+    case I_RET:
+        put_byte(&text, 0xc3);
+        return;
+    }
+}
+
+// Patch the jumps of the current function with the distance to their
+// labels and its string references with the offsets of the strings, and
+// forget both
+static void resolve_labels() {
+    for (int i = 0; i < num_fixups; i++) {
+        Fixup *f = &fixups[i];
+        if (f->label >= num_label_offsets || label_offsets[f->label] < 0)
+            error("Undefined label %d", f->label);
+        int rel = label_offsets[f->label] - (f->offset + 4);
+        memcpy(text.data + f->offset, &rel, 4);
+    }
+    num_fixups = 0;
+    for (int i = 0; i < num_label_offsets; i++)
+        label_offsets[i] = -1;
+
+    for (int i = 0; i < num_str_fixups; i++) {
+        StrFixup *f = &str_fixups[i];
+        if (f->str_label >= num_str_offsets || str_offsets[f->str_label] < 0)
+            error("Undefined string literal %d", f->str_label);
+        relocs[f->reloc].addend += str_offsets[f->str_label];
+    }
+    num_str_fixups = 0;
+    for (int i = 0; i < num_str_offsets; i++)
+        str_offsets[i] = -1;
+}
+
+void elf_label(int label) {
+    set_offset(&label_offsets, &num_label_offsets, label, text.len);
+}
+
+void elf_func(char *name) {
+    resolve_labels();
+    align(&text, 16);
+    symbol(name)->offset = text.len;
+}
+
+void elf_string(int str_label, char *str) {
+    set_offset(&str_offsets, &num_str_offsets, str_label, data.len);
+    put_bytes(&data, str, strlen(str) + 1);
+}
+
+// Object file layout
+
+enum {
+    SEC_NULL,
+    SEC_TEXT,
+    SEC_DATA,
+    SEC_RELA,
+    SEC_SYMTAB,
+    SEC_STRTAB,
+    SEC_NOTE,
+    SEC_SHSTRTAB,
+    NUM_SECTIONS,
+};
+
+static int add_name(Bytes *strtab, char *name) {
+    int offset = strtab->len;
+    put_bytes(strtab, name, strlen(name) + 1);
+    return offset;
+}
+
+// Resolve label references and write the object file
+void elf_write(int fd) {
+    resolve_labels();
+
+    // Symbols: null, the two section symbols, then the functions. Locals
+    // must come first.
+    Bytes strtab = {0};
+    Bytes symtab = {0};
+    put_byte(&strtab, 0);
+    Elf64_Sym null_sym = {0};
+    put_bytes(&symtab, &null_sym, sizeof(null_sym));
+    for (int sec = SEC_TEXT; sec <= SEC_DATA; sec++) {
+        Elf64_Sym sym = {0};
+        sym.st_info = ELF64_ST_INFO(STB_LOCAL, STT_SECTION);
+        sym.st_shndx = sec;
+        put_bytes(&symtab, &sym, sizeof(sym));
+    }
+    int first_global = 3;
+    for (int i = 0; i < num_symbols; i++) {
+        Elf64_Sym sym = {0};
+        sym.st_name = add_name(&strtab, symbols[i].name);
+        if (symbols[i].offset >= 0) {
+            sym.st_info = ELF64_ST_INFO(STB_GLOBAL, STT_FUNC);
+            sym.st_shndx = SEC_TEXT;
+            sym.st_value = symbols[i].offset;
+        } else {
+            sym.st_info = ELF64_ST_INFO(STB_GLOBAL, STT_NOTYPE);
+            sym.st_shndx = SHN_UNDEF;
+        }
+        put_bytes(&symtab, &sym, sizeof(sym));
+    }
+
+    Bytes rela = {0};
+    for (int i = 0; i < num_relocs; i++) {
+        Reloc *r = &relocs[i];
+        int sym_index = SEC_DATA;  // The .data section symbol
+        if (r->sym)
+            sym_index = first_global + (symbol(r->sym) - symbols);
+        Elf64_Rela entry = {0};
+        entry.r_offset = r->offset;
+        entry.r_info = ELF64_R_INFO(sym_index, r->type);
+        entry.r_addend = r->addend;
+        put_bytes(&rela, &entry, sizeof(entry));
+    }
+
+    Bytes shstrtab = {0};
+    put_byte(&shstrtab, 0);
+    Elf64_Shdr shdrs[NUM_SECTIONS] = {0};
+    Bytes *contents[NUM_SECTIONS] = {
+        [SEC_TEXT] = &text, [SEC_DATA] = &data, [SEC_RELA] = &rela,
+        [SEC_SYMTAB] = &symtab, [SEC_STRTAB] = &strtab,
+        [SEC_SHSTRTAB] = &shstrtab,
+    };
+
+    shdrs[SEC_TEXT].sh_name = add_name(&shstrtab, ".text");
+    shdrs[SEC_TEXT].sh_type = SHT_PROGBITS;
+    shdrs[SEC_TEXT].sh_flags = SHF_ALLOC | SHF_EXECINSTR;
+    shdrs[SEC_TEXT].sh_addralign = 16;
+
+    shdrs[SEC_DATA].sh_name = add_name(&shstrtab, ".data");
+    shdrs[SEC_DATA].sh_type = SHT_PROGBITS;
+    shdrs[SEC_DATA].sh_flags = SHF_ALLOC | SHF_WRITE;
+    shdrs[SEC_DATA].sh_addralign = 1;
+
+    shdrs[SEC_RELA].sh_name = add_name(&shstrtab, ".rela.text");
+    shdrs[SEC_RELA].sh_type = SHT_RELA;
+    shdrs[SEC_RELA].sh_flags = SHF_INFO_LINK;
+    shdrs[SEC_RELA].sh_link = SEC_SYMTAB;
+    shdrs[SEC_RELA].sh_info = SEC_TEXT;
+    shdrs[SEC_RELA].sh_addralign = 8;
+    shdrs[SEC_RELA].sh_entsize = sizeof(Elf64_Rela);
+
+    shdrs[SEC_SYMTAB].sh_name = add_name(&shstrtab, ".symtab");
+    shdrs[SEC_SYMTAB].sh_type = SHT_SYMTAB;
+    shdrs[SEC_SYMTAB].sh_link = SEC_STRTAB;
+    shdrs[SEC_SYMTAB].sh_info = first_global;
+    shdrs[SEC_SYMTAB].sh_addralign = 8;
+    shdrs[SEC_SYMTAB].sh_entsize = sizeof(Elf64_Sym);
+
+    shdrs[SEC_STRTAB].sh_name = add_name(&shstrtab, ".strtab");
+    shdrs[SEC_STRTAB].sh_type = SHT_STRTAB;
+    shdrs[SEC_STRTAB].sh_addralign = 1;
+
+    // Marks the stack as non-executable
+    shdrs[SEC_NOTE].sh_name = add_name(&shstrtab, ".note.GNU-stack");
+    shdrs[SEC_NOTE].sh_type = SHT_PROGBITS;
+    shdrs[SEC_NOTE].sh_addralign = 1;
+
+    shdrs[SEC_SHSTRTAB].sh_name = add_name(&shstrtab, ".shstrtab");
+    shdrs[SEC_SHSTRTAB].sh_type = SHT_STRTAB;
+    shdrs[SEC_SHSTRTAB].sh_addralign = 1;
+
+    // Section contents follow the ELF header, each aligned as required,
+    // and the section header table comes last
+    Bytes file = {0};
+    Elf64_Ehdr ehdr = {0};
+    put_bytes(&file, &ehdr, sizeof(ehdr));
+    for (int sec = SEC_TEXT; sec < NUM_SECTIONS; sec++) {
+        if (shdrs[sec].sh_addralign > 1)
+            align(&file, shdrs[sec].sh_addralign);
+        shdrs[sec].sh_offset = file.len;
+        if (contents[sec]) {
+            shdrs[sec].sh_size = contents[sec]->len;
+            put_bytes(&file, contents[sec]->data, contents[sec]->len);
+        }
+    }
+    align(&file, 8);
+    int shoff = file.len;
+    put_bytes(&file, shdrs, sizeof(shdrs));
+
+    memcpy(ehdr.e_ident, ELFMAG, SELFMAG);
+    ehdr.e_ident[EI_CLASS] = ELFCLASS64;
+    ehdr.e_ident[EI_DATA] = ELFDATA2LSB;
+    ehdr.e_ident[EI_VERSION] = EV_CURRENT;
+    ehdr.e_ident[EI_OSABI] = ELFOSABI_SYSV;
+    ehdr.e_type = ET_REL;
+    ehdr.e_machine = EM_X86_64;
+    ehdr.e_version = EV_CURRENT;
+    ehdr.e_shoff = shoff;
+    ehdr.e_ehsize = sizeof(Elf64_Ehdr);
+    ehdr.e_shentsize = sizeof(Elf64_Shdr);
+    ehdr.e_shnum = NUM_SECTIONS;
+    ehdr.e_shstrndx = SEC_SHSTRTAB;
+    memcpy(file.data, &ehdr, sizeof(ehdr));
+
+    for (int done = 0; done < file.len;) {
+        ssize_t n = write(fd, file.data + done, file.len - done);
+        if (n < 0)
+            error("Write failed");
+        done += n;
+    }
+
+    free(file.data);
+    free(rela.data);
+    free(symtab.data);
+    free(strtab.data);
+    free(shstrtab.data);
+}
+
+// In-memory loading
+
+// Calls to library functions go through a stub next to the code,
+// "jmp [rip+0]" followed by the address, since the library may be mapped
+// further away than a rel32 reaches
+#define STUB_SIZE 14
+
+static long page_align(long n) {
+    long page = sysconf(_SC_PAGESIZE);
+    return (n + page - 1) & -page;
+}
+
+// Load the program into executable memory and return the address of the
+// function entry
+void *elf_load(char *entry) {
+    resolve_labels();
+
+    Symbol *entry_sym = symbol(entry);
+    if (entry_sym->offset < 0)
+        error("%s is not defined", entry);
+
+    // Code and stubs are mapped read-only and executable, .data after
+    // them read-write
+    long code_size = page_align(text.len + num_symbols * STUB_SIZE);
+    long size = code_size + page_align(data.len);
+    unsigned char *base = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED)
+        error("mmap failed");
+    memcpy(base, text.data, text.len);
+    memcpy(base + code_size, data.data, data.len);
+
+    // Each undefined symbol gets a stub pointing at the library function
+    void *lib = NULL;
+    unsigned char *stubs = base + text.len;
+    for (int i = 0; i < num_symbols; i++) {
+        if (symbols[i].offset >= 0)
+            continue;
+        if (!lib && !(lib = dlopen(NULL, RTLD_LAZY)))
+            error("dlopen failed: %s", dlerror());
+        void *addr = dlsym(lib, symbols[i].name);
+        if (!addr)
+            error("Undefined function %s", symbols[i].name);
+        unsigned char *stub = stubs + i * STUB_SIZE;
+        memcpy(stub, "\xff\x25\0\0\0\0", 6);
+        memcpy(stub + 6, &addr, 8);
+    }
+
+    for (int i = 0; i < num_relocs; i++) {
+        Reloc *r = &relocs[i];
+        unsigned char *target = base + code_size;
+        if (r->sym) {
+            Symbol *sym = symbol(r->sym);
+            if (sym->offset >= 0)
+                target = base + sym->offset;
+            else
+                target = stubs + (sym - symbols) * STUB_SIZE;
+        }
+        int rel = target + r->addend - (base + r->offset);
+        memcpy(base + r->offset, &rel, 4);
+    }
+
+    if (mprotect(base, code_size, PROT_READ | PROT_EXEC))
+        error("mprotect failed");
+    return base + entry_sym->offset;
+}
+
+// Free everything encoded so far, for the next compilation on this thread
+void elf_reset() {
+    free(text.data);
+    free(data.data);
+    free(label_offsets);
+    free(str_offsets);
+    free(fixups);
+    free(str_fixups);
+    free(relocs);
+    free(symbols);
+    free(symbol_by_name);
+    text = data = (Bytes){0};
+    label_offsets = str_offsets = symbol_by_name = NULL;
+    num_label_offsets = num_str_offsets = symbol_by_name_capacity = 0;
+    fixups = NULL;
+    num_fixups = fixups_capacity = 0;
+    str_fixups = NULL;
+    num_str_fixups = str_fixups_capacity = 0;
+    relocs = NULL;
+    num_relocs = relocs_capacity = 0;
+    symbols = NULL;
+    num_symbols = symbols_capacity = 0;
+}
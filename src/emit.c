@@ -0,0 +1,593 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "compiler.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+
+// Buffered assembly emitter.
+//
+// The code generators describe instructions as an opcode and operands,
+// and the emitter formats them into a large output buffer with a few
+// specialized formatters (register names from a table, integers by hand,
+// labels as ".L" plus a number) instead of printf. The buffer goes out
+// with one write() whenever it fills up and once at the end.
+//
+// In object mode (-c, --run) the same calls are passed to the encoder in
+// elf.c instead. For -c the object file is written when the output is
+// closed; for --run the code stays in the encoder for elf_load().
+//
+// Code labels are numbered per function and printed as ".L<function>.<n>",
+// and string literals as ".L<function>.s<n>" right after their function's
+// code, so the text of a function does not depend on the functions before
+// it.
+// That lets emit_functions() generate functions on several threads (-j),
+// each into a buffer of its own, and write the buffers in source order.
+//
+// With peephole optimization (the default), instructions and labels are
+// held as a list until the end of the function, or until something else
+// is emitted, and go through peephole() first (peephole.c).
+
+#define BUF_SIZE (1 << 20)
+
+// Room left in the buffer before an instruction is formatted, besides
+// the function name in labels. Only function names and string literals
+// can be longer; they reserve their own space.
+#define MAX_LINE 128
+
+// Per-thread emitter state, since each compilation runs on a thread of
+// its own. A compilation writes its buffer to the output whenever it
+// fills; code generation threads (-j) capture everything in a growing
+// buffer instead.
+static _Thread_local int out_fd = 1;
+static _Thread_local OutputKind output_kind;
+static _Thread_local int object_mode;   // Encoding machine code rather than text
+static _Thread_local char *buf;
+static _Thread_local long buf_len;
+static _Thread_local long buf_size;
+static _Thread_local int capturing;
+static _Thread_local int label_count;
+
+// Instructions of the current function waiting for the peephole optimizer
+static _Thread_local Insn *insns;
+static _Thread_local int num_insns;
+static _Thread_local int insns_capacity;
+
+// Receiver of the code of each function (see emit_record())
+static _Thread_local void (*recorder)(void *arg, int i, char *code, long len);
+static _Thread_local void *recorder_arg;
+
+// Names are stored with their lengths so they can be copied without strlen
+typedef struct Name {
+    char *str;
+    int len;
+} Name;
+
+#define NAME(s) {s, sizeof(s) - 1}
+
+// Name of the function being emitted, the prefix of its labels
+static _Thread_local Name func_name;
+
+static Name reg64[] = {
+    NAME("rax"), NAME("rcx"), NAME("rdx"), NAME("rbx"),
+    NAME("rsp"), NAME("rbp"), NAME("rsi"), NAME("rdi"),
+    NAME("r8"), NAME("r9"), NAME("r10"), NAME("r11"),
+    NAME("r12"), NAME("r13"), NAME("r14"), NAME("r15"),
+};
+
+static Name reg8[] = {
+    NAME("al"), NAME("cl"), NAME("dl"), NAME("bl"),
+    NAME("spl"), NAME("bpl"), NAME("sil"), NAME("dil"),
+    NAME("r8b"), NAME("r9b"), NAME("r10b"), NAME("r11b"),
+    NAME("r12b"), NAME("r13b"), NAME("r14b"), NAME("r15b"),
+};
+
+// Mnemonics with the two leading spaces of an instruction line
+static Name mnemonics[] = {
+    [I_MOV] = NAME("  mov"), [I_MOVZB] = NAME("  movzb"),
+    [I_LEA] = NAME("  lea"), [I_ADD] = NAME("  add"),
+    [I_SUB] = NAME("  sub"), [I_IMUL] = NAME("  imul"),
+    [I_IDIV] = NAME("  idiv"), [I_CQO] = NAME("  cqo"),
+    [I_NEG] = NAME("  neg"), [I_AND] = NAME("  and"),
+    [I_CMP] = NAME("  cmp"), [I_TEST] = NAME("  test"),
+    [I_SETE] = NAME("  sete"),
+    [I_SETNE] = NAME("  setne"), [I_SETL] = NAME("  setl"),
+    [I_SETLE] = NAME("  setle"), [I_SETG] = NAME("  setg"),
+    [I_SETGE] = NAME("  setge"), [I_PUSH] = NAME("  push"),
+    [I_POP] = NAME("  pop"), [I_JMP] = NAME("  jmp"),
+    [I_JE] = NAME("  je"), [I_JNE] = NAME("  jne"),
+    [I_JL] = NAME("  jl"), [I_JLE] = NAME("  jle"),
+    [I_JG] = NAME("  jg"), [I_JGE] = NAME("  jge"),
+    [I_CALL] = NAME("  call"), [I_RET] = NAME("  ret"),
+};
+
+Operand op_reg(Reg reg) {
+    return (Operand){OP_REG, reg};
+}
+
+Operand op_imm(int imm) {
+    return (Operand){OP_IMM, REG_NONE, imm};
+}
+
+Operand op_mem(Reg base, int disp) {
+    return (Operand){OP_MEM, base, disp};
+}
+
+Operand op_label(int label) {
+    return (Operand){OP_LABEL, REG_NONE, label};
+}
+
+Operand op_str(int str_label) {
+    return (Operand){OP_STR, REG_NONE, str_label};
+}
+
+Operand op_sym(char *name) {
+    return (Operand){OP_SYM, REG_NONE, 0, name};
+}
+
+// Allocate n consecutive code label numbers, unique in the current
+// function
+int new_labels(int n) {
+    int label = label_count;
+    label_count += n;
+    return label;
+}
+
+int new_label() {
+    return new_labels(1);
+}
+
+static void write_all(char *p, long len) {
+    while (len > 0) {
+        ssize_t n = write(out_fd, p, len);
+        if (n < 0)
+            error("Write failed");
+        p += n;
+        len -= n;
+    }
+}
+
+static void flush() {
+    write_all(buf, buf_len);
+    buf_len = 0;
+}
+
+// Make room for n more bytes
+static void reserve(long n) {
+    if (buf_len + n <= buf_size)
+        return;
+    if (capturing) {
+        while (buf_len + n > buf_size)
+            buf_size *= 2;
+        buf = realloc(buf, buf_size);
+        if (!buf)
+            error("Out of memory");
+        return;
+    }
+    flush();
+    if (n > buf_size)
+        error("Output line too long");
+}
+
+static void put(char *s, int len) {
+    memcpy(buf + buf_len, s, len);
+    buf_len += len;
+}
+
+static void put_name(Name *name) {
+    put(name->str, name->len);
+}
+
+static void put_char(char c) {
+    buf[buf_len++] = c;
+}
+
+static void put_int(long val) {
+    char tmp[24];
+    int i = sizeof(tmp);
+    unsigned long u = val < 0 ? -(unsigned long)val : val;
+    do {
+        tmp[--i] = '0' + u % 10;
+        u /= 10;
+    } while (u);
+    if (val < 0)
+        tmp[--i] = '-';
+    put(tmp + i, sizeof(tmp) - i);
+}
+
+static void put_label(int label) {
+    put(".L", 2);
+    put_name(&func_name);
+    put_char('.');
+    put_int(label);
+}
+
+static void put_str_label(int str_label) {
+    put(".L", 2);
+    put_name(&func_name);
+    put(".s", 2);
+    put_int(str_label);
+}
+
+static void put_operand(Operand *op, int byte) {
+    switch (op->kind) {
+    case OP_NONE:
+        return;
+    case OP_REG:
+        put_name(byte ? &reg8[op->reg] : &reg64[op->reg]);
+        return;
+    case OP_IMM:
+        put_int(op->imm);
+        return;
+    case OP_MEM:
+        put_char('[');
+        put_name(&reg64[op->reg]);
+        if (op->imm) {
+            if (op->imm > 0)
+                put_char('+');
+            put_int(op->imm);
+        }
+        put_char(']');
+        return;
+    case OP_LABEL:
+        put_label(op->imm);
+        return;
+    case OP_STR:
+        put("[rip + ", 7);
+        put_str_label(op->imm);
+        put_char(']');
+        return;
+    case OP_SYM:
+        put(op->sym, strlen(op->sym));
+        return;
+    }
+}
+
+static int is_setcc(Opcode op) {
+    return op >= I_SETE && op <= I_SETGE;
+}
+
+// Format or encode an instruction
+static void output_insn(Opcode op, Operand *dst, Operand *src) {
+    if (object_mode) {
+        elf_insn(op, dst, src);
+        return;
+    }
+    int sym_len = dst->kind == OP_SYM ? strlen(dst->sym) : 0;
+    reserve(MAX_LINE + func_name.len + sym_len);
+    put_name(&mnemonics[op]);
+    if (dst->kind == OP_NONE) {
+        put_char('\n');
+        return;
+    }
+    put_char(' ');
+    put_operand(dst, is_setcc(op));
+    // imul by an immediate is written in its three-operand form
+    if (op == I_IMUL && src->kind == OP_IMM) {
+        put(", ", 2);
+        put_operand(dst, 0);
+    }
+    if (src->kind != OP_NONE) {
+        put(", ", 2);
+        put_operand(src, op == I_MOVZB);
+    }
+    put_char('\n');
+}
+
+static void output_label(int label) {
+    if (object_mode) {
+        elf_label(label);
+        return;
+    }
+    reserve(MAX_LINE + func_name.len);
+    put_label(label);
+    put(":\n", 2);
+}
+
+static void hold(Insn insn) {
+    if (num_insns == insns_capacity) {
+        insns_capacity = insns_capacity ? insns_capacity * 2 : 256;
+        insns = realloc(insns, insns_capacity * sizeof(Insn));
+        if (!insns)
+            error("Out of memory");
+    }
+    insns[num_insns++] = insn;
+}
+
+// Optimize the held instructions and emit them
+static void flush_insns() {
+    if (!num_insns)
+        return;
+    int n = peephole(insns, num_insns);
+    num_insns = 0;
+    for (int i = 0; i < n; i++) {
+        if (insns[i].label >= 0)
+            output_label(insns[i].label);
+        else
+            output_insn(insns[i].op, &insns[i].dst, &insns[i].src);
+    }
+}
+
+static void free_insns() {
+    free(insns);
+    insns = NULL;
+    num_insns = insns_capacity = 0;
+}
+
+// Open the output, as assembly text, an object file or in memory; a NULL
+// path means standard output
+void emit_open(char *path, OutputKind kind) {
+    output_kind = kind;
+    object_mode = kind != OUT_ASM;
+    out_fd = 1;
+    if (path) {
+        out_fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (out_fd < 0)
+            error("Cannot open %s: %s", path, strerror(errno));
+    }
+    buf = malloc(BUF_SIZE);
+    if (!buf)
+        error("Out of memory");
+    buf_len = 0;
+    buf_size = BUF_SIZE;
+}
+
+// Write out everything emitted so far and close the output
+void emit_close() {
+    flush_insns();
+    free_insns();
+    if (output_kind == OUT_OBJECT)
+        elf_write(out_fd);
+    flush();
+    if (out_fd != 1)
+        close(out_fd);
+    free(buf);
+    buf = NULL;
+}
+
+// Close the output after an error, dropping what was not written yet
+void emit_abort() {
+    free_insns();
+    recorder = NULL;
+    capturing = 0;
+    if (out_fd != 1)
+        close(out_fd);
+    out_fd = 1;
+    free(buf);
+    buf = NULL;
+}
+
+void emit2(Opcode op, Operand dst, Operand src) {
+    if (opt_peephole) {
+        hold((Insn){op, dst, src, -1});
+        return;
+    }
+    output_insn(op, &dst, &src);
+}
+
+void emit1(Opcode op, Operand a) {
+    emit2(op, a, (Operand){OP_NONE});
+}
+
+void emit0(Opcode op) {
+    emit2(op, (Operand){OP_NONE}, (Operand){OP_NONE});
+}
+
+void emit_label(int label) {
+    if (opt_peephole) {
+        hold((Insn){.label = label});
+        return;
+    }
+    output_label(label);
+}
+
+// Start a global function, and a new label namespace
+void emit_func(char *name) {
+    flush_insns();
+    int len = strlen(name);
+    func_name = (Name){name, len};
+    label_count = 0;
+    if (object_mode) {
+        elf_func(name);
+        return;
+    }
+    reserve(2 * len + 16);
+    put(".globl ", 7);
+    put(name, len);
+    put_char('\n');
+    put(name, len);
+    put(":\n", 2);
+}
+
+// Define string literal str_label of the current function
+void emit_string(int str_label, char *str) {
+    flush_insns();
+    if (object_mode) {
+        elf_string(str_label, str);
+        return;
+    }
+    reserve(MAX_LINE + func_name.len);
+    put_str_label(str_label);
+    put(":\n  .string \"", 13);
+    for (char *p = str; *p; p++) {
+        reserve(4);
+        switch (*p) {
+        case '\n': put("\\n", 2); break;
+        case '\t': put("\\t", 2); break;
+        case '\\': put("\\\\", 2); break;
+        case '"': put("\\\"", 2); break;
+        default: put_char(*p); break;
+        }
+    }
+    put("\"\n", 2);
+}
+
+// Emit text generated earlier, such as the code of a function reused by
+// incremental compilation
+void emit_text(char *text, long len) {
+    flush_insns();
+    if (!capturing && len > buf_size) {
+        flush();
+        write_all(text, len);
+        return;
+    }
+    reserve(len);
+    put(text, len);
+}
+
+// Emit an assembler directive such as ".text" on its own line
+void emit_directive(char *text) {
+    flush_insns();
+    if (object_mode)
+        return;
+    int len = strlen(text);
+    reserve(len + 1);
+    put(text, len);
+    put_char('\n');
+}
+
+// Parallel code generation (-j)
+
+typedef struct Piece {
+    int worker;     // Thread whose buffer holds the code
+    long offset;
+    long len;
+} Piece;
+
+typedef struct Worker {
+    pthread_t thread;
+    char *buf;
+    int failed;     // Whether an error ended its work
+} Worker;
+
+// One compilation at a time uses parallel code generation; in batch mode
+// (several input files) each file is generated on a single thread
+static void (*gen_func)(void *arg, int i);
+static void *gen_arg;
+static int num_funcs;
+static char *gen_input_path;
+static atomic_int next_func;
+static Piece *pieces;
+static Worker *workers;
+static Arena *total_gen_arena;
+static long *total_peephole_counts;
+static pthread_mutex_t arena_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Generate functions, taking the next one in order until all are done.
+// An error stops every worker and is raised again on the calling thread.
+static void *worker_main(void *arg) {
+    int id = (Worker *)arg - workers;
+    jmp_buf on_error;
+    input_path = gen_input_path;
+    error_jmp = &on_error;
+    if (setjmp(on_error)) {
+        workers[id].failed = 1;
+        atomic_store(&next_func, num_funcs);
+    } else {
+        capturing = 1;
+        buf_size = BUF_SIZE / 16;
+        buf = malloc(buf_size);
+        if (!buf)
+            error("Out of memory");
+
+        for (;;) {
+            int i = atomic_fetch_add(&next_func, 1);
+            if (i >= num_funcs)
+                break;
+            long start = buf_len;
+            gen_func(gen_arg, i);
+            flush_insns();
+            pieces[i] = (Piece){id, start, buf_len - start};
+        }
+    }
+    error_jmp = NULL;
+    workers[id].buf = buf;
+    free_insns();
+
+    pthread_mutex_lock(&arena_lock);
+    arena_merge(total_gen_arena, &gen_arena);
+    peephole_merge(total_peephole_counts);
+    pthread_mutex_unlock(&arena_lock);
+    return NULL;
+}
+
+// Have emit_functions() also pass the assembly of every function i to
+// record(arg, i, code, len), until called with NULL. Used by incremental
+// compilation to keep the code of each function.
+void emit_record(void (*record)(void *arg, int i, char *code, long len), void *arg) {
+    recorder = record;
+    recorder_arg = arg;
+}
+
+// Generate the code of n functions by calling gen(arg, 0) .. gen(arg, n-1),
+// and emit it in that order. With -j N the functions are generated by N
+// threads; the output is the same as with one. Object files are encoded
+// serially.
+void emit_functions(int n, void (*gen)(void *arg, int i), void *arg) {
+    int jobs = opt_jobs < n ? opt_jobs : n;
+    if (object_mode || (jobs <= 1 && !recorder)) {
+        for (int i = 0; i < n; i++)
+            gen(arg, i);
+        return;
+    }
+    if (jobs <= 1) {
+        // Keep each function in the buffer until it is recorded
+        flush();
+        capturing = 1;
+        for (int i = 0; i < n; i++) {
+            long start = buf_len;
+            gen(arg, i);
+            flush_insns();
+            recorder(recorder_arg, i, buf + start, buf_len - start);
+        }
+        capturing = 0;
+        return;
+    }
+
+    gen_func = gen;
+    gen_arg = arg;
+    num_funcs = n;
+    gen_input_path = input_path;
+    atomic_store(&next_func, 0);
+    total_gen_arena = &gen_arena;
+    total_peephole_counts = peephole_counts();
+    pieces = calloc(n, sizeof(Piece));
+    workers = calloc(jobs, sizeof(Worker));
+    if (!pieces || !workers)
+        error("Out of memory");
+    for (int i = 0; i < jobs; i++)
+        if (pthread_create(&workers[i].thread, NULL, worker_main, &workers[i]))
+            error("Cannot create thread");
+    int failed = 0;
+    for (int i = 0; i < jobs; i++) {
+        pthread_join(workers[i].thread, NULL);
+        failed |= workers[i].failed;
+    }
+    if (failed) {
+        // The worker has reported the error
+        for (int i = 0; i < jobs; i++)
+            free(workers[i].buf);
+        free(workers);
+        free(pieces);
+        fail();
+    }
+
+    for (int i = 0; i < n; i++) {
+        char *code = workers[pieces[i].worker].buf + pieces[i].offset;
+        if (recorder)
+            recorder(recorder_arg, i, code, pieces[i].len);
+        if (pieces[i].len > BUF_SIZE) {
+            flush();
+            write_all(code, pieces[i].len);
+            continue;
+        }
+        reserve(pieces[i].len);
+        put(code, pieces[i].len);
+    }
+    for (int i = 0; i < jobs; i++)
+        free(workers[i].buf);
+    free(workers);
+    free(pieces);
+}
@@ -0,0 +1,356 @@
+#include "compiler.h"
+
+// Constant folding and algebraic simplification over the AST.
+//
+// Runs once after parsing. Constant subtrees are evaluated, identities such
+// as x + 0 and x * 1 are removed, negation (parsed as 0 - x) becomes ND_NEG
+// and constants of commutative operators are moved to the right-hand side,
+// where the code generators can use them as immediates. Statements without
+// effect and branches on constant conditions are dropped.
+
+static _Thread_local int num_folded;
+static _Thread_local int num_simplified;
+static _Thread_local int num_removed;
+
+static int is_num(Node *node, int val) {
+    return node->kind == ND_NUM && node->val == val;
+}
+
+// Whether kind is a comparison producing 0 or 1
+int is_compare(NodeKind kind) {
+    return kind == ND_EQ || kind == ND_NE || kind == ND_LT || kind == ND_LE;
+}
+
+static int fits_int(long val) {
+    return val >= -2147483647L - 1 && val <= 2147483647L;
+}
+
+// Whether evaluating node may write memory or call a function
+static int has_side_effects(Node *node) {
+    if (!node)
+        return 0;
+    if (node->kind == ND_ASSIGN || node->kind == ND_FUNCALL)
+        return 1;
+    return has_side_effects(node->lhs) || has_side_effects(node->rhs);
+}
+
+// Evaluate a binary operator on constants; returns 0 if it cannot be folded
+static int eval(NodeKind kind, long a, long b, long *out) {
+    switch (kind) {
+    case ND_ADD: *out = a + b; break;
+    case ND_SUB: *out = a - b; break;
+    case ND_MUL: *out = a * b; break;
+    case ND_DIV:
+        if (b == 0)
+            return 0;
+        *out = a / b;
+        break;
+    case ND_MOD:
+        if (b == 0)
+            return 0;
+        *out = a % b;
+        break;
+    case ND_EQ: *out = a == b; break;
+    case ND_NE: *out = a != b; break;
+    case ND_LT: *out = a < b; break;
+    case ND_LE: *out = a <= b; break;
+    default:
+        return 0;
+    }
+    return fits_int(*out);
+}
+
+static Node *to_num(Node *node, int val) {
+    node->kind = ND_NUM;
+    node->val = val;
+    node->lhs = NULL;
+    node->rhs = NULL;
+    return node;
+}
+
+static Node *new_neg(Node *operand) {
+    Node *node = new_node(ND_NEG);
+    node->lhs = operand;
+    return node;
+}
+
+static Node *fold_expr(Node *node);
+
+static Node *fold_binary(Node *node) {
+    node->lhs = fold_expr(node->lhs);
+    node->rhs = fold_expr(node->rhs);
+    Node *lhs = node->lhs;
+    Node *rhs = node->rhs;
+
+    long val;
+    if (lhs->kind == ND_NUM && rhs->kind == ND_NUM &&
+        eval(node->kind, lhs->val, rhs->val, &val)) {
+        num_folded++;
+        return to_num(node, val);
+    }
+
+    // Constants go on the right of commutative operators
+    if (lhs->kind == ND_NUM && rhs->kind != ND_NUM &&
+        (node->kind == ND_ADD || node->kind == ND_MUL ||
+         node->kind == ND_EQ || node->kind == ND_NE)) {
+        node->lhs = rhs;
+        node->rhs = lhs;
+        lhs = node->lhs;
+        rhs = node->rhs;
+    }
+
+    switch (node->kind) {
+    case ND_SUB:
+        if (is_num(lhs, 0)) {
+            num_simplified++;
+            return fold_expr(new_neg(rhs));
+        }
+        // x - c => x + (-c), so constant chains can be combined
+        if (rhs->kind == ND_NUM && fits_int(-(long)rhs->val)) {
+            node->kind = ND_ADD;
+            rhs->val = -rhs->val;
+            return fold_binary(node);
+        }
+        break;
+    case ND_ADD:
+        if (is_num(rhs, 0)) {
+            num_simplified++;
+            return lhs;
+        }
+        // (x + c1) + c2 => x + (c1 + c2)
+        if (rhs->kind == ND_NUM && lhs->kind == ND_ADD &&
+            lhs->rhs->kind == ND_NUM &&
+            fits_int((long)lhs->rhs->val + rhs->val)) {
+            num_simplified++;
+            rhs->val += lhs->rhs->val;
+            node->lhs = lhs->lhs;
+            return fold_binary(node);
+        }
+        break;
+    case ND_MUL:
+        if (is_num(rhs, 1)) {
+            num_simplified++;
+            return lhs;
+        }
+        if (is_num(rhs, 0) && !has_side_effects(lhs)) {
+            num_simplified++;
+            return to_num(node, 0);
+        }
+        if (is_num(rhs, -1)) {
+            num_simplified++;
+            return fold_expr(new_neg(lhs));
+        }
+        break;
+    case ND_DIV:
+        if (is_num(rhs, 1)) {
+            num_simplified++;
+            return lhs;
+        }
+        break;
+    case ND_MOD:
+        if (is_num(rhs, 1) && !has_side_effects(lhs)) {
+            num_simplified++;
+            return to_num(node, 0);
+        }
+        break;
+    default:
+        break;
+    }
+    return node;
+}
+
+static Node *fold_expr(Node *node) {
+    switch (node->kind) {
+    case ND_NUM:
+    case ND_LVAR:
+    case ND_STRING:
+        return node;
+
+    case ND_NEG:
+        node->lhs = fold_expr(node->lhs);
+        if (node->lhs->kind == ND_NUM && fits_int(-(long)node->lhs->val)) {
+            num_folded++;
+            return to_num(node, -node->lhs->val);
+        }
+        if (node->lhs->kind == ND_NEG) {
+            num_simplified++;
+            return node->lhs->lhs;
+        }
+        return node;
+
+    case ND_ASSIGN:
+        node->lhs = fold_expr(node->lhs);
+        node->rhs = fold_expr(node->rhs);
+        // x = x
+        if (node->lhs->kind == ND_LVAR && node->rhs->kind == ND_LVAR &&
+            node->lhs->offset == node->rhs->offset) {
+            num_simplified++;
+            return node->rhs;
+        }
+        return node;
+
+    case ND_ADDR:
+        node->lhs = fold_expr(node->lhs);
+        // &*p => p
+        if (node->lhs->kind == ND_DEREF) {
+            num_simplified++;
+            return node->lhs->lhs;
+        }
+        return node;
+
+    case ND_DEREF:
+        node->lhs = fold_expr(node->lhs);
+        // *&x => x
+        if (node->lhs->kind == ND_ADDR) {
+            num_simplified++;
+            return node->lhs->lhs;
+        }
+        return node;
+
+    case ND_FUNCALL:
+        for (int i = 0; i < node->num_args; i++)
+            node->args[i] = fold_expr(node->args[i]);
+        return node;
+
+    case ND_SIZEOF:
+        num_folded++;
+        return to_num(node, node->val);
+
+    default:
+        break;
+    }
+
+    if (node->lhs && node->rhs)
+        return fold_binary(node);
+    return node;
+}
+
+static Node *fold_stmt(Node *node);
+
+static int is_expr_stmt(Node *node) {
+    switch (node->kind) {
+    case ND_RETURN:
+    case ND_IF:
+    case ND_WHILE:
+    case ND_FOR:
+    case ND_BLOCK:
+        return 0;
+    default:
+        return 1;
+    }
+}
+
+static int is_empty_block(Node *node) {
+    return node->kind == ND_BLOCK && node->num_stmts == 0;
+}
+
+// Fold a statement list in place, dropping statements that do nothing
+static int fold_stmts(Node **stmts, int num_stmts) {
+    int n = 0;
+    for (int i = 0; i < num_stmts; i++) {
+        Node *stmt = fold_stmt(stmts[i]);
+        if (is_empty_block(stmt) ||
+            (is_expr_stmt(stmt) && !has_side_effects(stmt))) {
+            num_removed++;
+            continue;
+        }
+        stmts[n++] = stmt;
+    }
+    return n;
+}
+
+static Node *empty_block() {
+    return new_node(ND_BLOCK);
+}
+
+static Node *fold_stmt(Node *node) {
+    switch (node->kind) {
+    case ND_RETURN:
+        node->lhs = fold_expr(node->lhs);
+        return node;
+
+    case ND_IF:
+        node->cond = fold_expr(node->cond);
+        node->then = fold_stmt(node->then);
+        if (node->els)
+            node->els = fold_stmt(node->els);
+        if (node->cond->kind == ND_NUM) {
+            num_removed++;
+            if (node->cond->val)
+                return node->then;
+            return node->els ? node->els : empty_block();
+        }
+        return node;
+
+    case ND_WHILE:
+    case ND_FOR:
+        if (node->init)
+            node->init = fold_expr(node->init);
+        if (node->cond)
+            node->cond = fold_expr(node->cond);
+        if (node->inc)
+            node->inc = fold_expr(node->inc);
+        node->then = fold_stmt(node->then);
+        if (node->cond && node->cond->kind == ND_NUM) {
+            if (!node->cond->val) {
+                num_removed++;
+                return node->init ? node->init : empty_block();
+            }
+            node->cond = NULL;
+        }
+        return node;
+
+    case ND_BLOCK:
+        node->num_stmts = fold_stmts(node->stmts, node->num_stmts);
+        return node;
+
+    default:
+        return fold_expr(node);
+    }
+}
+
+static int count_nodes(Node *node) {
+    if (!node)
+        return 0;
+    int n = 1;
+    n += count_nodes(node->lhs);
+    n += count_nodes(node->rhs);
+    n += count_nodes(node->cond);
+    n += count_nodes(node->then);
+    n += count_nodes(node->els);
+    n += count_nodes(node->init);
+    n += count_nodes(node->inc);
+    for (int i = 0; i < node->num_stmts; i++)
+        n += count_nodes(node->stmts[i]);
+    for (int i = 0; i < node->num_args; i++)
+        n += count_nodes(node->args[i]);
+    return n;
+}
+
+static int count_prog_nodes(Function *prog) {
+    int n = 0;
+    for (Function *fn = prog; fn; fn = fn->next)
+        for (int i = 0; i < fn->num_stmts; i++)
+            n += count_nodes(fn->stmts[i]);
+    return n;
+}
+
+// Fold and simplify every function of the program
+void fold(Function *prog) {
+    int before = opt_report ? count_prog_nodes(prog) : 0;
+    num_folded = 0;
+    num_simplified = 0;
+    num_removed = 0;
+
+    for (Function *fn = prog; fn; fn = fn->next)
+        fn->num_stmts = fold_stmts(fn->stmts, fn->num_stmts);
+
+    if (opt_report) {
+        int after = count_prog_nodes(prog);
+        fprintf(stderr, "fold: %d nodes eliminated (%d -> %d); "
+                "%d constants folded, %d identities applied, "
+                "%d statements removed\n",
+                before - after, before, after,
+                num_folded, num_simplified, num_removed);
+    }
+}
@@ -0,0 +1,330 @@
+#include "compiler.h"
+#include <errno.h>
+#include <stdint.h>
+#include <unistd.h>
+
+// Function-level incremental compilation (--incremental, with --cache).
+//
+// Labels and string literals are numbered per function, so the assembly
+// of a function depends only on its own tokens and the options. An
+// incremental compile tokenizes the whole file and splits the tokens into
+// top-level functions by matching braces, without parsing. A function's
+// fingerprint is the cache key of its text, from its first token to its
+// last. One cache entry per input file and options holds the code of
+// every function of the last compile; functions whose fingerprint is in
+// it reuse their code, and only the others are parsed, folded and
+// generated. The output is the same as that of a full compile.
+//
+// With inlining, a function's code also depends on the functions it
+// calls. Its fingerprint then covers their text as well, and the functions
+// called by a changed one are parsed too, so that the inliner has their
+// bodies, although their own code is still reused. Only leaf functions
+// are inlined, so the callees' own callees do not matter.
+//
+// The entry is a sequence of records: a fingerprint (FP_LEN hex digits),
+// the length of the function's code as an int64, and the code.
+
+#define FP_LEN (CACHE_KEY_SIZE - 1)
+
+// Tokens of one top-level function
+typedef struct FuncRange {
+    int start;
+    int end;    // One past the closing brace
+    int name;   // Interned name of its first identifier, or -1
+    int parse;  // Whether its AST is needed
+    char text_fp[CACHE_KEY_SIZE];  // Cache key of its own text
+    char fp[CACHE_KEY_SIZE];
+} FuncRange;
+
+// Code of a function in the entry of the last compile
+typedef struct Prior {
+    char *fp;
+    char *code;
+    long len;
+} Prior;
+
+// Buffers of the current incremental compile. They are freed at the end,
+// or at the start of the next one after an error.
+typedef struct State {
+    FuncRange *ranges;
+    int *by_name;       // Index + 1 of the range of each name, by hash
+    int by_name_size;
+    char *entry;        // Entry of the last compile
+    Prior *table;       // Its functions, by fingerprint
+    int table_size;
+    char *out;          // Entry of this compile
+    long out_len;
+    long out_cap;
+} State;
+
+static _Thread_local State state;
+
+static void release() {
+    free(state.ranges);
+    free(state.by_name);
+    free(state.entry);
+    free(state.table);
+    free(state.out);
+    state = (State){0};
+}
+
+// Split the tokens into top-level functions. Returns the number of
+// functions, or -1 if the braces do not match.
+static int split() {
+    int n = 0, capacity = 0;
+    for (int t = 0; tokens.kind[t] != TK_EOF;) {
+        int start = t;
+        while (tokens.kind[t] != TK_LBRACE)
+            if (tokens.kind[t++] == TK_EOF)
+                return -1;
+        int depth = 0;
+        do {
+            if (tokens.kind[t] == TK_LBRACE)
+                depth++;
+            else if (tokens.kind[t] == TK_RBRACE)
+                depth--;
+            else if (tokens.kind[t] == TK_EOF)
+                return -1;
+            t++;
+        } while (depth);
+
+        if (n == capacity) {
+            capacity = capacity ? capacity * 2 : 256;
+            state.ranges = realloc(state.ranges, capacity * sizeof(FuncRange));
+            if (!state.ranges)
+                error("Out of memory");
+        }
+        state.ranges[n++] = (FuncRange){start, t, -1};
+    }
+    return n;
+}
+
+static unsigned name_hash(int name) {
+    return name * 2654435761u;
+}
+
+// Index the ranges by the name of their function
+static void index_names(int n) {
+    state.by_name_size = 16;
+    while (state.by_name_size < 2 * n)
+        state.by_name_size *= 2;
+    state.by_name = calloc(state.by_name_size, sizeof(int));
+    if (!state.by_name)
+        error("Out of memory");
+    int mask = state.by_name_size - 1;
+    for (int i = 0; i < n; i++) {
+        FuncRange *r = &state.ranges[i];
+        for (int t = r->start; t < r->end && r->name < 0; t++)
+            if (tokens.kind[t] == TK_IDENT)
+                r->name = tokens.val[t];
+        if (r->name < 0)
+            continue;
+        int j = name_hash(r->name) & mask;
+        while (state.by_name[j] && state.ranges[state.by_name[j] - 1].name != r->name)
+            j = (j + 1) & mask;
+        if (!state.by_name[j])
+            state.by_name[j] = i + 1;
+    }
+}
+
+// Range of the function called at token t, or NULL if t does not call a
+// function of the file
+static FuncRange *callee_at(int t) {
+    if (tokens.kind[t] != TK_IDENT || tokens.kind[t + 1] != TK_LPAREN)
+        return NULL;
+    int mask = state.by_name_size - 1;
+    for (int j = name_hash(tokens.val[t]) & mask; state.by_name[j]; j = (j + 1) & mask)
+        if (state.ranges[state.by_name[j] - 1].name == tokens.val[t])
+            return &state.ranges[state.by_name[j] - 1];
+    return NULL;
+}
+
+static uint64_t fp_hash(char *fp) {
+    uint64_t h = 0;
+    for (int i = 0; i < 16; i++)
+        h = (h << 4) | (fp[i] <= '9' ? fp[i] - '0' : fp[i] - 'a' + 10);
+    return h;
+}
+
+static Prior *lookup(char *fp) {
+    if (!state.table_size)
+        return NULL;
+    int mask = state.table_size - 1;
+    for (int i = fp_hash(fp) & mask; state.table[i].fp; i = (i + 1) & mask)
+        if (!memcmp(state.table[i].fp, fp, FP_LEN))
+            return &state.table[i];
+    return NULL;
+}
+
+// Index the functions of the last compile's entry. A damaged entry is
+// used only up to the damage.
+static void load_prior(char *entry, long len) {
+    int n = 0;
+    for (long pos = 0; pos + FP_LEN + 8 <= len; n++) {
+        int64_t code_len;
+        memcpy(&code_len, entry + pos + FP_LEN, 8);
+        pos += FP_LEN + 8 + code_len;
+    }
+    state.table_size = 16;
+    while (state.table_size < 2 * n)
+        state.table_size *= 2;
+    state.table = calloc(state.table_size, sizeof(Prior));
+    if (!state.table)
+        error("Out of memory");
+
+    int mask = state.table_size - 1;
+    for (long pos = 0; pos + FP_LEN + 8 <= len;) {
+        char *fp = entry + pos;
+        int64_t code_len;
+        memcpy(&code_len, fp + FP_LEN, 8);
+        pos += FP_LEN + 8;
+        if (code_len < 0 || code_len > len - pos)
+            return;
+        if (!lookup(fp)) {
+            int i = fp_hash(fp) & mask;
+            while (state.table[i].fp)
+                i = (i + 1) & mask;
+            state.table[i] = (Prior){fp, entry + pos, code_len};
+        }
+        pos += code_len;
+    }
+}
+
+static void append(void *data, long len) {
+    if (state.out_len + len > state.out_cap) {
+        state.out_cap = state.out_cap ? state.out_cap : 1 << 20;
+        while (state.out_len + len > state.out_cap)
+            state.out_cap *= 2;
+        state.out = realloc(state.out, state.out_cap);
+        if (!state.out)
+            error("Out of memory");
+    }
+    memcpy(state.out + state.out_len, data, len);
+    state.out_len += len;
+}
+
+// Add the code of function i to this compile's entry (see emit_record())
+static void record(void *arg, int i, char *code, long len) {
+    int64_t code_len = len;
+    append(state.ranges[i].fp, FP_LEN);
+    append(&code_len, 8);
+    append(code, len);
+}
+
+// Name of the function in range r: its first identifier
+static char *range_name(FuncRange *r) {
+    for (int t = r->start; t < r->end; t++)
+        if (tokens.kind[t] == TK_IDENT)
+            return name_str(tokens.val[t]);
+    return "";
+}
+
+// Compile user_input, the contents of path, to assembly in output. The
+// code of functions unchanged since the last incremental compile of path
+// with the same options is reused.
+void incremental(char *path, char *options, char *output) {
+    release();
+    tokenize(user_input);
+    int n = split();
+    if (n < 0) {
+        // Not a list of functions; the parser reports why
+        program();
+        error("Unbalanced braces");
+    }
+
+    // Fingerprint each function, with the text of its callees if they
+    // may be inlined
+    for (int i = 0; i < n; i++) {
+        FuncRange *r = &state.ranges[i];
+        char *first = tok_str(r->start);
+        char *last = tok_str(r->end - 1) + tokens.len[r->end - 1];
+        cache_key(options, first, last - first, r->text_fp);
+        memcpy(r->fp, r->text_fp, CACHE_KEY_SIZE);
+    }
+    if (opt_inline_threshold) {
+        index_names(n);
+        for (int i = 0; i < n; i++) {
+            FuncRange *r = &state.ranges[i];
+            for (int t = r->start; t < r->end; t++) {
+                FuncRange *callee = callee_at(t);
+                if (!callee || callee == r)
+                    continue;
+                char fp[CACHE_KEY_SIZE];
+                cache_key(r->fp, callee->text_fp, FP_LEN, fp);
+                memcpy(r->fp, fp, CACHE_KEY_SIZE);
+            }
+        }
+    }
+
+    // Load the code of the last compile
+    char entry_options[256];
+    snprintf(entry_options, sizeof(entry_options), "functions %s", options);
+    char key[CACHE_KEY_SIZE];
+    cache_key(entry_options, path, strlen(path), key);
+    long entry_len;
+    state.entry = cache_read(key, &entry_len);
+    if (state.entry)
+        load_prior(state.entry, entry_len);
+
+    // Parse only the functions that changed and the ones they call
+    for (int i = 0; i < n; i++) {
+        FuncRange *r = &state.ranges[i];
+        if (lookup(r->fp))
+            continue;
+        r->parse = 1;
+        for (int t = r->start; opt_inline_threshold && t < r->end; t++) {
+            FuncRange *callee = callee_at(t);
+            if (callee)
+                callee->parse = 1;
+        }
+    }
+    Function head = {0};
+    Function *cur = &head;
+    int reused = 0;
+    for (int i = 0; i < n; i++) {
+        FuncRange *r = &state.ranges[i];
+        Prior *prior = lookup(r->fp);
+        Function *fn;
+        if (r->parse) {
+            tok = r->start;
+            fn = function();
+        } else {
+            fn = arena_alloc(&node_arena, sizeof(Function));
+            fn->name = range_name(r);
+        }
+        if (prior) {
+            fn->code = prior->code;
+            fn->code_len = prior->len;
+            reused++;
+        }
+        cur = cur->next = fn;
+    }
+    Function *prog = head.next;
+    if (opt_fold)
+        fold(prog);
+    if (opt_inline_threshold)
+        inline_functions(prog);
+
+    // Generate, keeping the code of every function for the next compile
+    emit_open(output, OUT_ASM);
+    emit_record(record, NULL);
+    if (opt_ir)
+        codegen_ir(gen_ir(prog));
+    else
+        codegen(prog);
+    emit_record(NULL, NULL);
+    emit_close();
+
+    char *temp = cache_temp_path(key);
+    FILE *fp = fopen(temp, "w");
+    if (!fp)
+        error("Cannot open %s: %s", temp, strerror(errno));
+    int ok = fwrite(state.out, 1, state.out_len, fp) == state.out_len;
+    if (fclose(fp) || !ok)
+        unlink(temp);
+    else
+        cache_store(key, temp);
+    free(temp);
+    cache_count_functions(reused, n - reused);
+    release();
+}
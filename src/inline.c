@@ -0,0 +1,210 @@
+#include "compiler.h"
+
+// Inlining of small leaf functions into their callers, over the AST.
+//
+// Runs after folding. A call to a function defined in the same file is
+// replaced by a copy of the callee's body when the callee is a leaf (it
+// calls nothing, so it cannot be recursive), has no string literals, which
+// are numbered per function, takes the call's arguments in registers and
+// has at most opt_inline_threshold nodes. The copy's locals and parameters
+// move to fresh slots at the bottom of the caller's frame. The ND_INLINE
+// node that replaces the call assigns the arguments to the parameters,
+// right to left as a call evaluates them, and runs the body. Its return
+// statements end the inlined body rather than the caller, with the value
+// in rax, or in the slot at the node's offset for the IR.
+
+// A function of the program, by name
+typedef struct Callee {
+    char *name;       // Interned, so names compare by address
+    Function *fn;
+    int ok;           // Whether its body can be inlined; -1 until known
+} Callee;
+
+// State of the current inlining pass
+static _Thread_local Callee *table;
+static _Thread_local int table_size;
+static _Thread_local int num_inlined;
+static _Thread_local char **sites;     // Callees inlined into the current function
+static _Thread_local int num_sites;
+static _Thread_local int cap_sites;
+
+// Names are packed together in their arena, so the address bits are mixed
+static unsigned long name_hash(char *name) {
+    return ((unsigned long)name * 0x9e3779b97f4a7c15UL) >> 32;
+}
+
+static Callee *lookup(char *name) {
+    int mask = table_size - 1;
+    for (int i = name_hash(name) & mask; table[i].name; i = (i + 1) & mask)
+        if (table[i].name == name)
+            return &table[i];
+    return NULL;
+}
+
+// Count the nodes under node into *size; returns 0 if the count passes
+// the threshold or node is a string literal
+static int count_body(Node *node, int *size) {
+    if (!node)
+        return 1;
+    if (node->kind == ND_STRING)
+        return 0;
+    if (++*size > opt_inline_threshold)
+        return 0;
+    Node *kids[] = {node->lhs, node->rhs, node->cond, node->then, node->els,
+                    node->init, node->inc};
+    for (int i = 0; i < 7; i++)
+        if (!count_body(kids[i], size))
+            return 0;
+    for (int i = 0; i < node->num_stmts; i++)
+        if (!count_body(node->stmts[i], size))
+            return 0;
+    return 1;
+}
+
+// Whether fn can be inlined. Leaves are told by the calls the parser
+// counted, since calls inlined into fn do not leave ND_FUNCALL nodes.
+// Bodiless functions are left out; that includes those whose code an
+// incremental compile reuses.
+static int can_inline(Function *fn) {
+    if (fn->num_stmts == 0 || fn->num_calls || fn->num_params > 6)
+        return 0;
+    int size = 0;
+    for (int i = 0; i < fn->num_stmts; i++)
+        if (!count_body(fn->stmts[i], &size))
+            return 0;
+    return 1;
+}
+
+// Copy of a callee subtree with its locals moved down by base bytes
+static Node *copy(Node *node, int base) {
+    if (!node)
+        return NULL;
+    Node *c = new_node(node->kind);
+    *c = *node;
+    if (c->kind == ND_LVAR)
+        c->offset += base;
+    c->lhs = copy(node->lhs, base);
+    c->rhs = copy(node->rhs, base);
+    c->cond = copy(node->cond, base);
+    c->then = copy(node->then, base);
+    c->els = copy(node->els, base);
+    c->init = copy(node->init, base);
+    c->inc = copy(node->inc, base);
+    if (node->num_stmts) {
+        c->stmts = arena_alloc(&node_arena, node->num_stmts * sizeof(Node*));
+        for (int i = 0; i < node->num_stmts; i++)
+            c->stmts[i] = copy(node->stmts[i], base);
+    }
+    return c;
+}
+
+// Replace the call node to callee in caller with an ND_INLINE node
+static Node *expand(Function *caller, Node *call, Function *callee) {
+    int base = caller->stack_size;
+    caller->stack_size += callee->stack_size + 8;
+
+    Node *node = new_node(ND_INLINE);
+    node->funcname = callee->name;
+    node->offset = caller->stack_size;
+    node->num_stmts = call->num_args + callee->num_stmts;
+    node->stmts = arena_alloc(&node_arena, node->num_stmts * sizeof(Node*));
+    for (int i = 0; i < call->num_args; i++) {
+        Node *assign = new_node(ND_ASSIGN);
+        assign->lhs = copy(callee->params[i], base);
+        assign->rhs = call->args[i];
+        node->stmts[call->num_args - 1 - i] = assign;
+    }
+    for (int i = 0; i < callee->num_stmts; i++)
+        node->stmts[call->num_args + i] = copy(callee->stmts[i], base);
+    return node;
+}
+
+// Inline the calls under node; returns its replacement
+static Node *inline_node(Function *caller, Node *node) {
+    if (!node)
+        return NULL;
+    node->lhs = inline_node(caller, node->lhs);
+    node->rhs = inline_node(caller, node->rhs);
+    node->init = inline_node(caller, node->init);
+    node->cond = inline_node(caller, node->cond);
+    node->inc = inline_node(caller, node->inc);
+    node->then = inline_node(caller, node->then);
+    node->els = inline_node(caller, node->els);
+    for (int i = 0; i < node->num_stmts; i++)
+        node->stmts[i] = inline_node(caller, node->stmts[i]);
+    if (node->kind != ND_FUNCALL)
+        return node;
+    for (int i = 0; i < node->num_args; i++)
+        node->args[i] = inline_node(caller, node->args[i]);
+
+    Callee *callee = lookup(node->funcname);
+    if (!callee)
+        return node;
+    if (callee->ok < 0)
+        callee->ok = can_inline(callee->fn);
+    if (!callee->ok || node->num_args != callee->fn->num_params)
+        return node;
+
+    if (opt_report) {
+        if (num_sites == cap_sites) {
+            cap_sites = cap_sites ? cap_sites * 2 : 8;
+            sites = realloc(sites, cap_sites * sizeof(char*));
+        }
+        sites[num_sites++] = callee->name;
+    }
+    num_inlined++;
+    return expand(caller, node, callee->fn);
+}
+
+// Inline small leaf functions at their call sites in every function of
+// the program. Functions whose code is reused are left alone.
+void inline_functions(Function *prog) {
+    int n = 0, calls = 0;
+    for (Function *fn = prog; fn; fn = fn->next) {
+        n++;
+        calls += fn->num_calls;
+    }
+    if (!calls && !opt_report)
+        return;
+    table_size = 16;
+    while (table_size < 2 * n)
+        table_size *= 2;
+    table = calloc(table_size, sizeof(Callee));
+    if (!table)
+        error("Out of memory");
+    for (Function *fn = prog; fn; fn = fn->next) {
+        if (lookup(fn->name))
+            continue;
+        int i = name_hash(fn->name) & (table_size - 1);
+        while (table[i].name)
+            i = (i + 1) & (table_size - 1);
+        table[i] = (Callee){fn->name, fn, -1};
+    }
+
+    // With --opt-report, the inlined call sites of each function are
+    // listed by callee in the order they appear
+    num_inlined = 0;
+    int num_callers = 0;
+    for (Function *fn = prog; fn; fn = fn->next) {
+        if (fn->code || !fn->num_calls)
+            continue;
+        num_sites = 0;
+        for (int i = 0; i < fn->num_stmts; i++)
+            fn->stmts[i] = inline_node(fn, fn->stmts[i]);
+        if (!num_sites)
+            continue;
+        num_callers++;
+        fprintf(stderr, "inline: into %s:", fn->name);
+        for (int i = 0; i < num_sites; i++)
+            fprintf(stderr, "%s %s", i ? "," : "", sites[i]);
+        fprintf(stderr, "\n");
+    }
+    if (opt_report)
+        fprintf(stderr, "inline: %d call sites inlined into %d functions (threshold %d nodes)\n",
+                num_inlined, num_callers, opt_inline_threshold);
+    free(sites);
+    sites = NULL;
+    cap_sites = 0;
+    free(table);
+    table = NULL;
+}
@@ -0,0 +1,103 @@
+#include "compiler.h"
+
+// String interner for identifiers.
+//
+// Every distinct identifier is stored once, NUL-terminated, in the names
+// arena and given a small integer ID. Equal names have equal IDs and equal
+// pointers, so the rest of the compiler compares names without memcmp.
+// IDs start at 1; 0 means "no name".
+//
+// The index is an open-addressing hash table of IDs with linear probing,
+// doubled when half full.
+
+// One interner per thread, like the names arena
+static _Thread_local char **names;    // ID -> string
+static _Thread_local int *lens;       // ID -> length
+static _Thread_local unsigned *hashes;// ID -> hash, so growing the table needs no rehash
+static _Thread_local int num_names;   // Highest ID in use
+static _Thread_local int names_capacity;
+
+static _Thread_local int *table;      // Hash slot -> ID, or 0 if free
+static _Thread_local int table_capacity;
+
+// FNV-1a hash of a byte string
+static unsigned hash_bytes(char *s, int len) {
+    unsigned hash = 2166136261u;
+    for (int i = 0; i < len; i++)
+        hash = (hash ^ (unsigned char)s[i]) * 16777619u;
+    return hash;
+}
+
+static void *grow_array(void *arr, int capacity, size_t elem_size) {
+    arr = realloc(arr, capacity * elem_size);
+    if (!arr)
+        error("Out of memory");
+    return arr;
+}
+
+static void grow_table() {
+    free(table);
+    table_capacity = table_capacity ? table_capacity * 2 : 1024;
+    table = calloc(table_capacity, sizeof(int));
+    if (!table)
+        error("Out of memory");
+
+    unsigned mask = table_capacity - 1;
+    for (int id = 1; id <= num_names; id++) {
+        unsigned i = hashes[id] & mask;
+        while (table[i])
+            i = (i + 1) & mask;
+        table[i] = id;
+    }
+}
+
+// ID of the string s[0..len), adding it if it is new
+int intern(char *s, int len) {
+    if (2 * (num_names + 1) > table_capacity)
+        grow_table();
+
+    unsigned hash = hash_bytes(s, len);
+    unsigned mask = table_capacity - 1;
+    unsigned i = hash & mask;
+    for (; table[i]; i = (i + 1) & mask) {
+        int id = table[i];
+        if (hashes[id] == hash && lens[id] == len && !memcmp(names[id], s, len))
+            return id;
+    }
+
+    int id = ++num_names;
+    if (id >= names_capacity) {
+        names_capacity = names_capacity ? names_capacity * 2 : 1024;
+        names = grow_array(names, names_capacity, sizeof(char*));
+        lens = grow_array(lens, names_capacity, sizeof(int));
+        hashes = grow_array(hashes, names_capacity, sizeof(unsigned));
+    }
+    names[id] = arena_strndup(&name_arena, s, len);
+    lens[id] = len;
+    hashes[id] = hash;
+    table[i] = id;
+    return id;
+}
+
+// Interned string of an ID
+char *name_str(int id) {
+    return names[id];
+}
+
+// Length of an interned string
+int name_len(int id) {
+    return lens[id];
+}
+
+// Forget all names, before the names arena is released
+void intern_reset() {
+    free(names);
+    free(lens);
+    free(hashes);
+    free(table);
+    names = NULL;
+    lens = NULL;
+    hashes = NULL;
+    table = NULL;
+    num_names = names_capacity = table_capacity = 0;
+}
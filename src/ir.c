@@ -0,0 +1,516 @@
+#include "compiler.h"
+
+// Translation of the AST into a linear three-address IR.
+//
+// Each function becomes a list of basic blocks holding instructions over
+// an unbounded set of virtual registers. Locals stay in their stack slots
+// and are accessed with IR_LOADVAR/IR_STOREVAR. Every block ends in exactly
+// one terminator, from which the CFG edges are derived.
+
+static _Thread_local IrFunc *cur_fn;
+static _Thread_local BasicBlock *cur_bb;
+static _Thread_local BasicBlock *last_bb;
+
+// Inlined body being translated: its return statements store their value
+// into the slot at inline_result and jump to inline_end
+static _Thread_local BasicBlock *inline_end;
+static _Thread_local int inline_result;
+
+static BasicBlock *new_bb() {
+    BasicBlock *bb = arena_alloc(&ir_arena, sizeof(BasicBlock));
+    bb->id = cur_fn->num_blocks++;
+    return bb;
+}
+
+// Append a block to the layout and make it current
+static void start_bb(BasicBlock *bb) {
+    if (last_bb)
+        last_bb->next = bb;
+    else
+        cur_fn->blocks = bb;
+    last_bb = bb;
+    cur_bb = bb;
+}
+
+static int new_vreg() {
+    return cur_fn->num_vregs++;
+}
+
+static IrInsn *emit(IrOp op, int dst, int a, int b) {
+    IrInsn *insn = arena_alloc(&ir_arena, sizeof(IrInsn));
+    insn->op = op;
+    insn->dst = dst;
+    insn->a = a;
+    insn->b = b;
+    if (cur_bb->last)
+        cur_bb->last->next = insn;
+    else
+        cur_bb->first = insn;
+    cur_bb->last = insn;
+    return insn;
+}
+
+static int emit_imm(int val) {
+    int dst = new_vreg();
+    emit(IR_IMM, dst, -1, -1)->imm = val;
+    return dst;
+}
+
+static void emit_jmp(BasicBlock *target) {
+    emit(IR_JMP, -1, -1, -1)->bb1 = target;
+}
+
+static void emit_br(int cond, BasicBlock *then, BasicBlock *els) {
+    IrInsn *insn = emit(IR_BR, -1, cond, -1);
+    insn->bb1 = then;
+    insn->bb2 = els;
+}
+
+static int is_terminated() {
+    if (!cur_bb->last)
+        return 0;
+    IrOp op = cur_bb->last->op;
+    return op == IR_JMP || op == IR_BR || op == IR_RET;
+}
+
+static int gen_expr(Node *node);
+static void gen_stmt(Node *node);
+
+// Compute the address of an lvalue
+static int gen_addr(Node *node) {
+    if (node->kind == ND_LVAR) {
+        int dst = new_vreg();
+        emit(IR_LVADDR, dst, -1, -1)->imm = node->offset;
+        return dst;
+    }
+    if (node->kind == ND_DEREF)
+        return gen_expr(node->lhs);
+    error("Not an lvalue");
+    return -1;
+}
+
+static IrOp binary_op(NodeKind kind) {
+    switch (kind) {
+    case ND_ADD: return IR_ADD;
+    case ND_SUB: return IR_SUB;
+    case ND_MUL: return IR_MUL;
+    case ND_DIV: return IR_DIV;
+    case ND_MOD: return IR_MOD;
+    case ND_EQ: return IR_EQ;
+    case ND_NE: return IR_NE;
+    case ND_LT: return IR_LT;
+    case ND_LE: return IR_LE;
+    default:
+        error("Unexpected node in expression: %d", kind);
+        return IR_IMM;
+    }
+}
+
+static int gen_expr(Node *node) {
+    switch (node->kind) {
+    case ND_NUM:
+    case ND_SIZEOF:
+        return emit_imm(node->val);
+
+    case ND_STRING: {
+        int dst = new_vreg();
+        emit(IR_STRADDR, dst, -1, -1)->imm = node->str_label;
+        return dst;
+    }
+
+    case ND_LVAR: {
+        int dst = new_vreg();
+        emit(IR_LOADVAR, dst, -1, -1)->imm = node->offset;
+        return dst;
+    }
+
+    case ND_ASSIGN: {
+        if (node->lhs->kind == ND_LVAR) {
+            int val = gen_expr(node->rhs);
+            emit(IR_STOREVAR, -1, val, -1)->imm = node->lhs->offset;
+            return val;
+        }
+        int addr = gen_addr(node->lhs);
+        int val = gen_expr(node->rhs);
+        emit(IR_STORE, -1, addr, val);
+        return val;
+    }
+
+    case ND_ADDR:
+        return gen_addr(node->lhs);
+
+    case ND_NEG: {
+        int val = gen_expr(node->lhs);
+        int dst = new_vreg();
+        emit(IR_NEG, dst, val, -1);
+        return dst;
+    }
+
+    case ND_DEREF: {
+        int addr = gen_expr(node->lhs);
+        int dst = new_vreg();
+        emit(IR_LOAD, dst, addr, -1);
+        return dst;
+    }
+
+    case ND_FUNCALL: {
+        // Arguments are evaluated right to left, as in the AST backend
+        int *args = arena_alloc(&ir_arena, (node->num_args + 1) * sizeof(int));
+        for (int i = node->num_args - 1; i >= 0; i--)
+            args[i] = gen_expr(node->args[i]);
+        int dst = new_vreg();
+        IrInsn *insn = emit(IR_CALL, dst, -1, -1);
+        insn->name = node->funcname;
+        insn->args = args;
+        insn->num_args = node->num_args;
+        return dst;
+    }
+
+    case ND_INLINE: {
+        BasicBlock *caller_end = inline_end;
+        int caller_result = inline_result;
+        inline_end = new_bb();
+        inline_result = node->offset;
+        for (int i = 0; i < node->num_stmts; i++)
+            gen_stmt(node->stmts[i]);
+        if (!is_terminated())
+            emit_jmp(inline_end);
+        start_bb(inline_end);
+        inline_end = caller_end;
+        inline_result = caller_result;
+        int dst = new_vreg();
+        emit(IR_LOADVAR, dst, -1, -1)->imm = node->offset;
+        return dst;
+    }
+
+    default:
+        break;
+    }
+
+    int a = gen_expr(node->lhs);
+    int b = gen_expr(node->rhs);
+    int dst = new_vreg();
+    emit(binary_op(node->kind), dst, a, b);
+    return dst;
+}
+
+static void gen_stmt(Node *node) {
+    switch (node->kind) {
+    case ND_RETURN: {
+        int val = gen_expr(node->lhs);
+        if (inline_end) {
+            emit(IR_STOREVAR, -1, val, -1)->imm = inline_result;
+            emit_jmp(inline_end);
+        } else {
+            emit(IR_RET, -1, val, -1);
+        }
+        // Code after a return goes into a fresh, unreachable block
+        start_bb(new_bb());
+        return;
+    }
+
+    case ND_IF: {
+        BasicBlock *then = new_bb();
+        BasicBlock *els = node->els ? new_bb() : NULL;
+        BasicBlock *join = new_bb();
+        int cond = gen_expr(node->cond);
+        emit_br(cond, then, els ? els : join);
+
+        start_bb(then);
+        gen_stmt(node->then);
+        if (!is_terminated())
+            emit_jmp(join);
+
+        if (els) {
+            start_bb(els);
+            gen_stmt(node->els);
+            if (!is_terminated())
+                emit_jmp(join);
+        }
+
+        start_bb(join);
+        return;
+    }
+
+    case ND_WHILE:
+    case ND_FOR: {
+        BasicBlock *head = new_bb();
+        BasicBlock *body = new_bb();
+        BasicBlock *exit = new_bb();
+
+        if (node->init)
+            gen_expr(node->init);
+        emit_jmp(head);
+
+        start_bb(head);
+        if (node->cond)
+            emit_br(gen_expr(node->cond), body, exit);
+        else
+            emit_jmp(body);
+
+        start_bb(body);
+        gen_stmt(node->then);
+        if (node->inc)
+            gen_expr(node->inc);
+        if (!is_terminated())
+            emit_jmp(head);
+
+        start_bb(exit);
+        return;
+    }
+
+    case ND_BLOCK:
+        for (int i = 0; i < node->num_stmts; i++)
+            gen_stmt(node->stmts[i]);
+        return;
+
+    default:
+        gen_expr(node);
+        return;
+    }
+}
+
+static void mark_reachable(BasicBlock *bb) {
+    if (bb->reachable)
+        return;
+    bb->reachable = 1;
+    for (int i = 0; i < bb->num_succs; i++)
+        mark_reachable(bb->succs[i]);
+}
+
+// Derive CFG edges from the terminators and drop unreachable blocks
+static void build_cfg(IrFunc *fn) {
+    for (BasicBlock *bb = fn->blocks; bb; bb = bb->next) {
+        IrInsn *term = bb->last;
+        bb->num_succs = 0;
+        if (term->op == IR_JMP || term->op == IR_BR)
+            bb->succs[bb->num_succs++] = term->bb1;
+        if (term->op == IR_BR && term->bb2 != term->bb1)
+            bb->succs[bb->num_succs++] = term->bb2;
+    }
+
+    mark_reachable(fn->blocks);
+
+    BasicBlock head = {0};
+    BasicBlock *cur = &head;
+    for (BasicBlock *bb = fn->blocks; bb; bb = bb->next) {
+        if (!bb->reachable)
+            continue;
+        cur->next = bb;
+        cur = bb;
+    }
+    cur->next = NULL;
+    fn->blocks = head.next;
+
+    // Count predecessors, then fill the exactly-sized arrays
+    for (BasicBlock *bb = fn->blocks; bb; bb = bb->next)
+        for (int i = 0; i < bb->num_succs; i++)
+            bb->succs[i]->num_preds++;
+    for (BasicBlock *bb = fn->blocks; bb; bb = bb->next) {
+        bb->preds = arena_alloc(&ir_arena, bb->num_preds * sizeof(BasicBlock*));
+        bb->num_preds = 0;
+    }
+    for (BasicBlock *bb = fn->blocks; bb; bb = bb->next)
+        for (int i = 0; i < bb->num_succs; i++)
+            bb->succs[i]->preds[bb->succs[i]->num_preds++] = bb;
+}
+
+static int has_side_effects(IrInsn *insn) {
+    switch (insn->op) {
+    case IR_IMM:
+    case IR_ADD:
+    case IR_SUB:
+    case IR_MUL:
+    case IR_NEG:
+    case IR_EQ:
+    case IR_NE:
+    case IR_LT:
+    case IR_LE:
+    case IR_LOADVAR:
+    case IR_LVADDR:
+    case IR_STRADDR:
+    case IR_LOAD:
+        return 0;
+    default:
+        return 1;
+    }
+}
+
+// Delete instructions whose result is never used
+static void remove_dead_insns(IrFunc *fn) {
+    char *used = calloc(fn->num_vregs, 1);
+    int changed = 1;
+
+    while (changed) {
+        changed = 0;
+        memset(used, 0, fn->num_vregs);
+        for (BasicBlock *bb = fn->blocks; bb; bb = bb->next) {
+            for (IrInsn *insn = bb->first; insn; insn = insn->next) {
+                if (insn->a >= 0)
+                    used[insn->a] = 1;
+                if (insn->b >= 0)
+                    used[insn->b] = 1;
+                for (int i = 0; i < insn->num_args; i++)
+                    used[insn->args[i]] = 1;
+            }
+        }
+
+        for (BasicBlock *bb = fn->blocks; bb; bb = bb->next) {
+            IrInsn head = {0};
+            head.next = bb->first;
+            IrInsn *prev = &head;
+            for (IrInsn *insn = bb->first; insn; insn = insn->next) {
+                if (insn->dst >= 0 && !used[insn->dst] && !has_side_effects(insn)) {
+                    prev->next = insn->next;
+                    changed = 1;
+                    continue;
+                }
+                prev = insn;
+            }
+            bb->first = head.next;
+            bb->last = prev;
+        }
+    }
+
+    free(used);
+}
+
+static IrFunc *gen_ir_func(Function *fn) {
+    cur_fn = arena_alloc(&ir_arena, sizeof(IrFunc));
+    cur_fn->fn = fn;
+    cur_fn->name = fn->name;
+    last_bb = NULL;
+    inline_end = NULL;
+    start_bb(new_bb());
+
+    for (int i = 0; i < fn->num_stmts; i++)
+        gen_stmt(fn->stmts[i]);
+
+    // Falling off the end returns 0
+    if (!is_terminated())
+        emit(IR_RET, -1, emit_imm(0), -1);
+
+    // Seal any block left open by a trailing return
+    for (BasicBlock *bb = cur_fn->blocks; bb; bb = bb->next) {
+        if (!bb->last) {
+            cur_bb = bb;
+            emit(IR_RET, -1, emit_imm(0), -1);
+        }
+    }
+
+    build_cfg(cur_fn);
+    remove_dead_insns(cur_fn);
+    return cur_fn;
+}
+
+// Translate every function of the program to IR
+IrFunc *gen_ir(Function *prog) {
+    IrFunc head = {0};
+    IrFunc *cur = &head;
+    for (Function *fn = prog; fn; fn = fn->next) {
+        cur->next = gen_ir_func(fn);
+        cur = cur->next;
+    }
+    return head.next;
+}
+
+static char *op_name(IrOp op) {
+    switch (op) {
+    case IR_IMM: return "imm";
+    case IR_ADD: return "add";
+    case IR_SUB: return "sub";
+    case IR_MUL: return "mul";
+    case IR_DIV: return "div";
+    case IR_MOD: return "mod";
+    case IR_NEG: return "neg";
+    case IR_EQ: return "eq";
+    case IR_NE: return "ne";
+    case IR_LT: return "lt";
+    case IR_LE: return "le";
+    case IR_LOADVAR: return "loadvar";
+    case IR_STOREVAR: return "storevar";
+    case IR_LVADDR: return "lvaddr";
+    case IR_STRADDR: return "straddr";
+    case IR_LOAD: return "load";
+    case IR_STORE: return "store";
+    case IR_CALL: return "call";
+    case IR_RET: return "ret";
+    case IR_JMP: return "jmp";
+    case IR_BR: return "br";
+    }
+    return "?";
+}
+
+static void dump_insn(IrInsn *insn) {
+    printf("  ");
+    if (insn->dst >= 0)
+        printf("v%d = ", insn->dst);
+    printf("%s", op_name(insn->op));
+
+    switch (insn->op) {
+    case IR_IMM:
+        printf(" %d", insn->imm);
+        break;
+    case IR_LOADVAR:
+    case IR_LVADDR:
+        printf(" [rbp-%d]", insn->imm);
+        break;
+    case IR_STOREVAR:
+        printf(" [rbp-%d], v%d", insn->imm, insn->a);
+        break;
+    case IR_STRADDR:
+        printf(" s%d", insn->imm);
+        break;
+    case IR_NEG:
+        printf(" v%d", insn->a);
+        break;
+    case IR_LOAD:
+        printf(" [v%d]", insn->a);
+        break;
+    case IR_STORE:
+        printf(" [v%d], v%d", insn->a, insn->b);
+        break;
+    case IR_CALL:
+        printf(" %s(", insn->name);
+        for (int i = 0; i < insn->num_args; i++)
+            printf("%sv%d", i ? ", " : "", insn->args[i]);
+        printf(")");
+        break;
+    case IR_RET:
+        printf(" v%d", insn->a);
+        break;
+    case IR_JMP:
+        printf(" bb%d", insn->bb1->id);
+        break;
+    case IR_BR:
+        printf(" v%d, bb%d, bb%d", insn->a, insn->bb1->id, insn->bb2->id);
+        break;
+    default:
+        printf(" v%d, v%d", insn->a, insn->b);
+        break;
+    }
+    printf("\n");
+}
+
+// Print the IR of every function (--dump-ir)
+void dump_ir(IrFunc *prog) {
+    for (IrFunc *fn = prog; fn; fn = fn->next) {
+        printf("func %s(", fn->name);
+        for (int i = 0; i < fn->fn->num_params; i++)
+            printf("%s[rbp-%d]", i ? ", " : "", fn->fn->params[i]->offset);
+        printf(") {\n");
+
+        for (BasicBlock *bb = fn->blocks; bb; bb = bb->next) {
+            printf("bb%d:", bb->id);
+            if (bb->num_preds) {
+                printf("  ; preds:");
+                for (int i = 0; i < bb->num_preds; i++)
+                    printf(" bb%d", bb->preds[i]->id);
+            }
+            printf("\n");
+            for (IrInsn *insn = bb->first; insn; insn = insn->next)
+                dump_insn(insn);
+        }
+        printf("}\n\n");
+    }
+}
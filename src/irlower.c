@@ -0,0 +1,213 @@
+#include "compiler.h"
+
+// Lowering of the IR to x86-64 assembly.
+//
+// Every virtual register gets an 8-byte stack slot below the locals, so
+// each instruction loads its operands into rax/rdi, computes, and stores
+// the result. The frame is kept 16-byte aligned and nothing is pushed in
+// the body, so calls need no runtime alignment check.
+
+// State of the function being lowered, one per code generation thread
+static _Thread_local int vreg_base;
+static _Thread_local int bb_label;      // Label of block 0; block n is bb_label + n
+static _Thread_local int return_label;
+
+static Reg arg_regs[] = {RDI, RSI, RDX, RCX, R8, R9};
+
+static int vreg_offset(int vreg) {
+    return vreg_base + vreg * 8 + 8;
+}
+
+static void load(Reg reg, int vreg) {
+    emit2(I_MOV, op_reg(reg), op_mem(RBP, -vreg_offset(vreg)));
+}
+
+static void store(int vreg) {
+    emit2(I_MOV, op_mem(RBP, -vreg_offset(vreg)), op_reg(RAX));
+}
+
+static Operand block(BasicBlock *bb) {
+    return op_label(bb_label + bb->id);
+}
+
+static void gen_cmp(Opcode setcc, IrInsn *insn) {
+    load(RAX, insn->a);
+    load(RDI, insn->b);
+    emit2(I_CMP, op_reg(RAX), op_reg(RDI));
+    emit1(setcc, op_reg(RAX));
+    emit2(I_MOVZB, op_reg(RAX), op_reg(RAX));
+    store(insn->dst);
+}
+
+// Jump taken when a comparison is false
+static Opcode false_jump(IrOp op) {
+    switch (op) {
+    case IR_EQ: return I_JNE;
+    case IR_NE: return I_JE;
+    case IR_LT: return I_JGE;
+    default: return I_JG;
+    }
+}
+
+static int is_compare_op(IrOp op) {
+    return op == IR_EQ || op == IR_NE || op == IR_LT || op == IR_LE;
+}
+
+// Lower a comparison and the branch on its result as cmp and jcc. Each
+// vreg is used once, so the 0/1 result is never needed elsewhere.
+static void gen_cmp_br(IrInsn *cmp, IrInsn *br, BasicBlock *next) {
+    load(RAX, cmp->a);
+    load(RDI, cmp->b);
+    emit2(I_CMP, op_reg(RAX), op_reg(RDI));
+    emit1(false_jump(cmp->op), block(br->bb2));
+    if (br->bb1 != next)
+        emit1(I_JMP, block(br->bb1));
+}
+
+static void gen_insn(IrInsn *insn, BasicBlock *next) {
+    switch (insn->op) {
+    case IR_IMM:
+        emit2(I_MOV, op_reg(RAX), op_imm(insn->imm));
+        store(insn->dst);
+        return;
+    case IR_ADD:
+    case IR_SUB:
+    case IR_MUL:
+        load(RAX, insn->a);
+        load(RDI, insn->b);
+        emit2(insn->op == IR_ADD ? I_ADD : insn->op == IR_SUB ? I_SUB : I_IMUL,
+              op_reg(RAX), op_reg(RDI));
+        store(insn->dst);
+        return;
+    case IR_DIV:
+    case IR_MOD:
+        load(RAX, insn->a);
+        load(RDI, insn->b);
+        emit0(I_CQO);
+        emit1(I_IDIV, op_reg(RDI));
+        if (insn->op == IR_MOD)
+            emit2(I_MOV, op_reg(RAX), op_reg(RDX));
+        store(insn->dst);
+        return;
+    case IR_NEG:
+        load(RAX, insn->a);
+        emit1(I_NEG, op_reg(RAX));
+        store(insn->dst);
+        return;
+    case IR_EQ:
+        gen_cmp(I_SETE, insn);
+        return;
+    case IR_NE:
+        gen_cmp(I_SETNE, insn);
+        return;
+    case IR_LT:
+        gen_cmp(I_SETL, insn);
+        return;
+    case IR_LE:
+        gen_cmp(I_SETLE, insn);
+        return;
+    case IR_LOADVAR:
+        emit2(I_MOV, op_reg(RAX), op_mem(RBP, -insn->imm));
+        store(insn->dst);
+        return;
+    case IR_STOREVAR:
+        load(RAX, insn->a);
+        emit2(I_MOV, op_mem(RBP, -insn->imm), op_reg(RAX));
+        return;
+    case IR_LVADDR:
+        emit2(I_LEA, op_reg(RAX), op_mem(RBP, -insn->imm));
+        store(insn->dst);
+        return;
+    case IR_STRADDR:
+        emit2(I_LEA, op_reg(RAX), op_str(insn->imm));
+        store(insn->dst);
+        return;
+    case IR_LOAD:
+        load(RAX, insn->a);
+        emit2(I_MOV, op_reg(RAX), op_mem(RAX, 0));
+        store(insn->dst);
+        return;
+    case IR_STORE:
+        load(RDI, insn->a);
+        load(RAX, insn->b);
+        emit2(I_MOV, op_mem(RDI, 0), op_reg(RAX));
+        return;
+    case IR_CALL:
+        for (int i = 0; i < insn->num_args && i < 6; i++)
+            load(arg_regs[i], insn->args[i]);
+        emit2(I_MOV, op_reg(RAX), op_imm(0));
+        emit1(I_CALL, op_sym(insn->name));
+        store(insn->dst);
+        return;
+    case IR_RET:
+        load(RAX, insn->a);
+        emit1(I_JMP, op_label(return_label));
+        return;
+    case IR_JMP:
+        if (insn->bb1 != next)
+            emit1(I_JMP, block(insn->bb1));
+        return;
+    case IR_BR:
+        load(RAX, insn->a);
+        emit2(I_TEST, op_reg(RAX), op_reg(RAX));
+        emit1(I_JE, block(insn->bb2));
+        if (insn->bb1 != next)
+            emit1(I_JMP, block(insn->bb1));
+        return;
+    }
+}
+
+static void gen_func(void *funcs, int i) {
+    IrFunc *fn = ((IrFunc **)funcs)[i];
+    if (fn->fn->code) {
+        emit_text(fn->fn->code, fn->fn->code_len);
+        return;
+    }
+    emit_func(fn->name);
+    vreg_base = fn->fn->stack_size;
+    bb_label = new_labels(fn->num_blocks);
+    return_label = new_label();
+    int frame = vreg_base + fn->num_vregs * 8;
+    frame = (frame + 15) / 16 * 16;
+
+    emit1(I_PUSH, op_reg(RBP));
+    emit2(I_MOV, op_reg(RBP), op_reg(RSP));
+    emit2(I_SUB, op_reg(RSP), op_imm(frame));
+
+    for (int i = 0; i < fn->fn->num_params && i < 6; i++)
+        emit2(I_MOV, op_mem(RBP, -fn->fn->params[i]->offset), op_reg(arg_regs[i]));
+
+    for (BasicBlock *bb = fn->blocks; bb; bb = bb->next) {
+        emit_label(bb_label + bb->id);
+        for (IrInsn *insn = bb->first; insn; insn = insn->next) {
+            IrInsn *br = insn->next;
+            if (is_compare_op(insn->op) && br && br->op == IR_BR && br->a == insn->dst) {
+                gen_cmp_br(insn, br, bb->next);
+                insn = br;
+                continue;
+            }
+            gen_insn(insn, bb->next);
+        }
+    }
+
+    emit_label(return_label);
+    emit2(I_MOV, op_reg(RSP), op_reg(RBP));
+    emit1(I_POP, op_reg(RBP));
+    emit0(I_RET);
+    gen_strings(fn->fn);
+}
+
+// Generate code for the whole program from its IR (--ir)
+void codegen_ir(IrFunc *prog) {
+    emit_directive(".intel_syntax noprefix");
+    emit_directive(".text");
+    int n = 0;
+    for (IrFunc *fn = prog; fn; fn = fn->next)
+        n++;
+    IrFunc **funcs = calloc(n, sizeof(IrFunc *));
+    n = 0;
+    for (IrFunc *fn = prog; fn; fn = fn->next)
+        funcs[n++] = fn;
+    emit_functions(n, gen_func, funcs);
+    free(funcs);
+}
@@ -1,35 +1,585 @@
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE  // MAP_ANONYMOUS
+
 #include "compiler.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
 
-int main(int argc, char **argv) {
-    if (argc != 2) {
-        fprintf(stderr, "Usage: %s <file>\n", argv[0]);
-        return 1;
+// Compiler driver.
+//
+// Every input file is compiled by a Compilation. One file is compiled on
+// the main thread, and -j N spreads its functions over N threads. Several
+// files are compiled N at a time (by default one per CPU), each on one
+// thread, in a single process, and each gets its own output: its base name
+// with .s, or .o with -c. The per-compilation state of the other modules
+// is thread-local, so concurrent compilations share only the options.
+//
+// With --server the process instead stays up and compiles requests from
+// --client processes (server.c).
+//
+// Input files are mapped into memory rather than read, and the tokens
+// point into the mapping. "-" reads standard input.
+
+int opt_regalloc = 1;
+int opt_ir = 0;
+int opt_fold = 1;
+int opt_peephole = 1;
+int opt_report = 0;
+int opt_jobs = 1;
+int opt_inline_threshold = INLINE_THRESHOLD;
+static int opt_arena_stats = 0;
+static int opt_dump_ir = 0;
+static int opt_object = 0;
+static int opt_run = 0;
+static int opt_stats = 0;   // STATS_TEXT or STATS_JSON with --stats
+static char *output;
+static int jobs;
+static char *server_path;
+static char *client_path;
+static char *cache_path;
+static long cache_limit;
+static int cache_stats;
+static int opt_incremental = 0;
+
+enum { STATS_TEXT = 1, STATS_JSON };
+
+// One input file and what became of it
+typedef struct Compilation {
+    char *path;
+    char *source;     // Contents, if already in memory
+    long mapped;      // Size of the mapping of the contents, 0 if on the heap
+    char *output;     // NULL for standard output
+    long (*entry)();  // main, loaded into memory by --run
+    int failed;
+} Compilation;
+
+static Compilation *inputs;
+static int num_inputs;
+static atomic_int next_input;
+
+// Keep arenas and interned names between compilations (--server)
+static int keep_warm;
+
+static void usage(char *prog) {
+    error("Usage: %s [--server <socket> | --client <socket>] [-c] [-o <output>] [--run] [-j <threads>] [--no-regalloc] [--no-fold] [--no-peephole] [--inline-threshold <nodes>] [--ir] [--dump-ir] [--opt-report] [--arena-stats] [--stats[=json] | -ftime-report] [--scanner=NAME] [--cache <dir>] [--cache-limit <size>] [--cache-stats] [--incremental] <file>...", prog);
+}
+
+// Default output of a file: its base name with the extension ext instead
+// of .c, like cc -c
+static char *output_path(char *path, char *ext) {
+    char *base = strrchr(path, '/');
+    base = base ? base + 1 : path;
+    int len = strlen(base);
+    if (len > 2 && !strcmp(base + len - 2, ".c"))
+        len -= 2;
+    char *out = malloc(len + strlen(ext) + 1);
+    if (!out)
+        error("Out of memory");
+    memcpy(out, base, len);
+    strcpy(out + len, ext);
+    return out;
+}
+
+// path made absolute against the working directory, for a process that
+// runs elsewhere. The path need not exist yet.
+static char *absolute_path(char *path) {
+    if (path[0] == '/')
+        return path;
+    char *cwd = getcwd(NULL, 0);
+    if (!cwd)
+        error("Cannot get the working directory");
+    char *abs = malloc(strlen(cwd) + strlen(path) + 2);
+    if (!abs)
+        error("Out of memory");
+    sprintf(abs, "%s/%s", cwd, path);
+    free(cwd);
+    return abs;
+}
+
+// Parse a size in bytes, with an optional K, M or G suffix
+static long parse_size(char *arg) {
+    char *end;
+    long size = strtol(arg, &end, 10);
+    switch (*end) {
+    case 'K': case 'k': size <<= 10; end++; break;
+    case 'M': case 'm': size <<= 20; end++; break;
+    case 'G': case 'g': size <<= 30; end++; break;
+    }
+    if (*end || size < 1)
+        error("Invalid size: %s", arg);
+    return size;
+}
+
+// Monotonic time in milliseconds
+static double now_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+// Read everything from fd into a NUL-terminated heap buffer, for pipes
+// and other inputs that cannot be mapped
+static char *read_stream(int fd) {
+    long len = 0, size = 64 * 1024;
+    char *buf = malloc(size);
+    for (;;) {
+        if (!buf)
+            error("Out of memory");
+        ssize_t n = read(fd, buf + len, size - len - 1);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0)
+            error("%s", strerror(errno));
+        if (n == 0)
+            break;
+        len += n;
+        if (len + 1 == size)
+            buf = realloc(buf, size *= 2);
+    }
+    buf[len] = '\0';
+    return buf;
+}
+
+// The contents of the input file path, NUL-terminated, without copying
+// them. The file is mapped read-only over the start of an anonymous
+// mapping that ends at least one byte after it, so the byte after the
+// file is zero: either the zero fill of the file's last page or the spare
+// anonymous page after it. Sets *mapped to the size to unmap, or to 0 if
+// the input was read into the heap instead.
+static char *read_source(char *path, long *mapped) {
+    *mapped = 0;
+    if (!strcmp(path, "-"))
+        return read_stream(0);
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        error("%s", strerror(errno));
+    struct stat st;
+    if (fstat(fd, &st) || !S_ISREG(st.st_mode) || st.st_size == 0) {
+        char *buf = read_stream(fd);
+        close(fd);
+        return buf;
     }
     
-    // Read input file
-    FILE *fp = fopen(argv[1], "r");
-    if (!fp) {
-        perror(argv[1]);
+    long page = sysconf(_SC_PAGESIZE);
+    long size = (st.st_size / page + 1) * page;
+    char *buf = mmap(NULL, size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buf == MAP_FAILED)
+        error("Cannot map: %s", strerror(errno));
+    if (mmap(buf, st.st_size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        munmap(buf, size);
+        error("Cannot map: %s", strerror(errno));
+    }
+    close(fd);
+    *mapped = size;
+    return buf;
+}
+
+// Compile user_input into c's output
+static void generate(Compilation *c) {
+    // Tokenize
+    tokenize(user_input);
+    stats_phase(PHASE_TOKENIZE);
+    
+    // Parse
+    Function *prog = program();
+    stats_phase(PHASE_PARSE);
+    stats_count(prog);
+    
+    // Optimize
+    if (opt_fold)
+        fold(prog);
+    if (opt_inline_threshold)
+        inline_functions(prog);
+    stats_phase(PHASE_FOLD);
+    
+    // Generate code, either directly from the AST or through the IR
+    IrFunc *ir = NULL;
+    if (opt_ir || opt_dump_ir) {
+        ir = gen_ir(prog);
+        stats_phase(PHASE_IR);
+    }
+    if (opt_dump_ir) {
+        dump_ir(ir);
+    } else {
+        OutputKind kind = opt_run ? OUT_MEMORY : opt_object ? OUT_OBJECT : OUT_ASM;
+        emit_open(c->output, kind);
+        if (opt_ir)
+            codegen_ir(ir);
+        else
+            codegen(prog);
+        emit_close();
+        if (opt_report && opt_peephole)
+            peephole_report();
+        if (opt_run)
+            c->entry = (long (*)())elf_load("main");
+    }
+    stats_phase(PHASE_CODEGEN);
+}
+
+// Whether the output of a compilation may come from the cache: it must be
+// a file or standard output, and nothing but the output may be expected
+static int cacheable() {
+    return cache_enabled() && !opt_run && !opt_dump_ir && !opt_report && !opt_arena_stats &&
+           !opt_stats;
+}
+
+// Copy the output of an identical earlier compilation from the cache, or
+// compile into a new cache entry and copy that
+static void generate_cached(Compilation *c) {
+    char options[96];
+    snprintf(options, sizeof(options), "regalloc=%d fold=%d peephole=%d inline=%d ir=%d object=%d",
+             opt_regalloc, opt_fold, opt_peephole, opt_inline_threshold, opt_ir, opt_object);
+    char key[CACHE_KEY_SIZE];
+    cache_key(options, user_input, strlen(user_input), key);
+    if (cache_fetch(key, c->output)) {
+        cache_count(1);
+        return;
+    }
+    cache_count(0);
+    
+    // On an error, compile() removes the temporary file
+    char *dest = c->output;
+    c->output = cache_temp_path(key);
+    if (opt_incremental && !opt_object)
+        incremental(c->path, options, c->output);
+    else
+        generate(c);
+    cache_store(key, c->output);
+    free(c->output);
+    c->output = dest;
+    if (!cache_fetch(key, dest))
+        error("Cache entry %s disappeared", key);
+}
+
+// Compile one file on the calling thread. An error abandons the file,
+// removes its partial output and marks it failed, and the thread moves on.
+static void compile(Compilation *c) {
+    jmp_buf on_error;
+    jmp_buf *outer = error_jmp;
+    input_path = strcmp(c->path, "-") ? c->path : "<stdin>";
+    error_jmp = &on_error;
+    if (setjmp(on_error)) {
+        emit_abort();
+        if (c->output)
+            unlink(c->output);
+        c->failed = 1;
+    } else {
+        if (opt_stats)
+            stats_start(num_inputs > 1);
+        user_input = c->source ? c->source : read_source(c->path, &c->mapped);
+        stats_phase(PHASE_READ);
+        if (cacheable())
+            generate_cached(c);
+        else
+            generate(c);
+        
+        if (opt_arena_stats) {
+            flockfile(stderr);
+            if (num_inputs > 1)
+                fprintf(stderr, "%s:\n", c->path);
+            arena_report();
+            funlockfile(stderr);
+        }
+        if (opt_stats) {
+            flockfile(stderr);
+            stats_report(input_path, opt_stats == STATS_JSON);
+            funlockfile(stderr);
+        }
+    }
+    error_jmp = outer;
+    input_path = NULL;
+    
+    if (keep_warm) {
+        arena_reset_all();
+    } else {
+        arena_release_all();
+        intern_reset();
+    }
+    elf_reset();
+    if (c->mapped)
+        munmap(user_input, c->mapped);
+    else
+        free(user_input);
+    user_input = NULL;
+}
+
+// Compile input files until none are left
+static void *compile_worker(void *arg) {
+    for (;;) {
+        int i = atomic_fetch_add(&next_input, 1);
+        if (i >= num_inputs)
+            return NULL;
+        compile(&inputs[i]);
+    }
+}
+
+// Set the options to their defaults
+static void reset_options() {
+    opt_regalloc = 1;
+    opt_ir = 0;
+    opt_fold = 1;
+    opt_peephole = 1;
+    opt_report = 0;
+    opt_jobs = 1;
+    opt_inline_threshold = INLINE_THRESHOLD;
+    opt_arena_stats = 0;
+    opt_dump_ir = 0;
+    opt_object = 0;
+    opt_run = 0;
+    opt_stats = 0;
+    output = NULL;
+    jobs = 0;
+    server_path = client_path = NULL;
+    cache_path = NULL;
+    cache_limit = 0;
+    cache_stats = 0;
+    opt_incremental = 0;
+    select_scanner(NULL);
+}
+
+// Parse a command line into the options and the input files
+static void parse_args(int argc, char **argv) {
+    free(inputs);
+    inputs = calloc(argc, sizeof(Compilation));
+    num_inputs = 0;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-c")) {
+            opt_object = 1;
+            continue;
+        }
+        if (!strcmp(argv[i], "--run")) {
+            opt_run = 1;
+            continue;
+        }
+        if (!strncmp(argv[i], "-j", 2)) {
+            char *arg = argv[i][2] ? argv[i] + 2 : argv[++i];
+            if (!arg)
+                usage(argv[0]);
+            jobs = atoi(arg);
+            if (jobs < 1)
+                error("Invalid number of threads: %s", arg);
+            continue;
+        }
+        if (!strcmp(argv[i], "--server") || !strcmp(argv[i], "--client")) {
+            if (++i == argc)
+                usage(argv[0]);
+            if (argv[i - 1][2] == 's')
+                server_path = argv[i];
+            else
+                client_path = argv[i];
+            continue;
+        }
+        if (!strcmp(argv[i], "--cache")) {
+            if (++i == argc)
+                usage(argv[0]);
+            cache_path = argv[i];
+            continue;
+        }
+        if (!strcmp(argv[i], "--cache-limit")) {
+            if (++i == argc)
+                usage(argv[0]);
+            cache_limit = parse_size(argv[i]);
+            continue;
+        }
+        if (!strcmp(argv[i], "--incremental")) {
+            opt_incremental = 1;
+            continue;
+        }
+        if (!strcmp(argv[i], "--cache-stats")) {
+            cache_stats = 1;
+            continue;
+        }
+        if (!strcmp(argv[i], "-o")) {
+            if (++i == argc)
+                usage(argv[0]);
+            output = argv[i];
+            continue;
+        }
+        if (!strcmp(argv[i], "--no-regalloc")) {
+            opt_regalloc = 0;
+            continue;
+        }
+        if (!strcmp(argv[i], "--no-fold")) {
+            opt_fold = 0;
+            continue;
+        }
+        if (!strcmp(argv[i], "--no-peephole")) {
+            opt_peephole = 0;
+            continue;
+        }
+        if (!strcmp(argv[i], "--inline-threshold")) {
+            if (++i == argc)
+                usage(argv[0]);
+            char *end;
+            opt_inline_threshold = strtol(argv[i], &end, 10);
+            if (*end || opt_inline_threshold < 0)
+                error("Invalid inline threshold: %s", argv[i]);
+            continue;
+        }
+        if (!strcmp(argv[i], "--opt-report")) {
+            opt_report = 1;
+            continue;
+        }
+        if (!strcmp(argv[i], "--stats") || !strcmp(argv[i], "-ftime-report")) {
+            opt_stats = STATS_TEXT;
+            continue;
+        }
+        if (!strcmp(argv[i], "--stats=json")) {
+            opt_stats = STATS_JSON;
+            continue;
+        }
+        if (!strcmp(argv[i], "--arena-stats")) {
+            opt_arena_stats = 1;
+            continue;
+        }
+        if (!strcmp(argv[i], "--ir")) {
+            opt_ir = 1;
+            continue;
+        }
+        if (!strcmp(argv[i], "--dump-ir")) {
+            opt_dump_ir = 1;
+            continue;
+        }
+        if (!strncmp(argv[i], "--scanner=", 10)) {
+            if (!select_scanner(argv[i] + 10))
+                error("Scanner %s is not supported", argv[i] + 10);
+            continue;
+        }
+        if (argv[i][0] == '-' && argv[i][1])
+            usage(argv[0]);
+        inputs[num_inputs++].path = argv[i];
+    }
+}
+
+// Compile a request of the compile server. argv is a command line for
+// one file, whose contents are source (or NULL to read the file). Output
+// goes to standard output and diagnostics to standard error. Returns the
+// exit status.
+int compile_request(int argc, char **argv, char *source) {
+    jmp_buf on_error;
+    jmp_buf *outer = error_jmp;
+    error_jmp = &on_error;
+    if (setjmp(on_error)) {
+        error_jmp = outer;
+        free(source);
         return 1;
     }
+    reset_options();
+    parse_args(argc, argv);
+    if (num_inputs != 1 || opt_run || server_path || client_path)
+        error("A server request takes one input file and no --run, --server or --client");
+    cache_open(cache_path, cache_limit);
+    error_jmp = outer;
     
-    // Read entire file
-    fseek(fp, 0, SEEK_END);
-    long size = ftell(fp);
-    fseek(fp, 0, SEEK_SET);
+    keep_warm = 1;
+    opt_jobs = jobs ? jobs : 1;
+    inputs[0].source = source;
+    compile(&inputs[0]);
+    cache_close();
+    if (cache_stats)
+        cache_report();
+    return inputs[0].failed;
+}
+
+int main(int argc, char **argv) {
+    double start = now_ms();
+    parse_args(argc, argv);
+    if (server_path) {
+        if (num_inputs)
+            usage(argv[0]);
+        serve(server_path);
+    }
+    if ((cache_stats || opt_incremental) && !cache_path)
+        error("--cache-stats and --incremental need --cache");
+    if (!client_path)
+        cache_open(cache_path, cache_limit);
+    if (!num_inputs) {
+        if (!cache_stats)
+            usage(argv[0]);
+        cache_report();
+        return 0;
+    }
+    if (!scanner)
+        select_scanner(NULL);
     
-    user_input = calloc(1, size + 1);
-    fread(user_input, 1, size, fp);
-    fclose(fp);
+    if (client_path) {
+        // Forward the command line without --client. The server may run in
+        // another directory, so the cache directory goes as an absolute
+        // path; the output is written here, and the source is sent.
+        if (num_inputs != 1 || opt_run || !strcmp(inputs[0].path, "-"))
+            error("--client takes one input file, not standard input, and no --run");
+        char **args = calloc(argc, sizeof(char *));
+        int n = 0;
+        for (int i = 0; i < argc; i++) {
+            if (!strcmp(argv[i], "--client")) {
+                i++;
+            } else if (!strcmp(argv[i], "--cache")) {
+                args[n++] = argv[i++];
+                args[n++] = absolute_path(argv[i]);
+            } else {
+                args[n++] = argv[i];
+            }
+        }
+        if (opt_object && !output)
+            output = output_path(inputs[0].path, ".o");
+        return client(client_path, n, args, inputs[0].path, output);
+    }
     
-    // Tokenize
-    token = tokenize(user_input);
+    if (num_inputs == 1) {
+        // -j parallelizes code generation of the one file. An object
+        // compiled from standard input goes to standard output.
+        opt_jobs = jobs ? jobs : 1;
+        inputs[0].output = output;
+        if (opt_object && !output && !opt_run && strcmp(inputs[0].path, "-"))
+            inputs[0].output = output_path(inputs[0].path, ".o");
+        compile(&inputs[0]);
+    } else {
+        // -j is the number of files compiled at once
+        if (output || opt_run || opt_dump_ir)
+            error("-o, --run and --dump-ir take a single input file");
+        for (int i = 0; i < num_inputs; i++)
+            if (!strcmp(inputs[i].path, "-"))
+                error("Standard input (-) must be the only input file");
+        if (!jobs)
+            jobs = sysconf(_SC_NPROCESSORS_ONLN);
+        if (jobs > num_inputs)
+            jobs = num_inputs;
+        for (int i = 0; i < num_inputs; i++)
+            inputs[i].output = output_path(inputs[i].path, opt_object ? ".o" : ".s");
+        
+        pthread_t *threads = calloc(jobs, sizeof(pthread_t));
+        for (int i = 0; i < jobs; i++)
+            if (pthread_create(&threads[i], NULL, compile_worker, NULL))
+                error("Cannot create thread");
+        for (int i = 0; i < jobs; i++)
+            pthread_join(threads[i], NULL);
+        free(threads);
+    }
     
-    // Parse
-    Function *prog = program();
+    cache_close();
+    if (cache_stats)
+        cache_report();
     
-    // Generate code
-    codegen(prog);
+    int failed = 0;
+    for (int i = 0; i < num_inputs; i++)
+        failed |= inputs[i].failed;
+    if (failed)
+        return 1;
     
+    // Run the program in this process; its exit code becomes ours
+    if (inputs[0].entry) {
+        double compiled = now_ms();
+        long ret = inputs[0].entry();
+        double finished = now_ms();
+        fprintf(stderr, "run: compile %.3f ms, execute %.3f ms\n",
+                compiled - start, finished - compiled);
+        exit(ret);
+    }
     return 0;
 }
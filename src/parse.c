@@ -1,12 +1,12 @@
 #include "compiler.h"
 
-LVar *locals;
-int label_count = 0;
-int str_count = 0;
+_Thread_local LVar *locals;
+_Thread_local int str_count = 0;
+static _Thread_local int call_count = 0;
 
 // Create a new AST node
 Node *new_node(NodeKind kind) {
-    Node *node = calloc(1, sizeof(Node));
+    Node *node = arena_alloc(&node_arena, sizeof(Node));
     node->kind = kind;
     return node;
 }
@@ -26,20 +26,80 @@ Node *new_num(int val) {
     return node;
 }
 
+// Append a node to an arena-allocated array, doubling it when full
+static Node **push_node(Node **arr, int *len, int *cap, Node *node) {
+    if (*len == *cap) {
+        *cap = *cap ? *cap * 2 : 8;
+        Node **grown = arena_alloc(&node_arena, *cap * sizeof(Node*));
+        if (arr)
+            memcpy(grown, arr, *len * sizeof(Node*));
+        arr = grown;
+    }
+    arr[(*len)++] = node;
+    return arr;
+}
+
+// Locals of the current function, indexed by an open-addressing hash table
+// on their interned names with linear probing. The table doubles when half
+// full. A slot is in use only if its stamp matches the current generation,
+// so moving on to the next function empties the table in constant time.
+// The table is reused for every function, so it lives on the heap rather
+// than in an arena.
+static _Thread_local LVar **lvar_table;
+static _Thread_local int *lvar_stamp;
+static _Thread_local int lvar_generation = 1;
+static _Thread_local int lvar_capacity;
+static _Thread_local int lvar_count;
+
+// Index of the slot holding the variable called name, or of the free slot
+// where it belongs
+static int lvar_slot(int name) {
+    unsigned mask = lvar_capacity - 1;
+    for (unsigned i = (name * 2654435761u) & mask;; i = (i + 1) & mask)
+        if (lvar_stamp[i] != lvar_generation || lvar_table[i]->name == name)
+            return i;
+}
+
+static void grow_lvar_table() {
+    LVar **old_table = lvar_table;
+    int *old_stamp = lvar_stamp;
+    int old_capacity = lvar_capacity;
+    lvar_capacity = lvar_capacity ? lvar_capacity * 2 : 64;
+    lvar_table = calloc(lvar_capacity, sizeof(LVar*));
+    lvar_stamp = calloc(lvar_capacity, sizeof(int));
+    if (!lvar_table || !lvar_stamp)
+        error("Out of memory");
+    for (int i = 0; i < old_capacity; i++) {
+        if (old_stamp[i] != lvar_generation)
+            continue;
+        int slot = lvar_slot(old_table[i]->name);
+        lvar_table[slot] = old_table[i];
+        lvar_stamp[slot] = lvar_generation;
+    }
+    free(old_table);
+    free(old_stamp);
+}
+
+// Forget the locals of the previous function
+static void clear_lvars() {
+    locals = NULL;
+    lvar_count = 0;
+    lvar_generation++;
+}
+
 // Find local variable
-LVar *find_lvar(Token *tok) {
-    for (LVar *var = locals; var; var = var->next)
-        if (var->len == tok->len && !memcmp(tok->str, var->name, var->len))
-            return var;
-    return NULL;
+LVar *find_lvar(int ident) {
+    if (!lvar_count)
+        return NULL;
+    int slot = lvar_slot(tokens.val[ident]);
+    return lvar_stamp[slot] == lvar_generation ? lvar_table[slot] : NULL;
 }
 
 // Create new local variable
-LVar *new_lvar(Token *tok) {
-    LVar *var = calloc(1, sizeof(LVar));
+LVar *new_lvar(int ident) {
+    LVar *var = arena_alloc(&node_arena, sizeof(LVar));
     var->next = locals;
-    var->name = tok->str;
-    var->len = tok->len;
+    var->name = tokens.val[ident];
     
     if (locals)
         var->offset = locals->offset + 8;
@@ -47,6 +107,15 @@ LVar *new_lvar(Token *tok) {
         var->offset = 8;
     
     locals = var;
+    
+    if (2 * (lvar_count + 1) > lvar_capacity)
+        grow_lvar_table();
+    int slot = lvar_slot(var->name);
+    if (lvar_stamp[slot] != lvar_generation)
+        lvar_count++;
+    // A redeclared name refers to the newest variable from here on
+    lvar_table[slot] = var;
+    lvar_stamp[slot] = lvar_generation;
     return var;
 }
 
@@ -58,26 +127,28 @@ Node *stmt();
 //           "sizeof" "(" type ")" | string
 Node *primary() {
     // String literal
-    if (token->kind == TK_STRING) {
+    if (tokens.kind[tok] == TK_STRING) {
         Node *node = new_node(ND_STRING);
-        node->str_val = calloc(1, token->len + 1);
+        char *str = tok_str(tok);
+        int len = tokens.len[tok];
+        node->str_val = arena_alloc(&node_arena, len + 1);
         int j = 0;
         // Parse string, handling escape sequences
-        for (int i = 1; i < token->len - 1; i++) {
-            if (token->str[i] == '\\' && i + 1 < token->len - 1) {
+        for (int i = 1; i < len - 1; i++) {
+            if (str[i] == '\\' && i + 1 < len - 1) {
                 i++;
-                if (token->str[i] == 'n') node->str_val[j++] = '\n';
-                else if (token->str[i] == 't') node->str_val[j++] = '\t';
-                else if (token->str[i] == '\\') node->str_val[j++] = '\\';
-                else if (token->str[i] == '"') node->str_val[j++] = '"';
-                else node->str_val[j++] = token->str[i];
+                if (str[i] == 'n') node->str_val[j++] = '\n';
+                else if (str[i] == 't') node->str_val[j++] = '\t';
+                else if (str[i] == '\\') node->str_val[j++] = '\\';
+                else if (str[i] == '"') node->str_val[j++] = '"';
+                else node->str_val[j++] = str[i];
             } else {
-                node->str_val[j++] = token->str[i];
+                node->str_val[j++] = str[i];
             }
         }
         node->str_val[j] = '\0';
         node->str_label = str_count++;
-        token = token->next;
+        tok++;
         return node;
     }
     
@@ -98,7 +169,7 @@ Node *primary() {
         } else if (consume(TK_CHAR)) {
             size = 1;
         } else {
-            error_at(token->str, "Expected type name");
+            error_at(tok_str(tok), "Expected type name");
         }
         
         // Handle pointer type
@@ -111,25 +182,24 @@ Node *primary() {
     }
     
     // Identifier (variable or function call)
-    Token *tok = consume_ident();
-    if (tok) {
+    int ident = consume_ident();
+    if (ident >= 0) {
         // Function call
         if (consume(TK_LPAREN)) {
             Node *node = new_node(ND_FUNCALL);
-            node->funcname = calloc(1, tok->len + 1);
-            memcpy(node->funcname, tok->str, tok->len);
-            node->funcname[tok->len] = '\0';
+            node->funcname = name_str(tokens.val[ident]);
+            call_count++;
             
             // Parse arguments
             Node **args = NULL;
             int num_args = 0;
+            int cap = 0;
             
             if (!consume(TK_RPAREN)) {
-                args = calloc(16, sizeof(Node*));
-                args[num_args++] = expr();
+                args = push_node(args, &num_args, &cap, expr());
                 
                 while (consume(TK_COMMA)) {
-                    args[num_args++] = expr();
+                    args = push_node(args, &num_args, &cap, expr());
                 }
                 
                 expect(TK_RPAREN);
@@ -141,9 +211,9 @@ Node *primary() {
         }
         
         // Variable
-        LVar *var = find_lvar(tok);
+        LVar *var = find_lvar(ident);
         if (!var)
-            var = new_lvar(tok);
+            var = new_lvar(ident);
         
         Node *node = new_node(ND_LVAR);
         node->offset = var->offset;
@@ -330,11 +400,12 @@ Node *stmt() {
     // "{" stmt* "}"
     if (consume(TK_LBRACE)) {
         Node *node = new_node(ND_BLOCK);
-        Node **stmts = calloc(100, sizeof(Node*));
+        Node **stmts = NULL;
         int num_stmts = 0;
+        int cap = 0;
         
         while (!consume(TK_RBRACE)) {
-            stmts[num_stmts++] = stmt();
+            stmts = push_node(stmts, &num_stmts, &cap, stmt());
         }
         
         node->stmts = stmts;
@@ -343,16 +414,16 @@ Node *stmt() {
     }
     
     // Variable declaration: type ident ";"
-    if (token->kind == TK_INT || token->kind == TK_CHAR || token->kind == TK_VOID) {
-        token = token->next;  // Skip type
+    if (tokens.kind[tok] == TK_INT || tokens.kind[tok] == TK_CHAR || tokens.kind[tok] == TK_VOID) {
+        tok++;  // Skip type
         while (consume(TK_MUL)) {}  // Skip pointer stars
         
-        Token *tok = consume_ident();
-        if (tok) {
+        int ident = consume_ident();
+        if (ident >= 0) {
             // Create variable if it doesn't exist
-            LVar *var = find_lvar(tok);
+            LVar *var = find_lvar(ident);
             if (!var)
-                var = new_lvar(tok);
+                var = new_lvar(ident);
             
             expect(TK_SEMICOLON);
             // Return a dummy node (no code generated for declarations)
@@ -374,8 +445,9 @@ void parse_params(Function *func) {
     if (consume(TK_RPAREN))
         return;
     
-    Node **params = calloc(16, sizeof(Node*));
+    Node **params = NULL;
     int num_params = 0;
+    int cap = 0;
     
     // For now, we'll just skip parameter types
     // and treat parameters as local variables
@@ -384,12 +456,12 @@ void parse_params(Function *func) {
             while (consume(TK_MUL)) {}  // Skip pointer stars
         }
         
-        Token *tok = consume_ident();
-        if (tok) {
-            LVar *var = new_lvar(tok);
+        int ident = consume_ident();
+        if (ident >= 0) {
+            LVar *var = new_lvar(ident);
             Node *node = new_node(ND_LVAR);
             node->offset = var->offset;
-            params[num_params++] = node;
+            params = push_node(params, &num_params, &cap, node);
         }
     } while (consume(TK_COMMA));
     
@@ -400,7 +472,9 @@ void parse_params(Function *func) {
 
 // function = type ident "(" params? ")" "{" stmt* "}"
 Function *function() {
-    locals = NULL;
+    clear_lvars();
+    str_count = 0;
+    call_count = 0;
     
     // Parse return type
     if (consume(TK_INT) || consume(TK_CHAR) || consume(TK_VOID)) {
@@ -408,14 +482,12 @@ Function *function() {
     }
     
     // Parse function name
-    Token *tok = consume_ident();
-    if (!tok)
-        error_at(token->str, "Expected function name");
+    int ident = consume_ident();
+    if (ident < 0)
+        error_at(tok_str(tok), "Expected function name");
     
-    Function *func = calloc(1, sizeof(Function));
-    func->name = calloc(1, tok->len + 1);
-    memcpy(func->name, tok->str, tok->len);
-    func->name[tok->len] = '\0';
+    Function *func = arena_alloc(&node_arena, sizeof(Function));
+    func->name = name_str(tokens.val[ident]);
     
     // Parse parameters
     expect(TK_LPAREN);
@@ -424,11 +496,12 @@ Function *function() {
     // Parse function body
     expect(TK_LBRACE);
     
-    Node **stmts = calloc(100, sizeof(Node*));
+    Node **stmts = NULL;
     int num_stmts = 0;
+    int cap = 0;
     
     while (!consume(TK_RBRACE)) {
-        stmts[num_stmts++] = stmt();
+        stmts = push_node(stmts, &num_stmts, &cap, stmt());
     }
     
     func->stmts = stmts;
@@ -436,6 +509,8 @@ Function *function() {
     
     // Calculate stack size
     func->stack_size = locals ? locals->offset : 0;
+    func->num_strings = str_count;
+    func->num_calls = call_count;
     
     return func;
 }
@@ -0,0 +1,369 @@
+#include "compiler.h"
+
+// Peephole optimizer.
+//
+// Unless --no-peephole is given, the emitter holds the instructions of
+// each function as a list of Insns and passes the list here before
+// formatting or encoding it. Patterns over the last few instructions
+// remove what the stack machine wastes:
+//
+//   push R; pop S                  mov S, R
+//   push R; X; pop S               mov S, R; X   (X leaves S and rsp alone)
+//   mov R, rbp; sub R, N           lea R, [rbp-N]
+//   lea R, [B+d]; mov R, [R+e]     mov R, [B+d+e]
+//   mov [M], R; mov R, [M]         mov [M], R
+//   mov R, X; mov S, R; Y          mov S, X; Y   (Y sets R without reading it)
+//   mov R, R                       (removed)
+//   cmp R, 0                       test R, R
+//   setcc al; movzb rax, al; test rax, rax; je L
+//                                  setcc al; movzb rax, al; jncc L
+//   jmp L; L:                      L:
+//
+// The compare-and-branch pattern also applies with jne, and with a store
+// of rax between movzb and test. The setcc and movzb are then removed as
+// well when nothing reads rax after the jump, on either path, before
+// setting it; a scan of the original list decides this.
+//
+// Instructions go one at a time onto the output, and the patterns are
+// tried on its end after each, so that one rewrite can enable the next.
+// Labels are jump targets, so no pattern spans one. The code generators
+// read the flags only right after the cmp that sets them, which lets lea
+// replace sub. --opt-report prints how often each pattern fired.
+
+enum {
+    P_PUSH_POP,
+    P_PUSH_POP_ACROSS,
+    P_LEA,
+    P_DIRECT_LOAD,
+    P_STORE_LOAD,
+    P_SELF_MOVE,
+    P_DEAD_COPY,
+    P_TEST,
+    P_BRANCH,
+    P_DEAD_SETCC,
+    P_JUMP_NEXT,
+    NUM_PATTERNS,
+};
+
+static char *pattern_names[NUM_PATTERNS] = {
+    [P_PUSH_POP] = "push-pop",
+    [P_PUSH_POP_ACROSS] = "push-pop-across",
+    [P_LEA] = "lea",
+    [P_DIRECT_LOAD] = "direct-load",
+    [P_STORE_LOAD] = "store-load",
+    [P_SELF_MOVE] = "self-move",
+    [P_DEAD_COPY] = "dead-copy",
+    [P_TEST] = "test",
+    [P_BRANCH] = "compare-branch",
+    [P_DEAD_SETCC] = "dead-setcc",
+    [P_JUMP_NEXT] = "jump-to-next",
+};
+
+// Hits of each pattern on this thread, then the instructions before and
+// after optimization
+enum { INSNS_IN = NUM_PATTERNS, INSNS_OUT, NUM_COUNTS };
+static _Thread_local long counts[NUM_COUNTS];
+
+// How far the liveness scan follows the code: instructions, and jumps
+#define MAX_SCAN 64
+#define MAX_JUMPS 4
+
+static Opcode branches[] = {I_JE, I_JNE, I_JL, I_JLE, I_JG, I_JGE};
+static Opcode inverted_branches[] = {I_JNE, I_JE, I_JGE, I_JG, I_JLE, I_JL};
+
+static int is(Insn *in, Opcode op) {
+    return in->label < 0 && in->op == op;
+}
+
+static int is_reg(Operand *op, Reg reg) {
+    return op->kind == OP_REG && op->reg == reg;
+}
+
+static int is_jcc(Opcode op) {
+    return op == I_JE || op == I_JNE || (op >= I_JL && op <= I_JGE);
+}
+
+static int is_setcc(Opcode op) {
+    return op >= I_SETE && op <= I_SETGE;
+}
+
+static int is_arg_reg(Reg reg) {
+    return reg == RDI || reg == RSI || reg == RDX || reg == RCX || reg == R8 || reg == R9;
+}
+
+static int is_caller_saved(Reg reg) {
+    return reg == RAX || is_arg_reg(reg) || reg == R10 || reg == R11;
+}
+
+// Whether in reads reg
+static int reads(Insn *in, Reg reg) {
+    Operand *dst = &in->dst;
+    Operand *src = &in->src;
+    if ((src->kind == OP_REG || src->kind == OP_MEM) && src->reg == reg)
+        return 1;
+    if (dst->kind == OP_MEM && dst->reg == reg)
+        return 1;
+    if (is_reg(dst, reg) && in->op != I_MOV && in->op != I_MOVZB && in->op != I_LEA &&
+        in->op != I_POP)
+        return 1;
+    switch (in->op) {
+    case I_CQO:
+        return reg == RAX;
+    case I_IDIV:
+        return reg == RAX || reg == RDX;
+    case I_CALL:
+        return reg == RAX || reg == RSP || is_arg_reg(reg);
+    case I_RET:
+        return reg == RAX || reg == RSP;
+    case I_PUSH:
+    case I_POP:
+        return reg == RSP;
+    default:
+        return 0;
+    }
+}
+
+// Whether in changes reg, wholly or in part
+static int writes(Insn *in, Reg reg) {
+    if (is_reg(&in->dst, reg) && in->op != I_CMP && in->op != I_TEST && in->op != I_PUSH)
+        return 1;
+    switch (in->op) {
+    case I_CQO:
+        return reg == RDX;
+    case I_IDIV:
+        return reg == RAX || reg == RDX;
+    case I_CALL:
+        return reg == RSP || is_caller_saved(reg);
+    case I_PUSH:
+    case I_POP:
+    case I_RET:
+        return reg == RSP;
+    default:
+        return 0;
+    }
+}
+
+// Whether in sets all of reg without reading it
+static int kills(Insn *in, Reg reg) {
+    return in->label < 0 && (in->op == I_MOV || in->op == I_MOVZB || in->op == I_LEA ||
+                             in->op == I_POP) && is_reg(&in->dst, reg) && !reads(in, reg);
+}
+
+// Whether rax may be read before it is set from index i of insns on,
+// following at most jumps jumps; labels[l] is the index of label l
+static int rax_live(Insn *insns, int n, int *labels, int num_labels, int i, int jumps) {
+    for (int steps = 0; i < n && steps < MAX_SCAN; steps++) {
+        Insn *in = &insns[i];
+        if (in->label >= 0) {
+            i++;
+            continue;
+        }
+        if (reads(in, RAX))
+            return 1;
+        if (kills(in, RAX))
+            return 0;
+        if (in->op != I_JMP && !is_jcc(in->op)) {
+            i++;
+            continue;
+        }
+        int label = in->dst.imm;
+        if (!jumps-- || label >= num_labels || labels[label] < 0)
+            return 1;
+        if (in->op == I_JMP) {
+            i = labels[label];
+            continue;
+        }
+        if (rax_live(insns, n, labels, num_labels, labels[label], jumps))
+            return 1;
+        i++;
+    }
+    return 1;
+}
+
+// Whether X in "push r; X; pop s" can run after the pop instead
+static int movable(Insn *x, Reg r, Reg s) {
+    if (x->label >= 0 || x->op == I_PUSH || x->op == I_POP || x->op == I_CALL ||
+        x->op == I_RET || x->op == I_JMP || is_jcc(x->op))
+        return 0;
+    if (reads(x, RSP) || writes(x, RSP) || reads(x, s) || writes(x, s))
+        return 0;
+    return r != s || !writes(x, r);
+}
+
+// Apply one pattern to the last instructions of out[0..*w); returns
+// whether one applied
+static int simplify(Insn *out, int *w) {
+    Insn *a = *w >= 1 ? &out[*w - 1] : NULL;
+    Insn *b = *w >= 2 ? &out[*w - 2] : NULL;
+    Insn *c = *w >= 3 ? &out[*w - 3] : NULL;
+
+    if (a && is(a, I_MOV) && a->dst.kind == OP_REG && is_reg(&a->src, a->dst.reg)) {
+        (*w)--;
+        counts[P_SELF_MOVE]++;
+        return 1;
+    }
+    if (b && is(b, I_PUSH) && is(a, I_POP)) {
+        *b = (Insn){I_MOV, a->dst, b->dst, -1};
+        (*w)--;
+        counts[P_PUSH_POP]++;
+        return 1;
+    }
+    if (c && is(c, I_PUSH) && is(a, I_POP) && movable(b, c->dst.reg, a->dst.reg)) {
+        Insn x = *b;
+        if (c->dst.reg == a->dst.reg) {
+            *c = x;
+            *w -= 2;
+        } else {
+            *c = (Insn){I_MOV, a->dst, c->dst, -1};
+            *b = x;
+            (*w)--;
+        }
+        counts[P_PUSH_POP_ACROSS]++;
+        return 1;
+    }
+    if (c && (is(c, I_MOV) || is(c, I_LEA)) && c->dst.kind == OP_REG && is(b, I_MOV) &&
+        b->dst.kind == OP_REG && is_reg(&b->src, c->dst.reg) && b->dst.reg != c->dst.reg &&
+        !reads(c, b->dst.reg) && kills(a, c->dst.reg)) {
+        c->dst = b->dst;
+        *b = *a;
+        (*w)--;
+        counts[P_DEAD_COPY]++;
+        return 1;
+    }
+    if (b && is(b, I_MOV) && b->dst.kind == OP_REG && is_reg(&b->src, RBP) &&
+        is(a, I_SUB) && is_reg(&a->dst, b->dst.reg) && a->src.kind == OP_IMM) {
+        *b = (Insn){I_LEA, b->dst, op_mem(RBP, -a->src.imm), -1};
+        (*w)--;
+        counts[P_LEA]++;
+        return 1;
+    }
+    if (b && is(b, I_LEA) && b->src.kind == OP_MEM && is(a, I_MOV) &&
+        is_reg(&a->dst, b->dst.reg) && a->src.kind == OP_MEM && a->src.reg == b->dst.reg) {
+        *b = (Insn){I_MOV, a->dst, op_mem(b->src.reg, b->src.imm + a->src.imm), -1};
+        (*w)--;
+        counts[P_DIRECT_LOAD]++;
+        return 1;
+    }
+    if (b && is(b, I_MOV) && b->dst.kind == OP_MEM && b->src.kind == OP_REG &&
+        b->dst.reg != b->src.reg && is(a, I_MOV) && is_reg(&a->dst, b->src.reg) &&
+        a->src.kind == OP_MEM && a->src.reg == b->dst.reg && a->src.imm == b->dst.imm) {
+        (*w)--;
+        counts[P_STORE_LOAD]++;
+        return 1;
+    }
+    return 0;
+}
+
+// Turn "setcc al; movzb rax, al; test rax, rax" before the je or jne in
+// into a jump on the condition itself. rax_dead tells whether the value
+// is needed after the jump.
+static void fuse_branch(Insn *out, int *w, Insn *in, int rax_dead) {
+    if (*w < 3 || !is(&out[*w - 1], I_TEST) || !is_reg(&out[*w - 1].dst, RAX) ||
+        !is_reg(&out[*w - 1].src, RAX))
+        return;
+    int k = *w - 2;
+    int stored = 0;
+    if (is(&out[k], I_MOV) && out[k].dst.kind == OP_MEM && out[k].dst.reg != RAX &&
+        is_reg(&out[k].src, RAX)) {
+        k--;
+        stored = 1;
+    }
+    if (k < 1 || !is(&out[k], I_MOVZB) || !is_reg(&out[k].dst, RAX) ||
+        !is_reg(&out[k].src, RAX))
+        return;
+    Insn *set = &out[k - 1];
+    if (set->label >= 0 || !is_setcc(set->op) || !is_reg(&set->dst, RAX))
+        return;
+
+    // je jumps when the condition is false
+    int cond = set->op - I_SETE;
+    in->op = in->op == I_JE ? inverted_branches[cond] : branches[cond];
+    (*w)--;
+    counts[P_BRANCH]++;
+    if (!stored && rax_dead) {
+        *w -= 2;
+        counts[P_DEAD_SETCC]++;
+    }
+}
+
+// Optimize the n instructions and labels of one function in place;
+// returns how many are left
+int peephole(Insn *insns, int n) {
+    // Find the labels, and whether rax is needed after each je and jne
+    int num_labels = 0;
+    for (int i = 0; i < n; i++)
+        if (insns[i].label >= num_labels)
+            num_labels = insns[i].label + 1;
+    int *labels = malloc((num_labels + 1) * sizeof(int));
+    char *dead = malloc(n + 1);
+    if (!labels || !dead)
+        error("Out of memory");
+    for (int i = 0; i < num_labels; i++)
+        labels[i] = -1;
+    for (int i = 0; i < n; i++) {
+        if (insns[i].label >= 0)
+            labels[insns[i].label] = i;
+        else
+            counts[INSNS_IN]++;
+    }
+    for (int i = 0; i < n; i++) {
+        dead[i] = 0;
+        if (!is(&insns[i], I_JE) && !is(&insns[i], I_JNE))
+            continue;
+        int target = insns[i].dst.imm;
+        dead[i] = target < num_labels && labels[target] >= 0 &&
+                  !rax_live(insns, n, labels, num_labels, i + 1, MAX_JUMPS) &&
+                  !rax_live(insns, n, labels, num_labels, labels[target], MAX_JUMPS);
+    }
+
+    int w = 0;
+    for (int i = 0; i < n; i++) {
+        Insn in = insns[i];
+        if (is(&in, I_CMP) && in.dst.kind == OP_REG && in.src.kind == OP_IMM &&
+            in.src.imm == 0) {
+            in = (Insn){I_TEST, in.dst, in.dst, -1};
+            counts[P_TEST]++;
+        }
+        if (in.label >= 0 && w && is(&insns[w - 1], I_JMP) &&
+            insns[w - 1].dst.imm == in.label) {
+            w--;
+            counts[P_JUMP_NEXT]++;
+        }
+        if (is(&in, I_JE) || is(&in, I_JNE))
+            fuse_branch(insns, &w, &in, dead[i]);
+        insns[w++] = in;
+        while (simplify(insns, &w))
+            ;
+    }
+
+    for (int i = 0; i < w; i++)
+        if (insns[i].label < 0)
+            counts[INSNS_OUT]++;
+    free(labels);
+    free(dead);
+    return w;
+}
+
+// This thread's counts, for peephole_merge() on other threads
+long *peephole_counts() {
+    return counts;
+}
+
+// Add this thread's counts to those of another thread (from
+// peephole_counts()), and clear them
+void peephole_merge(long *into) {
+    for (int i = 0; i < NUM_COUNTS; i++) {
+        into[i] += counts[i];
+        counts[i] = 0;
+    }
+}
+
+// Print the counts of the current compilation for --opt-report
+void peephole_report() {
+    fprintf(stderr, "peephole: %ld instructions removed (%ld -> %ld);",
+            counts[INSNS_IN] - counts[INSNS_OUT], counts[INSNS_IN], counts[INSNS_OUT]);
+    for (int i = 0; i < NUM_PATTERNS; i++)
+        fprintf(stderr, "%s %s %ld", i ? "," : "", pattern_names[i], counts[i]);
+    fprintf(stderr, "\n");
+    memset(counts, 0, sizeof(counts));
+}
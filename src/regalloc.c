@@ -0,0 +1,353 @@
+#include "compiler.h"
+
+// Linear-scan register allocation for the AST code generator.
+//
+// Scalar locals whose address is never taken get a live interval in
+// evaluation order and are assigned to callee-saved registers; when the
+// pool runs out the interval with the fewest loop-weighted uses is spilled
+// back to its stack slot.
+// Registers left over, plus r10/r11, hold expression temporaries that the
+// stack machine would otherwise push and pop.
+
+static Reg callee_regs[] = {RBX, R12, R13, R14, R15};
+static Reg caller_regs[] = {R10, R11};
+
+#define NUM_CALLEE_REGS 5
+#define NUM_CALLER_REGS 2
+
+// Live interval of a local variable, in traversal positions
+typedef struct Interval {
+    int slot;        // offset / 8
+    int start;
+    int end;
+    int weight;      // Uses, scaled by loop nesting depth
+    int addr_taken;
+    int reg;         // index into callee_regs, or -1
+} Interval;
+
+typedef struct Loop {
+    int start;
+    int end;
+} Loop;
+
+// State of the function being allocated, one per code generation thread
+static _Thread_local Interval *intervals;
+static _Thread_local int num_slots;
+static _Thread_local Loop *loops;
+static _Thread_local int num_loops;
+static _Thread_local int cap_loops;
+static _Thread_local int pos;
+static _Thread_local int loop_depth;
+static _Thread_local int has_calls;
+
+static void touch(int offset) {
+    Interval *iv = &intervals[offset / 8];
+    if (iv->start < 0)
+        iv->start = pos;
+    iv->end = pos;
+    iv->weight += 1 << (2 * (loop_depth < 4 ? loop_depth : 4));
+}
+
+static void add_loop(int start, int end) {
+    if (num_loops == cap_loops) {
+        cap_loops = cap_loops ? cap_loops * 2 : 8;
+        loops = realloc(loops, cap_loops * sizeof(Loop));
+    }
+    loops[num_loops].start = start;
+    loops[num_loops].end = end;
+    num_loops++;
+}
+
+// Number nodes in the order gen() evaluates them
+static void scan(Node *node) {
+    if (!node)
+        return;
+    pos++;
+
+    switch (node->kind) {
+    case ND_LVAR:
+        touch(node->offset);
+        return;
+    case ND_ADDR:
+        if (node->lhs->kind == ND_LVAR) {
+            touch(node->lhs->offset);
+            intervals[node->lhs->offset / 8].addr_taken = 1;
+            return;
+        }
+        scan(node->lhs);
+        return;
+    case ND_WHILE: {
+        int start = pos;
+        loop_depth++;
+        scan(node->cond);
+        scan(node->then);
+        loop_depth--;
+        add_loop(start, ++pos);
+        return;
+    }
+    case ND_FOR: {
+        scan(node->init);
+        int start = pos;
+        loop_depth++;
+        scan(node->cond);
+        scan(node->then);
+        scan(node->inc);
+        loop_depth--;
+        add_loop(start, ++pos);
+        return;
+    }
+    case ND_FUNCALL:
+        has_calls = 1;
+        for (int i = node->num_args - 1; i >= 0; i--)
+            scan(node->args[i]);
+        pos++;
+        return;
+    default:
+        break;
+    }
+
+    scan(node->init);
+    scan(node->cond);
+    scan(node->then);
+    scan(node->els);
+    scan(node->inc);
+    scan(node->lhs);
+    scan(node->rhs);
+    for (int i = 0; i < node->num_stmts; i++)
+        scan(node->stmts[i]);
+    pos++;
+}
+
+// A variable referenced inside a loop stays live for the whole loop
+static void extend_over_loops() {
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        for (int i = 0; i < num_slots; i++) {
+            Interval *iv = &intervals[i];
+            if (iv->start < 0)
+                continue;
+            for (int j = 0; j < num_loops; j++) {
+                Loop *lp = &loops[j];
+                if (iv->start > lp->end || iv->end < lp->start)
+                    continue;
+                if (iv->start > lp->start) {
+                    iv->start = lp->start;
+                    changed = 1;
+                }
+                if (iv->end < lp->end) {
+                    iv->end = lp->end;
+                    changed = 1;
+                }
+            }
+        }
+    }
+}
+
+static int by_start(const void *a, const void *b) {
+    Interval *x = *(Interval **)a;
+    Interval *y = *(Interval **)b;
+    if (x->start != y->start)
+        return x->start - y->start;
+    return x->slot - y->slot;
+}
+
+// Whether a is a better spill candidate than b
+static int spill_before(Interval *a, Interval *b) {
+    if (a->weight != b->weight)
+        return a->weight < b->weight;
+    return a->end > b->end;
+}
+
+static void linear_scan() {
+    Interval **order = arena_alloc(&gen_arena, num_slots * sizeof(Interval*));
+    int n = 0;
+    for (int i = 0; i < num_slots; i++)
+        if (intervals[i].start >= 0 && !intervals[i].addr_taken)
+            order[n++] = &intervals[i];
+    qsort(order, n, sizeof(Interval*), by_start);
+
+    Interval *active[NUM_CALLEE_REGS] = {0};
+
+    for (int i = 0; i < n; i++) {
+        Interval *cur = order[i];
+
+        // Expire intervals that ended before this one starts
+        for (int r = 0; r < NUM_CALLEE_REGS; r++)
+            if (active[r] && active[r]->end < cur->start)
+                active[r] = NULL;
+
+        int free_reg = -1;
+        for (int r = 0; r < NUM_CALLEE_REGS; r++) {
+            if (!active[r]) {
+                free_reg = r;
+                break;
+            }
+        }
+
+        if (free_reg >= 0) {
+            cur->reg = free_reg;
+            active[free_reg] = cur;
+            continue;
+        }
+
+        // Spill the cheapest interval, preferring the one that ends last
+        int victim = 0;
+        for (int r = 1; r < NUM_CALLEE_REGS; r++)
+            if (spill_before(active[r], active[victim]))
+                victim = r;
+        if (spill_before(active[victim], cur)) {
+            cur->reg = victim;
+            active[victim]->reg = -1;
+            active[victim] = cur;
+        }
+    }
+}
+
+// Operands that gen() can load into rax without touching other registers
+int regalloc_is_leaf(Node *node) {
+    return node->kind == ND_NUM || node->kind == ND_LVAR ||
+           node->kind == ND_STRING;
+}
+
+// Maximum number of temporaries live at once while evaluating node,
+// mirroring the gen_push() calls made by gen() in register mode
+static int tmp_need(Node *node);
+
+static int max_need(int need, Node *node) {
+    int n = tmp_need(node);
+    return n > need ? n : need;
+}
+
+static int tmp_need(Node *node) {
+    if (!node)
+        return 0;
+
+    int need = 0;
+    switch (node->kind) {
+    case ND_NUM:
+    case ND_STRING:
+    case ND_LVAR:
+    case ND_SIZEOF:
+        return 0;
+    case ND_ASSIGN:
+        if (node->lhs->kind == ND_LVAR)
+            return tmp_need(node->rhs);
+        need = 1 + tmp_need(node->rhs);
+        return max_need(need, node->lhs->lhs);
+    case ND_ADDR:
+        need = node->lhs->kind == ND_DEREF ? tmp_need(node->lhs->lhs) : 0;
+        return need > 1 ? need : 1;
+    case ND_NEG:
+    case ND_DEREF:
+    case ND_RETURN:
+        return tmp_need(node->lhs);
+    case ND_FUNCALL:
+        need = node->num_args;
+        for (int i = 0; i < node->num_args; i++) {
+            int n = (node->num_args - 1 - i) + tmp_need(node->args[i]);
+            if (n > need)
+                need = n;
+        }
+        return need;
+    case ND_IF:
+    case ND_WHILE:
+    case ND_FOR:
+    case ND_BLOCK:
+    case ND_INLINE: {
+        Node *kids[] = {node->init, node->cond, node->then, node->els, node->inc};
+        for (int i = 0; i < 5; i++)
+            need = max_need(need, kids[i]);
+        for (int i = 0; i < node->num_stmts; i++)
+            need = max_need(need, node->stmts[i]);
+        return need;
+    }
+    default:
+        break;
+    }
+
+    // Binary operators; a compare against a constant only evaluates rhs
+    if (node->lhs->kind == ND_NUM && is_compare(node->kind))
+        return tmp_need(node->rhs);
+    if (!regalloc_is_leaf(node->rhs))
+        need = 1 + tmp_need(node->rhs);
+    return max_need(need, node->lhs);
+}
+
+// Allocate registers for one function
+void regalloc(Function *fn, RegInfo *ri) {
+    memset(ri, 0, sizeof(RegInfo));
+    ri->frame_size = fn->stack_size;
+
+    num_slots = fn->stack_size / 8 + 1;
+    intervals = arena_alloc(&gen_arena, num_slots * sizeof(Interval));
+    for (int i = 0; i < num_slots; i++) {
+        intervals[i].slot = i;
+        intervals[i].start = -1;
+        intervals[i].reg = -1;
+    }
+    num_loops = 0;
+    pos = 0;
+    loop_depth = 0;
+    has_calls = 0;
+
+    // Parameters are defined on entry
+    for (int i = 0; i < fn->num_params; i++)
+        touch(fn->params[i]->offset);
+    for (int i = 0; i < fn->num_stmts; i++)
+        scan(fn->stmts[i]);
+
+    extend_over_loops();
+    linear_scan();
+
+    int used[NUM_CALLEE_REGS] = {0};
+    ri->lvar_reg = arena_alloc(&gen_arena, num_slots * sizeof(Reg));
+    ri->num_slots = num_slots;
+    for (int i = 0; i < num_slots; i++) {
+        ri->lvar_reg[i] = REG_NONE;
+        if (intervals[i].reg >= 0) {
+            ri->lvar_reg[i] = callee_regs[intervals[i].reg];
+            used[intervals[i].reg] = 1;
+        }
+    }
+
+    // Temporaries: caller-saved registers must be saved around calls,
+    // callee-saved ones only once in the prologue
+    int need = 0;
+    for (int i = 0; i < fn->num_stmts; i++)
+        need = max_need(need, fn->stmts[i]);
+
+    for (int pass = 0; pass < 2; pass++) {
+        int callee_pass = has_calls ? pass == 0 : pass == 1;
+        if (callee_pass) {
+            for (int r = 0; r < NUM_CALLEE_REGS && ri->num_tmp_regs < need; r++) {
+                if (used[r])
+                    continue;
+                used[r] = 1;
+                ri->tmp_regs[ri->num_tmp_regs++] = callee_regs[r];
+            }
+        } else {
+            for (int r = 0; r < NUM_CALLER_REGS && ri->num_tmp_regs < need; r++)
+                ri->tmp_regs[ri->num_tmp_regs++] = caller_regs[r];
+        }
+    }
+
+    for (int r = 0; r < NUM_CALLEE_REGS; r++) {
+        if (!used[r])
+            continue;
+        ri->frame_size += 8;
+        ri->saved_regs[ri->num_saved] = callee_regs[r];
+        ri->saved_offsets[ri->num_saved] = ri->frame_size;
+        ri->num_saved++;
+    }
+
+    intervals = NULL;
+}
+
+// Whether a temporary register is clobbered by calls
+int regalloc_is_caller_saved(Reg reg) {
+    for (int i = 0; i < NUM_CALLER_REGS; i++)
+        if (reg == caller_regs[i])
+            return 1;
+    return 0;
+}
@@ -0,0 +1,204 @@
+#include "compiler.h"
+
+// Run scanners for the lexer's hot loops.
+//
+// Whitespace, line comments and identifiers are runs of bytes of one class.
+// Each scanner returns the first byte past such a run. The SSE2 and AVX2
+// versions classify 16 or 32 bytes per step; the best one the CPU supports
+// is picked at run time, and the scalar version is used everywhere else.
+//
+// A vector load never crosses a page boundary, so reading past the
+// terminating NUL is harmless.
+
+static int is_space_byte(unsigned char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+static int is_ident_byte(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           (c >= '0' && c <= '9') || c == '_';
+}
+
+static char *skip_space_scalar(char *p) {
+    while (is_space_byte(*p))
+        p++;
+    return p;
+}
+
+static char *skip_line_scalar(char *p) {
+    while (*p && *p != '\n')
+        p++;
+    return p;
+}
+
+static char *skip_ident_scalar(char *p) {
+    while (is_ident_byte(*p))
+        p++;
+    return p;
+}
+
+static Scanner scalar_scanner = {
+    "scalar", skip_space_scalar, skip_line_scalar, skip_ident_scalar,
+};
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#include <stdint.h>
+
+// Find the first byte at or after p whose bit is clear in the match mask
+// computed by MATCH over a block of WIDTH bytes. Most runs are short, so
+// the first block is loaded unaligned straight from p unless that load
+// could cross into the next page; later blocks are aligned.
+#define SCAN_LOOP(WIDTH, VEC, LOADU, LOAD, MATCH, MOVEMASK, ALL)      \
+    do {                                                              \
+        uint64_t stop;                                                \
+        char *base;                                                   \
+        if (((uintptr_t)p & 4095) <= 4096 - WIDTH) {                  \
+            stop = ~(uint64_t)(uint32_t)MOVEMASK(MATCH(LOADU((VEC *)p))) & ALL; \
+            if (stop)                                                 \
+                return p + __builtin_ctzll(stop);                     \
+            base = (char *)((uintptr_t)(p + WIDTH) & ~(uintptr_t)(WIDTH - 1)); \
+        } else {                                                      \
+            uintptr_t off = (uintptr_t)p & (WIDTH - 1);               \
+            base = p - off;                                           \
+            stop = ~(uint64_t)(uint32_t)MOVEMASK(MATCH(LOAD((VEC *)base))) & ALL; \
+            stop >>= off;                                             \
+            if (stop)                                                 \
+                return p + __builtin_ctzll(stop);                     \
+            base += WIDTH;                                            \
+        }                                                             \
+        for (;; base += WIDTH) {                                      \
+            stop = ~(uint64_t)(uint32_t)MOVEMASK(MATCH(LOAD((VEC *)base))) & ALL; \
+            if (stop)                                                 \
+                return base + __builtin_ctzll(stop);                  \
+        }                                                             \
+    } while (0)
+
+// SSE2 is part of the x86-64 baseline, so it needs no target attribute.
+// Unsigned range checks are done as signed compares after adding a bias
+// that moves the low end of the range to -128.
+
+static __m128i sse2_in_range(__m128i v, char lo, int n) {
+    __m128i s = _mm_add_epi8(v, _mm_set1_epi8((char)(0x80 - lo)));
+    return _mm_cmplt_epi8(s, _mm_set1_epi8((char)(0x80 + n)));
+}
+
+static __m128i sse2_space(__m128i v) {
+    return _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                        sse2_in_range(v, '\t', 5));
+}
+
+static __m128i sse2_not_eol(__m128i v) {
+    __m128i eol = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')),
+                               _mm_cmpeq_epi8(v, _mm_setzero_si128()));
+    return _mm_xor_si128(eol, _mm_set1_epi8(-1));
+}
+
+static __m128i sse2_ident(__m128i v) {
+    // Setting bit 5 folds upper case onto lower case
+    __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    __m128i alpha = sse2_in_range(lower, 'a', 26);
+    __m128i digit = sse2_in_range(v, '0', 10);
+    __m128i under = _mm_cmpeq_epi8(v, _mm_set1_epi8('_'));
+    return _mm_or_si128(_mm_or_si128(alpha, digit), under);
+}
+
+static char *skip_space_sse2(char *p) {
+    SCAN_LOOP(16, __m128i, _mm_loadu_si128, _mm_load_si128, sse2_space, _mm_movemask_epi8, 0xffff);
+}
+
+static char *skip_line_sse2(char *p) {
+    SCAN_LOOP(16, __m128i, _mm_loadu_si128, _mm_load_si128, sse2_not_eol, _mm_movemask_epi8, 0xffff);
+}
+
+static char *skip_ident_sse2(char *p) {
+    SCAN_LOOP(16, __m128i, _mm_loadu_si128, _mm_load_si128, sse2_ident, _mm_movemask_epi8, 0xffff);
+}
+
+static Scanner sse2_scanner = {
+    "sse2", skip_space_sse2, skip_line_sse2, skip_ident_sse2,
+};
+
+#define AVX2 __attribute__((target("avx2")))
+
+AVX2 static __m256i avx2_in_range(__m256i v, char lo, int n) {
+    __m256i s = _mm256_add_epi8(v, _mm256_set1_epi8((char)(0x80 - lo)));
+    return _mm256_cmpgt_epi8(_mm256_set1_epi8((char)(0x80 + n)), s);
+}
+
+AVX2 static __m256i avx2_space(__m256i v) {
+    return _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                           avx2_in_range(v, '\t', 5));
+}
+
+AVX2 static __m256i avx2_not_eol(__m256i v) {
+    __m256i eol = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')),
+                                  _mm256_cmpeq_epi8(v, _mm256_setzero_si256()));
+    return _mm256_xor_si256(eol, _mm256_set1_epi8(-1));
+}
+
+AVX2 static __m256i avx2_ident(__m256i v) {
+    __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+    __m256i alpha = avx2_in_range(lower, 'a', 26);
+    __m256i digit = avx2_in_range(v, '0', 10);
+    __m256i under = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_'));
+    return _mm256_or_si256(_mm256_or_si256(alpha, digit), under);
+}
+
+AVX2 static char *skip_space_avx2(char *p) {
+    SCAN_LOOP(32, __m256i, _mm256_loadu_si256, _mm256_load_si256, avx2_space, _mm256_movemask_epi8, 0xffffffffULL);
+}
+
+AVX2 static char *skip_line_avx2(char *p) {
+    SCAN_LOOP(32, __m256i, _mm256_loadu_si256, _mm256_load_si256, avx2_not_eol, _mm256_movemask_epi8, 0xffffffffULL);
+}
+
+AVX2 static char *skip_ident_avx2(char *p) {
+    SCAN_LOOP(32, __m256i, _mm256_loadu_si256, _mm256_load_si256, avx2_ident, _mm256_movemask_epi8, 0xffffffffULL);
+}
+
+static Scanner avx2_scanner = {
+    "avx2", skip_space_avx2, skip_line_avx2, skip_ident_avx2,
+};
+
+static Scanner *scanners[] = {&avx2_scanner, &sse2_scanner, &scalar_scanner};
+
+static int supported(Scanner *s) {
+    if (s == &avx2_scanner)
+        return __builtin_cpu_supports("avx2");
+    return 1;
+}
+#else
+static Scanner *scanners[] = {&scalar_scanner};
+
+static int supported(Scanner *s) {
+    return 1;
+}
+#endif
+
+#define NUM_SCANNERS (sizeof(scanners) / sizeof(scanners[0]))
+
+Scanner *scanner;
+
+// Select a scanner by name, or the fastest supported one if name is NULL.
+// Returns 0 if the scanner is unknown or the CPU lacks its instructions.
+int select_scanner(char *name) {
+    for (int i = 0; i < NUM_SCANNERS; i++) {
+        if (name && strcmp(scanners[i]->name, name))
+            continue;
+        if (!supported(scanners[i]))
+            continue;
+        scanner = scanners[i];
+        return 1;
+    }
+    return 0;
+}
+
+// Names of the scanners this CPU can run, fastest first
+int supported_scanners(char **names) {
+    int n = 0;
+    for (int i = 0; i < NUM_SCANNERS; i++)
+        if (supported(scanners[i]))
+            names[n++] = scanners[i]->name;
+    return n;
+}
@@ -0,0 +1,267 @@
+#define _GNU_SOURCE  // memfd_create
+
+#include "compiler.h"
+#include <fcntl.h>
+#include <signal.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Compile server (--server) and its client (--client).
+//
+// The server listens on a Unix domain socket and handles one request per
+// connection, one connection at a time. Between requests it keeps its
+// arenas' chunks, the interned names and the locals table, so a request
+// pays neither process startup nor a cold heap.
+//
+// Request:  int32 argc, then argc strings (int32 length, bytes), then the
+//           source as int64 length and bytes, or length -1 to have the
+//           server read the input path itself.
+// Response: int32 exit status, then diagnostics and output, each as int64
+//           length and bytes.
+//
+// The arguments are an ordinary command line for one file. The server
+// compiles with standard output and standard error redirected to memory
+// files and sends both back; the client writes the output where the
+// command line says (-o, or the default for -c), so it works as a drop-in
+// replacement for the plain command.
+
+static void read_full(int fd, void *buf, long len) {
+    char *p = buf;
+    while (len > 0) {
+        ssize_t n = read(fd, p, len);
+        if (n <= 0)
+            error("Connection closed");
+        p += n;
+        len -= n;
+    }
+}
+
+static void write_full(int fd, void *buf, long len) {
+    char *p = buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0)
+            error("Write failed");
+        p += n;
+        len -= n;
+    }
+}
+
+static int32_t read_int32(int fd) {
+    int32_t val;
+    read_full(fd, &val, sizeof(val));
+    return val;
+}
+
+static int64_t read_int64(int fd) {
+    int64_t val;
+    read_full(fd, &val, sizeof(val));
+    return val;
+}
+
+static void write_int32(int fd, int32_t val) {
+    write_full(fd, &val, sizeof(val));
+}
+
+static void write_int64(int fd, int64_t val) {
+    write_full(fd, &val, sizeof(val));
+}
+
+// Longest argument and source a request may send
+#define MAX_ARG 65536
+#define MAX_SOURCE (1L << 30)
+
+// The request being handled. It is freed by the serve loop, since an
+// error in the middle of a request leaves handle() by longjmp.
+typedef struct Request {
+    int argc;
+    char **argv;
+    char *source;
+} Request;
+
+static Request request;
+
+static void free_request() {
+    for (int i = 0; i < request.argc; i++)
+        free(request.argv[i]);
+    free(request.argv);
+    free(request.source);
+    request = (Request){0};
+}
+
+// Read len bytes into a new NUL-terminated buffer. len comes from the
+// client, so it is checked against max before anything is allocated.
+static char *read_bytes(int fd, long len, long max) {
+    if (len < 0 || len > max)
+        error("Bad request");
+    char *buf = malloc(len + 1);
+    if (!buf)
+        error("Out of memory");
+    read_full(fd, buf, len);
+    buf[len] = '\0';
+    return buf;
+}
+
+static struct sockaddr_un socket_address(char *path) {
+    struct sockaddr_un addr = {0};
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path))
+        error("Socket path too long: %s", path);
+    strcpy(addr.sun_path, path);
+    return addr;
+}
+
+// Send everything written to the memory file fd, and empty it
+static void send_file(int sock, int fd) {
+    off_t len = lseek(fd, 0, SEEK_CUR);
+    write_int64(sock, len);
+    off_t offset = 0;
+    while (offset < len)
+        if (sendfile(sock, fd, &offset, len - offset) <= 0)
+            error("Send failed");
+    ftruncate(fd, 0);
+    lseek(fd, 0, SEEK_SET);
+}
+
+// Receive one request, compile it and send the response
+static void handle(int sock, int out_fd, int diag_fd) {
+    int argc = read_int32(sock);
+    if (argc < 1 || argc > 4096)
+        error("Bad request");
+    request.argv = calloc(argc + 1, sizeof(char *));
+    if (!request.argv)
+        error("Out of memory");
+    request.argc = argc;
+    for (int i = 0; i < argc; i++)
+        request.argv[i] = read_bytes(sock, read_int32(sock), MAX_ARG);
+    int64_t source_len = read_int64(sock);
+    if (source_len != -1)
+        request.source = read_bytes(sock, source_len, MAX_SOURCE);
+
+    // The compilation takes over the source
+    char *source = request.source;
+    request.source = NULL;
+
+    // Compile with standard output and standard error captured
+    fflush(stdout);
+    int saved_out = dup(1);
+    int saved_err = dup(2);
+    dup2(out_fd, 1);
+    dup2(diag_fd, 2);
+    int status = compile_request(argc, request.argv, source);
+    fflush(stdout);
+    dup2(saved_out, 1);
+    dup2(saved_err, 2);
+    close(saved_out);
+    close(saved_err);
+
+    // A failed compilation has no output, only diagnostics
+    if (status) {
+        ftruncate(out_fd, 0);
+        lseek(out_fd, 0, SEEK_SET);
+    }
+    write_int32(sock, status);
+    send_file(sock, diag_fd);
+    send_file(sock, out_fd);
+}
+
+// Serve compile requests on the Unix socket at path until killed
+void serve(char *path) {
+    struct sockaddr_un addr = socket_address(path);
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0)
+        error("Cannot create socket");
+    unlink(path);
+    if (bind(listener, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(listener, 64) < 0)
+        error("Cannot listen on %s", path);
+
+    int out_fd = memfd_create("acompiler-output", 0);
+    int diag_fd = memfd_create("acompiler-diagnostics", 0);
+    if (out_fd < 0 || diag_fd < 0)
+        error("Cannot create memory files");
+
+    // A client that goes away must not take the server with it
+    signal(SIGPIPE, SIG_IGN);
+    fprintf(stderr, "acompiler: serving on %s\n", path);
+
+    for (;;) {
+        int sock = accept(listener, NULL, NULL);
+        if (sock < 0)
+            continue;
+
+        // A broken request only ends its connection
+        jmp_buf on_error;
+        error_jmp = &on_error;
+        if (!setjmp(on_error))
+            handle(sock, out_fd, diag_fd);
+        error_jmp = NULL;
+        free_request();
+        ftruncate(out_fd, 0);
+        lseek(out_fd, 0, SEEK_SET);
+        ftruncate(diag_fd, 0);
+        lseek(diag_fd, 0, SEEK_SET);
+        close(sock);
+    }
+}
+
+// Copy len bytes from the socket to fd
+static void receive(int sock, int fd, long len) {
+    char buf[65536];
+    while (len > 0) {
+        long n = len < sizeof(buf) ? len : sizeof(buf);
+        read_full(sock, buf, n);
+        write_full(fd, buf, n);
+        len -= n;
+    }
+}
+
+// Have the server at socket_path compile source_path as argv says, and
+// write the result to output (standard output if NULL). Returns the exit
+// status.
+int client(char *socket_path, int argc, char **argv, char *source_path, char *output) {
+    struct sockaddr_un addr = socket_address(socket_path);
+    int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock < 0 || connect(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+        error("Cannot connect to %s", socket_path);
+
+    // Send the source rather than the path, since the server may run in
+    // another directory
+    FILE *fp = fopen(source_path, "r");
+    if (!fp)
+        error("Cannot open %s", source_path);
+    fseek(fp, 0, SEEK_END);
+    long len = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    char *source = malloc(len + 1);
+    if (!source || fread(source, 1, len, fp) != len)
+        error("Cannot read %s", source_path);
+    fclose(fp);
+
+    write_int32(sock, argc);
+    for (int i = 0; i < argc; i++) {
+        write_int32(sock, strlen(argv[i]));
+        write_full(sock, argv[i], strlen(argv[i]));
+    }
+    write_int64(sock, len);
+    write_full(sock, source, len);
+    free(source);
+
+    int status = read_int32(sock);
+    receive(sock, 2, read_int64(sock));
+    long out_len = read_int64(sock);
+    int fd = 1;
+    if (output && !status) {
+        fd = open(output, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+            error("Cannot open %s", output);
+    }
+    receive(sock, fd, out_len);
+    if (fd != 1)
+        close(fd);
+    close(sock);
+    return status;
+}
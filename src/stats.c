@@ -0,0 +1,189 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "compiler.h"
+#include <sys/resource.h>
+#include <time.h>
+
+// Compile statistics (--stats, -ftime-report).
+//
+// The driver marks the end of each phase of a compilation with
+// stats_phase(), which charges the wall and CPU time since the previous
+// mark to that phase. stats_count() counts tokens, functions and AST nodes
+// by kind once the program is parsed. stats_report() prints all of it with
+// the peak RSS and the arenas' allocation counts, either as a table or as
+// one JSON object per line for dashboards.
+//
+// CPU time is that of the whole process, so that it includes code
+// generation threads (-j), except in batch mode, where every file is
+// compiled on a thread of its own and gets that thread's CPU time.
+
+static char *phase_names[NUM_PHASES] = {
+    [PHASE_READ] = "read",
+    [PHASE_TOKENIZE] = "tokenize",
+    [PHASE_PARSE] = "parse",
+    [PHASE_FOLD] = "fold",
+    [PHASE_IR] = "ir",
+    [PHASE_CODEGEN] = "codegen",
+};
+
+#define NUM_NODE_KINDS (ND_STRING + 1)
+
+static char *node_names[NUM_NODE_KINDS] = {
+    [ND_ADD] = "add", [ND_SUB] = "sub", [ND_MUL] = "mul", [ND_DIV] = "div",
+    [ND_MOD] = "mod", [ND_NEG] = "neg", [ND_EQ] = "eq", [ND_NE] = "ne",
+    [ND_LT] = "lt", [ND_LE] = "le", [ND_ASSIGN] = "assign",
+    [ND_LVAR] = "lvar", [ND_NUM] = "num", [ND_RETURN] = "return",
+    [ND_IF] = "if", [ND_WHILE] = "while", [ND_FOR] = "for",
+    [ND_BLOCK] = "block", [ND_FUNCALL] = "funcall", [ND_ADDR] = "addr",
+    [ND_DEREF] = "deref", [ND_SIZEOF] = "sizeof", [ND_STRING] = "string",
+};
+
+// Statistics of the compilation on this thread
+typedef struct Stats {
+    int active;
+    clockid_t cpu_clock;
+    double last_wall;
+    double last_cpu;
+    double wall[NUM_PHASES];   // Milliseconds
+    double cpu[NUM_PHASES];
+    long tokens;
+    long functions;
+    long nodes[NUM_NODE_KINDS];
+    long total_nodes;
+} Stats;
+
+static _Thread_local Stats stats;
+
+static double clock_ms(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+// Start collecting statistics of a compilation. thread_cpu counts only
+// the CPU time of the calling thread.
+void stats_start(int thread_cpu) {
+    stats = (Stats){0};
+    stats.active = 1;
+    stats.cpu_clock = thread_cpu ? CLOCK_THREAD_CPUTIME_ID : CLOCK_PROCESS_CPUTIME_ID;
+    stats.last_wall = clock_ms(CLOCK_MONOTONIC);
+    stats.last_cpu = clock_ms(stats.cpu_clock);
+}
+
+// End phase, charging it the time since the previous mark
+void stats_phase(Phase phase) {
+    if (!stats.active)
+        return;
+    double wall = clock_ms(CLOCK_MONOTONIC);
+    double cpu = clock_ms(stats.cpu_clock);
+    stats.wall[phase] += wall - stats.last_wall;
+    stats.cpu[phase] += cpu - stats.last_cpu;
+    stats.last_wall = wall;
+    stats.last_cpu = cpu;
+}
+
+static void count_node(Node *node) {
+    if (!node)
+        return;
+    stats.nodes[node->kind]++;
+    stats.total_nodes++;
+    count_node(node->lhs);
+    count_node(node->rhs);
+    count_node(node->cond);
+    count_node(node->then);
+    count_node(node->els);
+    count_node(node->init);
+    count_node(node->inc);
+    for (int i = 0; i < node->num_stmts; i++)
+        count_node(node->stmts[i]);
+    for (int i = 0; i < node->num_args; i++)
+        count_node(node->args[i]);
+}
+
+// Count the tokens, and the functions and nodes of the parsed program.
+// The time this takes is not charged to any phase.
+void stats_count(Function *prog) {
+    if (!stats.active)
+        return;
+    stats.tokens = tokens.count;
+    for (Function *fn = prog; fn; fn = fn->next) {
+        stats.functions++;
+        for (int i = 0; i < fn->num_params; i++)
+            count_node(fn->params[i]);
+        for (int i = 0; i < fn->num_stmts; i++)
+            count_node(fn->stmts[i]);
+    }
+    stats.last_wall = clock_ms(CLOCK_MONOTONIC);
+    stats.last_cpu = clock_ms(stats.cpu_clock);
+}
+
+static void json_string(char *s) {
+    fputc('"', stderr);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\')
+            fprintf(stderr, "\\%c", *s);
+        else if ((unsigned char)*s < 0x20)
+            fprintf(stderr, "\\u%04x", *s);
+        else
+            fputc(*s, stderr);
+    }
+    fputc('"', stderr);
+}
+
+static void report_json(char *path, Arena **arenas, double wall, double cpu, long rss) {
+    fprintf(stderr, "{\"file\": ");
+    json_string(path);
+    fprintf(stderr, ", \"phases\": {");
+    for (int i = 0; i < NUM_PHASES; i++)
+        fprintf(stderr, "%s\"%s\": {\"wall_ms\": %.3f, \"cpu_ms\": %.3f}",
+                i ? ", " : "", phase_names[i], stats.wall[i], stats.cpu[i]);
+    fprintf(stderr, "}, \"wall_ms\": %.3f, \"cpu_ms\": %.3f", wall, cpu);
+    fprintf(stderr, ", \"tokens\": %ld, \"functions\": %ld", stats.tokens, stats.functions);
+    fprintf(stderr, ", \"nodes\": {\"total\": %ld", stats.total_nodes);
+    for (int i = 0; i < NUM_NODE_KINDS; i++)
+        fprintf(stderr, ", \"%s\": %ld", node_names[i], stats.nodes[i]);
+    fprintf(stderr, "}, \"peak_rss_kb\": %ld, \"arenas\": {", rss);
+    for (int i = 0; i < NUM_ARENAS; i++)
+        fprintf(stderr, "%s\"%s\": {\"allocs\": %ld, \"peak\": %zu, \"reserved\": %zu}",
+                i ? ", " : "", arenas[i]->name, arenas[i]->num_allocs,
+                arenas[i]->peak, arenas[i]->capacity);
+    fprintf(stderr, "}}\n");
+}
+
+static void report_text(char *path, Arena **arenas, double wall, double cpu, long rss) {
+    fprintf(stderr, "%s:\n", path);
+    fprintf(stderr, "%-10s %12s %12s\n", "phase", "wall ms", "cpu ms");
+    for (int i = 0; i < NUM_PHASES; i++)
+        fprintf(stderr, "%-10s %12.3f %12.3f\n", phase_names[i], stats.wall[i], stats.cpu[i]);
+    fprintf(stderr, "%-10s %12.3f %12.3f\n", "total", wall, cpu);
+    fprintf(stderr, "tokens %ld, functions %ld, nodes %ld:", stats.tokens,
+            stats.functions, stats.total_nodes);
+    for (int i = 0; i < NUM_NODE_KINDS; i++)
+        if (stats.nodes[i])
+            fprintf(stderr, " %s %ld", node_names[i], stats.nodes[i]);
+    fprintf(stderr, "\npeak RSS %ld KB; arena allocations:", rss);
+    for (int i = 0; i < NUM_ARENAS; i++)
+        fprintf(stderr, " %s %ld", arenas[i]->name, arenas[i]->num_allocs);
+    fprintf(stderr, "\n");
+}
+
+// Print the statistics of the compilation of path to stderr, as JSON or
+// as a table
+void stats_report(char *path, int json) {
+    if (!stats.active)
+        return;
+    stats.active = 0;
+
+    double wall = 0, cpu = 0;
+    for (int i = 0; i < NUM_PHASES; i++) {
+        wall += stats.wall[i];
+        cpu += stats.cpu[i];
+    }
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    Arena *arenas[] = THREAD_ARENAS;
+    if (json)
+        report_json(path, arenas, wall, cpu, usage.ru_maxrss);
+    else
+        report_text(path, arenas, wall, cpu, usage.ru_maxrss);
+}
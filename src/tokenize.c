@@ -1,16 +1,29 @@
 #include "compiler.h"
 #include <stdarg.h>
 
-char *user_input;
-Token *token;
+_Thread_local char *input_path;
+_Thread_local jmp_buf *error_jmp;
+_Thread_local char *user_input;
+_Thread_local TokenArray tokens;
+_Thread_local int tok;
+
+// Abandon the current compilation: return to the driver if it is
+// compiling several files, otherwise exit
+void fail() {
+    if (error_jmp)
+        longjmp(*error_jmp, 1);
+    exit(1);
+}
 
 // Error reporting
 void error(char *fmt, ...) {
     va_list ap;
     va_start(ap, fmt);
+    if (input_path)
+        fprintf(stderr, "%s: ", input_path);
     vfprintf(stderr, fmt, ap);
     fprintf(stderr, "\n");
-    exit(1);
+    fail();
 }
 
 void error_at(char *loc, char *fmt, ...) {
@@ -18,259 +31,276 @@ void error_at(char *loc, char *fmt, ...) {
     va_start(ap, fmt);
     
     int pos = loc - user_input;
+    if (input_path)
+        fprintf(stderr, "%s:\n", input_path);
     fprintf(stderr, "%s\n", user_input);
     fprintf(stderr, "%*s", pos, "");
     fprintf(stderr, "^ ");
     vfprintf(stderr, fmt, ap);
     fprintf(stderr, "\n");
-    exit(1);
+    fail();
 }
 
-// Create a new token
-Token *new_token(TokenKind kind, Token *cur, char *str, int len) {
-    Token *tok = calloc(1, sizeof(Token));
-    tok->kind = kind;
-    tok->str = str;
-    tok->len = len;
-    cur->next = tok;
-    return tok;
+// Grow the token arrays, doubling their capacity
+static void grow_tokens(int min_capacity) {
+    int cap = tokens.capacity ? tokens.capacity * 2 : 64;
+    if (cap < min_capacity)
+        cap = min_capacity;
+    
+    unsigned char *kind = arena_alloc(&token_arena, cap);
+    int *offset = arena_alloc(&token_arena, cap * sizeof(int));
+    int *len = arena_alloc(&token_arena, cap * sizeof(int));
+    int *val = arena_alloc(&token_arena, cap * sizeof(int));
+    if (tokens.count) {
+        memcpy(kind, tokens.kind, tokens.count);
+        memcpy(offset, tokens.offset, tokens.count * sizeof(int));
+        memcpy(len, tokens.len, tokens.count * sizeof(int));
+        memcpy(val, tokens.val, tokens.count * sizeof(int));
+    }
+    tokens.kind = kind;
+    tokens.offset = offset;
+    tokens.len = len;
+    tokens.val = val;
+    tokens.capacity = cap;
 }
 
-// Check if string starts with expected
-int startswith(char *p, char *q) {
-    return strncmp(p, q, strlen(q)) == 0;
+// Append a new token and return its index
+static int new_token(TokenKind kind, char *str, int len) {
+    if (tokens.count == tokens.capacity)
+        grow_tokens(0);
+    int i = tokens.count++;
+    tokens.kind[i] = kind;
+    tokens.offset[i] = str - user_input;
+    tokens.len[i] = len;
+    return i;
 }
 
+// Source text of a token
+char *tok_str(int i) {
+    return user_input + tokens.offset[i];
+}
+
+// Character classes for the lexer's dispatch table
+enum {
+    CC_INVALID,
+    CC_SPACE,   // Whitespace
+    CC_IDENT,   // Letter or underscore
+    CC_DIGIT,   // 0-9
+    CC_QUOTE,   // "
+    CC_SLASH,   // / (division or comment)
+    CC_PUNCT,   // Single-character operator, maybe followed by '='
+};
+
+static const unsigned char char_class[256] = {
+    [' '] = CC_SPACE, ['\t'] = CC_SPACE, ['\n'] = CC_SPACE,
+    ['\v'] = CC_SPACE, ['\f'] = CC_SPACE, ['\r'] = CC_SPACE,
+    ['a'] = CC_IDENT, ['b'] = CC_IDENT, ['c'] = CC_IDENT, ['d'] = CC_IDENT,
+    ['e'] = CC_IDENT, ['f'] = CC_IDENT, ['g'] = CC_IDENT, ['h'] = CC_IDENT,
+    ['i'] = CC_IDENT, ['j'] = CC_IDENT, ['k'] = CC_IDENT, ['l'] = CC_IDENT,
+    ['m'] = CC_IDENT, ['n'] = CC_IDENT, ['o'] = CC_IDENT, ['p'] = CC_IDENT,
+    ['q'] = CC_IDENT, ['r'] = CC_IDENT, ['s'] = CC_IDENT, ['t'] = CC_IDENT,
+    ['u'] = CC_IDENT, ['v'] = CC_IDENT, ['w'] = CC_IDENT, ['x'] = CC_IDENT,
+    ['y'] = CC_IDENT, ['z'] = CC_IDENT,
+    ['A'] = CC_IDENT, ['B'] = CC_IDENT, ['C'] = CC_IDENT, ['D'] = CC_IDENT,
+    ['E'] = CC_IDENT, ['F'] = CC_IDENT, ['G'] = CC_IDENT, ['H'] = CC_IDENT,
+    ['I'] = CC_IDENT, ['J'] = CC_IDENT, ['K'] = CC_IDENT, ['L'] = CC_IDENT,
+    ['M'] = CC_IDENT, ['N'] = CC_IDENT, ['O'] = CC_IDENT, ['P'] = CC_IDENT,
+    ['Q'] = CC_IDENT, ['R'] = CC_IDENT, ['S'] = CC_IDENT, ['T'] = CC_IDENT,
+    ['U'] = CC_IDENT, ['V'] = CC_IDENT, ['W'] = CC_IDENT, ['X'] = CC_IDENT,
+    ['Y'] = CC_IDENT, ['Z'] = CC_IDENT, ['_'] = CC_IDENT,
+    ['0'] = CC_DIGIT, ['1'] = CC_DIGIT, ['2'] = CC_DIGIT, ['3'] = CC_DIGIT,
+    ['4'] = CC_DIGIT, ['5'] = CC_DIGIT, ['6'] = CC_DIGIT, ['7'] = CC_DIGIT,
+    ['8'] = CC_DIGIT, ['9'] = CC_DIGIT,
+    ['"'] = CC_QUOTE, ['/'] = CC_SLASH,
+    ['+'] = CC_PUNCT, ['-'] = CC_PUNCT, ['*'] = CC_PUNCT, ['%'] = CC_PUNCT,
+    ['<'] = CC_PUNCT, ['>'] = CC_PUNCT, ['='] = CC_PUNCT, ['!'] = CC_PUNCT,
+    ['('] = CC_PUNCT, [')'] = CC_PUNCT, ['{'] = CC_PUNCT, ['}'] = CC_PUNCT,
+    ['['] = CC_PUNCT, [']'] = CC_PUNCT, [';'] = CC_PUNCT, [','] = CC_PUNCT,
+    ['&'] = CC_PUNCT,
+};
+
+// Token kind of a punctuator on its own, and when followed by '='.
+// Entries are stored as kind + 1 so that 0 means "not a token".
+static const unsigned char punct_kind[256] = {
+    ['+'] = TK_PLUS + 1, ['-'] = TK_MINUS + 1, ['*'] = TK_MUL + 1,
+    ['/'] = TK_DIV + 1, ['%'] = TK_MOD + 1, ['<'] = TK_LT + 1,
+    ['>'] = TK_GT + 1, ['='] = TK_ASSIGN + 1, ['('] = TK_LPAREN + 1,
+    [')'] = TK_RPAREN + 1, ['{'] = TK_LBRACE + 1, ['}'] = TK_RBRACE + 1,
+    ['['] = TK_LBRACKET + 1, [']'] = TK_RBRACKET + 1,
+    [';'] = TK_SEMICOLON + 1, [','] = TK_COMMA + 1, ['&'] = TK_AMPERSAND + 1,
+};
+
+static const unsigned char punct_eq_kind[256] = {
+    ['='] = TK_EQ + 1, ['!'] = TK_NE + 1, ['<'] = TK_LE + 1, ['>'] = TK_GE + 1,
+};
+
 // Check if character is valid for identifier
 int is_alnum(char c) {
-    return ('a' <= c && c <= 'z') ||
-           ('A' <= c && c <= 'Z') ||
-           ('0' <= c && c <= '9') ||
-           (c == '_');
+    unsigned char cc = char_class[(unsigned char)c];
+    return cc == CC_IDENT || cc == CC_DIGIT;
+}
+
+// Perfect hash of the keywords: (first + 6 * last + len) & 15 is distinct
+// for every keyword, so a lookup is one hash and one comparison
+typedef struct Keyword {
+    char *name;
+    int len;
+    TokenKind kind;
+} Keyword;
+
+static const Keyword keywords[16] = {
+    [2] = {"void", 4, TK_VOID},
+    [3] = {"char", 4, TK_CHAR},
+    [4] = {"int", 3, TK_INT},
+    [5] = {"for", 3, TK_FOR},
+    [7] = {"else", 4, TK_ELSE},
+    [10] = {"while", 5, TK_WHILE},
+    [12] = {"return", 6, TK_RETURN},
+    [13] = {"sizeof", 6, TK_SIZEOF},
+    [15] = {"if", 2, TK_IF},
+};
+
+static int keyword_hash(char *p, int len) {
+    unsigned char first = p[0];
+    unsigned char last = p[len - 1];
+    return (first + last * 6 + len) & 15;
 }
 
 // Check if keyword
 TokenKind check_keyword(char *p, int len) {
-    if (len == 6 && strncmp(p, "return", 6) == 0)
-        return TK_RETURN;
-    if (len == 2 && strncmp(p, "if", 2) == 0)
-        return TK_IF;
-    if (len == 4 && strncmp(p, "else", 4) == 0)
-        return TK_ELSE;
-    if (len == 5 && strncmp(p, "while", 5) == 0)
-        return TK_WHILE;
-    if (len == 3 && strncmp(p, "for", 3) == 0)
-        return TK_FOR;
-    if (len == 3 && strncmp(p, "int", 3) == 0)
-        return TK_INT;
-    if (len == 4 && strncmp(p, "char", 4) == 0)
-        return TK_CHAR;
-    if (len == 4 && strncmp(p, "void", 4) == 0)
-        return TK_VOID;
-    if (len == 6 && strncmp(p, "sizeof", 6) == 0)
-        return TK_SIZEOF;
+    const Keyword *kw = &keywords[keyword_hash(p, len)];
+    if (kw->len == len && !memcmp(p, kw->name, len))
+        return kw->kind;
     return TK_IDENT;
 }
 
-// Tokenize input string
-Token *tokenize(char *p) {
-    Token head;
-    head.next = NULL;
-    Token *cur = &head;
+// Tokenize input string into the tokens array
+void tokenize(char *p) {
+    if (!scanner)
+        select_scanner(NULL);
+    
+    // Dense code averages a token every two to three bytes
+    tokens.count = 0;
+    tokens.capacity = 0;
+    grow_tokens(strlen(p) / 2 + 16);
     
     while (*p) {
-        // Skip whitespace
-        if (isspace(*p)) {
+        unsigned char c = *p;
+        
+        switch (char_class[c]) {
+        case CC_SPACE:
+            // Single separators are the common case; only longer runs
+            // are worth a call into the scanner
             p++;
+            if (char_class[(unsigned char)*p] == CC_SPACE)
+                p = scanner->skip_space(p);
             continue;
-        }
         
-        // Skip line comments
-        if (startswith(p, "//")) {
-            p += 2;
-            while (*p != '\n')
-                p++;
+        case CC_IDENT: {
+            char *start = p++;
+            if (is_alnum(*p))
+                p = scanner->skip_ident(p);
+            int len = p - start;
+            TokenKind kind = check_keyword(start, len);
+            int i = new_token(kind, start, len);
+            if (kind == TK_IDENT)
+                tokens.val[i] = intern(start, len);
             continue;
         }
         
-        // Skip block comments
-        if (startswith(p, "/*")) {
-            char *q = strstr(p + 2, "*/");
-            if (!q)
-                error_at(p, "Unclosed block comment");
-            p = q + 2;
+        case CC_DIGIT: {
+            int i = new_token(TK_NUM, p, 0);
+            char *q = p;
+            tokens.val[i] = strtol(p, &p, 10);
+            tokens.len[i] = p - q;
             continue;
         }
         
-        // String literal
-        if (*p == '"') {
+        case CC_QUOTE: {
             char *start = p;
             p++;
             while (*p != '"') {
                 if (*p == '\0')
                     error_at(start, "Unclosed string literal");
-                if (*p == '\\')
+                if (*p == '\\' && p[1])
                     p++;
                 p++;
             }
             p++;
-            cur = new_token(TK_STRING, cur, start, p - start);
-            continue;
-        }
-        
-        // Two-character operators
-        if (startswith(p, "==")) {
-            cur = new_token(TK_EQ, cur, p, 2);
-            p += 2;
-            continue;
-        }
-        if (startswith(p, "!=")) {
-            cur = new_token(TK_NE, cur, p, 2);
-            p += 2;
-            continue;
-        }
-        if (startswith(p, "<=")) {
-            cur = new_token(TK_LE, cur, p, 2);
-            p += 2;
-            continue;
-        }
-        if (startswith(p, ">=")) {
-            cur = new_token(TK_GE, cur, p, 2);
-            p += 2;
+            new_token(TK_STRING, start, p - start);
             continue;
         }
         
-        // Single-character operators
-        if (*p == '+') {
-            cur = new_token(TK_PLUS, cur, p++, 1);
-            continue;
-        }
-        if (*p == '-') {
-            cur = new_token(TK_MINUS, cur, p++, 1);
-            continue;
-        }
-        if (*p == '*') {
-            cur = new_token(TK_MUL, cur, p++, 1);
-            continue;
-        }
-        if (*p == '/') {
-            cur = new_token(TK_DIV, cur, p++, 1);
-            continue;
-        }
-        if (*p == '%') {
-            cur = new_token(TK_MOD, cur, p++, 1);
-            continue;
-        }
-        if (*p == '<') {
-            cur = new_token(TK_LT, cur, p++, 1);
-            continue;
-        }
-        if (*p == '>') {
-            cur = new_token(TK_GT, cur, p++, 1);
-            continue;
-        }
-        if (*p == '=') {
-            cur = new_token(TK_ASSIGN, cur, p++, 1);
-            continue;
-        }
-        if (*p == '(') {
-            cur = new_token(TK_LPAREN, cur, p++, 1);
-            continue;
-        }
-        if (*p == ')') {
-            cur = new_token(TK_RPAREN, cur, p++, 1);
-            continue;
-        }
-        if (*p == '{') {
-            cur = new_token(TK_LBRACE, cur, p++, 1);
-            continue;
-        }
-        if (*p == '}') {
-            cur = new_token(TK_RBRACE, cur, p++, 1);
-            continue;
-        }
-        if (*p == '[') {
-            cur = new_token(TK_LBRACKET, cur, p++, 1);
-            continue;
-        }
-        if (*p == ']') {
-            cur = new_token(TK_RBRACKET, cur, p++, 1);
-            continue;
-        }
-        if (*p == ';') {
-            cur = new_token(TK_SEMICOLON, cur, p++, 1);
-            continue;
-        }
-        if (*p == ',') {
-            cur = new_token(TK_COMMA, cur, p++, 1);
-            continue;
-        }
-        if (*p == '&') {
-            cur = new_token(TK_AMPERSAND, cur, p++, 1);
-            continue;
-        }
-        
-        // Identifier or keyword
-        if (isalpha(*p) || *p == '_') {
-            char *start = p;
-            while (is_alnum(*p))
-                p++;
-            int len = p - start;
-            TokenKind kind = check_keyword(start, len);
-            cur = new_token(kind, cur, start, len);
+        case CC_SLASH:
+            // Skip line comments
+            if (p[1] == '/') {
+                p = scanner->skip_line(p + 2);
+                continue;
+            }
+            
+            // Skip block comments
+            if (p[1] == '*') {
+                char *q = strstr(p + 2, "*/");
+                if (!q)
+                    error_at(p, "Unclosed block comment");
+                p = q + 2;
+                continue;
+            }
+            
+            new_token(TK_DIV, p++, 1);
             continue;
-        }
         
-        // Number
-        if (isdigit(*p)) {
-            cur = new_token(TK_NUM, cur, p, 0);
-            char *q = p;
-            cur->val = strtol(p, &p, 10);
-            cur->len = p - q;
-            continue;
+        case CC_PUNCT:
+            // Two-character operators: ==, !=, <=, >=
+            if (p[1] == '=' && punct_eq_kind[c]) {
+                new_token(punct_eq_kind[c] - 1, p, 2);
+                p += 2;
+                continue;
+            }
+            if (punct_kind[c]) {
+                new_token(punct_kind[c] - 1, p++, 1);
+                continue;
+            }
+            break;
         }
         
         error_at(p, "Invalid token");
     }
     
-    new_token(TK_EOF, cur, p, 0);
-    return head.next;
+    new_token(TK_EOF, p, 0);
+    tok = 0;
 }
 
 // Consume a token of expected kind
 int consume(TokenKind kind) {
-    if (token->kind != kind)
+    if (tokens.kind[tok] != kind)
         return 0;
-    token = token->next;
+    tok++;
     return 1;
 }
 
-// Consume identifier token
-Token *consume_ident() {
-    if (token->kind != TK_IDENT)
-        return NULL;
-    Token *tok = token;
-    token = token->next;
-    return tok;
+// Consume identifier token; returns its index, or -1
+int consume_ident() {
+    if (tokens.kind[tok] != TK_IDENT)
+        return -1;
+    return tok++;
 }
 
 // Expect a token of specific kind
 void expect(TokenKind kind) {
-    if (token->kind != kind)
-        error_at(token->str, "Expected different token");
-    token = token->next;
+    if (tokens.kind[tok] != kind)
+        error_at(tok_str(tok), "Expected different token");
+    tok++;
 }
 
 // Expect number token
 int expect_number() {
-    if (token->kind != TK_NUM)
-        error_at(token->str, "Expected a number");
-    int val = token->val;
-    token = token->next;
-    return val;
+    if (tokens.kind[tok] != TK_NUM)
+        error_at(tok_str(tok), "Expected a number");
+    return tokens.val[tok++];
 }
 
 // Check if at end of file
 int at_eof() {
-    return token->kind == TK_EOF;
+    return tokens.kind[tok] == TK_EOF;
 }
@@ -0,0 +1,204 @@
+// Differential test of the lexer's run scanners.
+//
+// Every scanner the CPU supports must find the same run ends as the scalar
+// one, and produce the same token stream on whole sources.
+//
+// Usage: tests/lexdiff [file...]
+
+#define _DEFAULT_SOURCE
+
+#include "../src/compiler.h"
+#include <sys/mman.h>
+
+static int failures;
+
+static Scanner *get_scanner(char *name) {
+    if (!select_scanner(name)) {
+        fprintf(stderr, "scanner %s is not supported\n", name);
+        exit(1);
+    }
+    return scanner;
+}
+
+// Compare run ends at every start position of a buffer
+static void check_runs(Scanner *ref, Scanner *s, char *buf, int len, char *what) {
+    for (int i = 0; i < len; i++) {
+        char *p = buf + i;
+        if (s->skip_space(p) != ref->skip_space(p) ||
+            s->skip_line(p) != ref->skip_line(p) ||
+            s->skip_ident(p) != ref->skip_ident(p)) {
+            fprintf(stderr, "%s: run end differs from scalar at offset %d of %s\n",
+                    s->name, i, what);
+            failures++;
+            return;
+        }
+    }
+}
+
+// Fill len bytes with characters drawn from alphabet, in runs of random length
+static void fill_runs(char *buf, int len, char *alphabet) {
+    int n = strlen(alphabet);
+    int i = 0;
+    while (i < len) {
+        char c = alphabet[rand() % n];
+        int run = rand() % 3 ? rand() % 8 : rand() % 80;
+        for (int j = 0; j <= run && i < len; j++)
+            buf[i++] = c;
+    }
+    buf[len] = '\0';
+}
+
+// Random inputs that end right before an unmapped page, so a scanner that
+// reads across the page boundary crashes the test
+static void check_random(Scanner *ref, Scanner *s) {
+    static char *alphabets[] = {
+        " \t\n\r\v\f",
+        "azAZ_09 ",
+        "abc_xyz019\n ",
+        "a \n/+\x80\xff;",
+        "\t\t\t\t    \n\x01",
+    };
+    char *page = mmap(NULL, 2 * 4096, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (page == MAP_FAILED || mprotect(page + 4096, 4096, PROT_NONE)) {
+        perror("mmap");
+        exit(1);
+    }
+
+    for (int a = 0; a < sizeof(alphabets) / sizeof(alphabets[0]); a++) {
+        for (int trial = 0; trial < 20; trial++) {
+            int len = rand() % 300;
+            char *buf = page + 4096 - len - 1;
+            fill_runs(buf, len, alphabets[a]);
+            check_runs(ref, s, buf, len + 1, "random input");
+        }
+    }
+    munmap(page, 2 * 4096);
+}
+
+typedef struct Snapshot {
+    int count;
+    unsigned char *kind;
+    int *offset;
+    int *len;
+    int *val;
+} Snapshot;
+
+static Snapshot lex(char *input) {
+    arena_reset(&token_arena);
+    tokens.capacity = 0;
+    user_input = input;
+    tokenize(input);
+
+    Snapshot snap = {tokens.count};
+    snap.kind = malloc(tokens.count);
+    snap.offset = malloc(tokens.count * sizeof(int));
+    snap.len = malloc(tokens.count * sizeof(int));
+    snap.val = malloc(tokens.count * sizeof(int));
+    memcpy(snap.kind, tokens.kind, tokens.count);
+    memcpy(snap.offset, tokens.offset, tokens.count * sizeof(int));
+    memcpy(snap.len, tokens.len, tokens.count * sizeof(int));
+    for (int i = 0; i < tokens.count; i++) {
+        int kind = tokens.kind[i];
+        snap.val[i] = kind == TK_NUM || kind == TK_IDENT ? tokens.val[i] : 0;
+    }
+    return snap;
+}
+
+static void free_snapshot(Snapshot *snap) {
+    free(snap->kind);
+    free(snap->offset);
+    free(snap->len);
+    free(snap->val);
+}
+
+// Compare the token streams of a whole source
+static void check_tokens(char *name, char *path, char *input) {
+    select_scanner("scalar");
+    Snapshot ref = lex(input);
+    select_scanner(name);
+    Snapshot got = lex(input);
+
+    int same = ref.count == got.count;
+    for (int i = 0; same && i < ref.count; i++)
+        same = ref.kind[i] == got.kind[i] && ref.offset[i] == got.offset[i] &&
+               ref.len[i] == got.len[i] && ref.val[i] == got.val[i];
+    if (!same) {
+        fprintf(stderr, "%s: token stream of %s differs from scalar\n", name, path);
+        failures++;
+    }
+    free_snapshot(&ref);
+    free_snapshot(&got);
+}
+
+// A random but lexically valid source built from token fragments
+static char *random_source(int num_pieces) {
+    static char *pieces[] = {
+        "x", "ab", "_tmp9", "generated_identifier_with_a_long_name_0123456789",
+        "while", "return", "sizeof", "iff", "int_", "0", "42", "1234567",
+        " ", "  ", "\t", "\n", "\n                                        ",
+        "// line comment\n", "//\n", "/* block */", "\"str\\\"ing\"",
+        "==", "<=", "!=", ">", "=", "+", "-", "*", "/ ", "%", "&", "(", ")",
+        "{", "}", "[", "]", ";", ",",
+    };
+    int n = sizeof(pieces) / sizeof(pieces[0]);
+    char *buf = malloc(num_pieces * 64 + 1);
+    int len = 0;
+    for (int i = 0; i < num_pieces; i++) {
+        char *piece = pieces[rand() % n];
+        memcpy(buf + len, piece, strlen(piece));
+        len += strlen(piece);
+        // Keep adjacent words and numbers apart
+        buf[len++] = " \n\t;"[rand() % 4];
+    }
+    buf[len] = '\0';
+    return buf;
+}
+
+static char *read_file(char *path) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        perror(path);
+        exit(1);
+    }
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    char *buf = calloc(1, size + 1);
+    fread(buf, 1, size, fp);
+    fclose(fp);
+    return buf;
+}
+
+int main(int argc, char **argv) {
+    char *names[MAX_SCANNERS];
+    int num_names = supported_scanners(names);
+    Scanner *ref = get_scanner("scalar");
+
+    srand(1);
+    for (int i = 0; i < num_names; i++) {
+        Scanner *s = get_scanner(names[i]);
+        if (s == ref)
+            continue;
+        check_random(ref, s);
+        for (int trial = 0; trial < 20; trial++) {
+            char *input = random_source(rand() % 2000);
+            check_tokens(names[i], "random source", input);
+            free(input);
+        }
+        for (int j = 1; j < argc; j++) {
+            char *input = read_file(argv[j]);
+            check_runs(ref, s, input, strlen(input) + 1, argv[j]);
+            check_tokens(names[i], argv[j], input);
+            free(input);
+        }
+    }
+
+    if (failures)
+        return 1;
+    printf("lexdiff: ");
+    for (int i = 0; i < num_names; i++)
+        printf("%s%s", i ? ", " : "", names[i]);
+    printf(" agree on %d files and random inputs\n", argc - 1);
+    return 0;
+}
@@ -18,48 +18,294 @@ NC='\033[0m' # No Color
 echo "Running ACompiler test suite..."
 echo "================================"
 
+# Code generation modes; each test must behave the same in all of them.
+# Modes with -c write an object file directly instead of assembly, and
+# --run executes the program in the compiler's own process.
+MODES=("" "--no-regalloc" "--no-fold" "--no-peephole" "--inline-threshold 0" "--ir" "-j 4" "--ir -j 4" "-c" "-c --no-regalloc" "-c --ir" "--run" "--run --ir")
+
 for testfile in $TESTDIR/test*.c; do
     testname=$(basename $testfile .c)
-    echo -n "Testing $testname... "
-    
-    # Compile with our compiler
-    $COMPILER $testfile > $TESTDIR/$testname.s 2>/dev/null || {
-        echo -e "${RED}FAIL${NC} (compilation failed)"
-        FAILED=$((FAILED + 1))
-        continue
-    }
-    
-    # Assemble and link with GCC
-    gcc -static -o $TESTDIR/$testname.out $TESTDIR/$testname.s 2>/dev/null || {
-        echo -e "${RED}FAIL${NC} (assembly failed)"
-        FAILED=$((FAILED + 1))
-        continue
-    }
     
     # Compile directly with GCC
     gcc -static -o $TESTDIR/$testname.gcc.out $testfile 2>/dev/null || {
-        echo -e "${RED}FAIL${NC} (GCC compilation failed)"
+        echo -e "Testing $testname... ${RED}FAIL${NC} (GCC compilation failed)"
         FAILED=$((FAILED + 1))
         continue
     }
     
-    # Run both versions and compare exit codes
     set +e
-    $TESTDIR/$testname.out
-    our_exit=$?
-    
     $TESTDIR/$testname.gcc.out
     gcc_exit=$?
     set -e
     
-    if [ $our_exit -eq $gcc_exit ]; then
-        echo -e "${GREEN}PASS${NC} (exit code: $our_exit)"
+    for mode in "${MODES[@]}"; do
+        echo -n "Testing $testname${mode:+ $mode}... "
+        
+        if [[ $mode == --run* ]]; then
+            set +e
+            $COMPILER $mode $testfile 2>/dev/null
+            our_exit=$?
+            set -e
+        else
+            # Compile with our compiler
+            if [[ $mode == -c* ]]; then
+                output=$TESTDIR/$testname.o
+            else
+                output=$TESTDIR/$testname.s
+            fi
+            $COMPILER $mode -o $output $testfile 2>/dev/null || {
+                echo -e "${RED}FAIL${NC} (compilation failed)"
+                FAILED=$((FAILED + 1))
+                continue
+            }
+            
+            # Assemble (unless already an object file) and link with GCC
+            gcc -static -o $TESTDIR/$testname.out $output 2>/dev/null || {
+                echo -e "${RED}FAIL${NC} (assembly failed)"
+                FAILED=$((FAILED + 1))
+                continue
+            }
+            
+            # Run our version and compare exit codes
+            set +e
+            $TESTDIR/$testname.out
+            our_exit=$?
+            set -e
+        fi
+        
+        if [ $our_exit -eq $gcc_exit ]; then
+            echo -e "${GREEN}PASS${NC} (exit code: $our_exit)"
+            PASSED=$((PASSED + 1))
+        else
+            echo -e "${RED}FAIL${NC} (our exit: $our_exit, gcc exit: $gcc_exit)"
+            FAILED=$((FAILED + 1))
+        fi
+    done
+done
+
+# Batch mode: all tests compiled by one process on several threads must
+# come out the same as when compiled one at a time
+BATCHDIR=$TESTDIR/batch
+rm -rf $BATCHDIR
+mkdir -p $BATCHDIR
+(cd $BATCHDIR && ../../$COMPILER -j 4 ../test*.c) 2>/dev/null
+for testfile in $TESTDIR/test*.c; do
+    testname=$(basename $testfile .c)
+    echo -n "Testing $testname (batch)... "
+    $COMPILER -o $TESTDIR/$testname.s $testfile 2>/dev/null
+    if cmp -s $TESTDIR/$testname.s $BATCHDIR/$testname.s; then
+        echo -e "${GREEN}PASS${NC}"
         PASSED=$((PASSED + 1))
     else
-        echo -e "${RED}FAIL${NC} (our exit: $our_exit, gcc exit: $gcc_exit)"
+        echo -e "${RED}FAIL${NC} (differs from single-file output)"
         FAILED=$((FAILED + 1))
     fi
 done
+rm -rf $BATCHDIR
+
+# Input: standard input through a pipe must compile the same as the
+# mapped file, and so must a file that fills its last page exactly, which
+# leaves no zero fill after it for the terminator
+for testfile in $TESTDIR/test*.c; do
+    testname=$(basename $testfile .c)
+    echo -n "Testing $testname (stdin)... "
+    $COMPILER -o $TESTDIR/$testname.s $testfile 2>/dev/null
+    cat $testfile | $COMPILER -o $TESTDIR/$testname.out - 2>/dev/null
+    if cmp -s $TESTDIR/$testname.s $TESTDIR/$testname.out; then
+        echo -e "${GREEN}PASS${NC}"
+        PASSED=$((PASSED + 1))
+    else
+        echo -e "${RED}FAIL${NC} (differs from file input)"
+        FAILED=$((FAILED + 1))
+    fi
+done
+echo -n "Testing page-sized input... "
+PAGEFILE=$(mktemp --suffix=.c /tmp/acompiler-page.XXXXXX)
+cp $TESTDIR/test01.c $PAGEFILE
+printf '//' >> $PAGEFILE
+head -c $((4096 - $(wc -c < $PAGEFILE))) /dev/zero | tr '\0' x >> $PAGEFILE
+$COMPILER -o $TESTDIR/test01.s $TESTDIR/test01.c 2>/dev/null
+if $COMPILER -o $TESTDIR/test01.out $PAGEFILE 2>/dev/null && cmp -s $TESTDIR/test01.s $TESTDIR/test01.out; then
+    echo -e "${GREEN}PASS${NC}"
+    PASSED=$((PASSED + 1))
+else
+    echo -e "${RED}FAIL${NC}"
+    FAILED=$((FAILED + 1))
+fi
+rm -f $PAGEFILE
+
+# Errors: an error on a -j code generation thread must fail the file like
+# any other, with its name and without partial output
+echo -n "Testing code generation error with -j 4... "
+ERRFILE=$(mktemp --suffix=.c /tmp/acompiler-error.XXXXXX)
+printf 'int f() { return 1; }\nint g() { 3 = 4; return 0; }\nint main() { return f() + g(); }\n' > $ERRFILE
+set +e
+$COMPILER -j 4 -o $ERRFILE.s $ERRFILE 2>$ERRFILE.log
+status=$?
+set -e
+if [ $status -eq 1 ] && grep -q "^$ERRFILE: Not an lvalue" $ERRFILE.log && [ ! -e $ERRFILE.s ]; then
+    echo -e "${GREEN}PASS${NC}"
+    PASSED=$((PASSED + 1))
+else
+    echo -e "${RED}FAIL${NC} (exit $status: $(cat $ERRFILE.log))"
+    FAILED=$((FAILED + 1))
+fi
+rm -f $ERRFILE $ERRFILE.log
+
+# Statistics: --stats=json must not change the output and must report
+# every phase and the parsed program
+echo -n "Testing statistics... "
+$COMPILER -o $TESTDIR/test01.s $TESTDIR/test01.c 2>/dev/null
+STATS=$($COMPILER --stats=json -o $TESTDIR/test01.out $TESTDIR/test01.c 2>&1)
+if cmp -s $TESTDIR/test01.s $TESTDIR/test01.out &&
+   echo "$STATS" | grep -q '"codegen": {"wall_ms": [0-9.]*, "cpu_ms"' &&
+   echo "$STATS" | grep -q '"functions": 1, "nodes": {"total": [1-9]'; then
+    echo -e "${GREEN}PASS${NC}"
+    PASSED=$((PASSED + 1))
+else
+    echo -e "${RED}FAIL${NC} ($STATS)"
+    FAILED=$((FAILED + 1))
+fi
+
+# Compile server: the client must produce the same output as a direct
+# compile, from a server that stays warm across all the requests
+SOCKET=$(mktemp -u /tmp/acompiler-test.XXXXXX)
+$COMPILER --server $SOCKET 2>/dev/null &
+SERVER_PID=$!
+for i in $(seq 50); do
+    [ -S $SOCKET ] && break
+    sleep 0.1
+done
+for testfile in $TESTDIR/test*.c; do
+    testname=$(basename $testfile .c)
+    for mode in "" "-c --ir"; do
+        echo -n "Testing $testname (server${mode:+ $mode})... "
+        $COMPILER $mode -o $TESTDIR/$testname.s $testfile 2>/dev/null
+        $COMPILER --client $SOCKET $mode -o $TESTDIR/$testname.out $testfile 2>/dev/null
+        if cmp -s $TESTDIR/$testname.s $TESTDIR/$testname.out; then
+            echo -e "${GREEN}PASS${NC}"
+            PASSED=$((PASSED + 1))
+        else
+            echo -e "${RED}FAIL${NC} (differs from direct output)"
+            FAILED=$((FAILED + 1))
+        fi
+    done
+done
+# A relative cache directory is the client's, not the server's
+echo -n "Testing server with a relative cache directory... "
+CLIENTDIR=$(mktemp -d /tmp/acompiler-client.XXXXXX)
+TOPDIR=$PWD
+$COMPILER -o $TESTDIR/test01.s $TESTDIR/test01.c 2>/dev/null
+(cd $CLIENTDIR && $TOPDIR/$COMPILER --client $SOCKET --cache cache -o out.s $TOPDIR/$TESTDIR/test01.c 2>/dev/null)
+if [ -d $CLIENTDIR/cache ] && [ ! -e cache ] && cmp -s $TESTDIR/test01.s $CLIENTDIR/out.s; then
+    echo -e "${GREEN}PASS${NC}"
+    PASSED=$((PASSED + 1))
+else
+    echo -e "${RED}FAIL${NC} (cache not in the client's directory)"
+    FAILED=$((FAILED + 1))
+fi
+rm -rf $CLIENTDIR
+# A request that fails on a -j code generation thread must not take the
+# server with it
+echo -n "Testing server after a failed -j 4 request... "
+ERRFILE=$(mktemp --suffix=.c /tmp/acompiler-error.XXXXXX)
+printf 'int f() { return 1; }\nint g() { 3 = 4; return 0; }\nint main() { return f() + g(); }\n' > $ERRFILE
+$COMPILER --client $SOCKET -j 4 -o $ERRFILE.s $ERRFILE 2>/dev/null || true
+if [ ! -e $ERRFILE.s ] &&
+   $COMPILER --client $SOCKET -j 4 -o $TESTDIR/test01.out $TESTDIR/test01.c 2>/dev/null &&
+   cmp -s $TESTDIR/test01.s $TESTDIR/test01.out; then
+    echo -e "${GREEN}PASS${NC}"
+    PASSED=$((PASSED + 1))
+else
+    echo -e "${RED}FAIL${NC}"
+    FAILED=$((FAILED + 1))
+fi
+rm -f $ERRFILE
+kill $SERVER_PID
+rm -f $SOCKET
+
+# Compilation cache: a miss and then a hit must both produce the same
+# output as a direct compile
+CACHEDIR=$(mktemp -d /tmp/acompiler-cache.XXXXXX)
+LOOKUPS=0
+for testfile in $TESTDIR/test*.c; do
+    testname=$(basename $testfile .c)
+    for mode in "" "-c"; do
+        echo -n "Testing $testname (cache${mode:+ $mode})... "
+        $COMPILER $mode -o $TESTDIR/$testname.s $testfile 2>/dev/null
+        $COMPILER --cache $CACHEDIR $mode -o $TESTDIR/$testname.out $testfile 2>/dev/null
+        $COMPILER --cache $CACHEDIR $mode -o $TESTDIR/$testname.o $testfile 2>/dev/null
+        LOOKUPS=$((LOOKUPS + 2))
+        if cmp -s $TESTDIR/$testname.s $TESTDIR/$testname.out && cmp -s $TESTDIR/$testname.s $TESTDIR/$testname.o; then
+            echo -e "${GREEN}PASS${NC}"
+            PASSED=$((PASSED + 1))
+        else
+            echo -e "${RED}FAIL${NC} (differs from direct output)"
+            FAILED=$((FAILED + 1))
+        fi
+    done
+done
+echo -n "Testing cache statistics... "
+HITS=$((LOOKUPS / 2))
+if grep -q "^hits $HITS misses $HITS " $CACHEDIR/stats; then
+    echo -e "${GREEN}PASS${NC}"
+    PASSED=$((PASSED + 1))
+else
+    echo -e "${RED}FAIL${NC} (expected $HITS hits and misses: $(cat $CACHEDIR/stats))"
+    FAILED=$((FAILED + 1))
+fi
+
+# Incremental compilation: after a function is added to a file, the other
+# functions are reused and the output is still that of a full compile
+INCRFILE=$(mktemp --suffix=.c /tmp/acompiler-incr.XXXXXX)
+for testfile in $TESTDIR/test*.c; do
+    testname=$(basename $testfile .c)
+    for mode in "" "--ir"; do
+        echo -n "Testing $testname (incremental${mode:+ $mode})... "
+        cp $testfile $INCRFILE
+        $COMPILER --cache $CACHEDIR --incremental $mode -o $TESTDIR/$testname.out $INCRFILE 2>/dev/null
+        echo 'int incremental_probe(char *s) { return s[0] + 1; }' >> $INCRFILE
+        $COMPILER $mode -o $TESTDIR/$testname.s $INCRFILE 2>/dev/null
+        $COMPILER --cache $CACHEDIR --incremental $mode -o $TESTDIR/$testname.out $INCRFILE 2>/dev/null
+        if cmp -s $TESTDIR/$testname.s $TESTDIR/$testname.out; then
+            echo -e "${GREEN}PASS${NC}"
+            PASSED=$((PASSED + 1))
+        else
+            echo -e "${RED}FAIL${NC} (differs from full compile)"
+            FAILED=$((FAILED + 1))
+        fi
+    done
+done
+echo -n "Testing incremental statistics... "
+if grep -q "functions reused [1-9]" $CACHEDIR/stats; then
+    echo -e "${GREEN}PASS${NC}"
+    PASSED=$((PASSED + 1))
+else
+    echo -e "${RED}FAIL${NC} (no functions reused: $(cat $CACHEDIR/stats))"
+    FAILED=$((FAILED + 1))
+fi
+
+# Incremental compilation with inlining: a caller must be recompiled when
+# a function inlined into it changes
+echo -n "Testing incremental inlining... "
+echo 'int sq(int x) { return x * x; } int main() { return sq(5); }' > $INCRFILE
+$COMPILER --cache $CACHEDIR --incremental -o $TESTDIR/incr.s $INCRFILE 2>/dev/null
+sed -i 's/x \* x/x + x/' $INCRFILE
+$COMPILER --cache $CACHEDIR --incremental -o $TESTDIR/incr.s $INCRFILE 2>/dev/null
+gcc -static -o $TESTDIR/incr.out $TESTDIR/incr.s 2>/dev/null
+set +e
+$TESTDIR/incr.out
+incr_exit=$?
+set -e
+if [ $incr_exit -eq 10 ]; then
+    echo -e "${GREEN}PASS${NC}"
+    PASSED=$((PASSED + 1))
+else
+    echo -e "${RED}FAIL${NC} (exit $incr_exit, expected 10)"
+    FAILED=$((FAILED + 1))
+fi
+rm -f $INCRFILE $TESTDIR/incr.s $TESTDIR/incr.out
+rm -rf $CACHEDIR
 
 echo "================================"
 echo "Results: $PASSED passed, $FAILED failed"
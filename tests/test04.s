@@ -0,0 +1,50 @@
+.intel_syntax noprefix
+.text
+.globl main
+main:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 64
+.Lmain.0:
+  mov rax, 5
+  mov [rbp-16], rax
+  mov [rbp-8], rax
+  mov [rbp-24], rax
+  mov rax, 5
+  mov [rbp-32], rax
+  mov rax, [rbp-24]
+  mov rdi, [rbp-32]
+  cmp rax, rdi
+  jne .Lmain.2
+.Lmain.1:
+  mov rax, 10
+  mov [rbp-48], rax
+  jmp .Lmain.5
+.Lmain.2:
+  mov rax, 0
+  mov [rbp-56], rax
+.Lmain.5:
+  mov rsp, rbp
+  pop rbp
+  ret
+.globl incremental_probe
+incremental_probe:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 48
+  mov [rbp-8], rdi
+.Lincremental_probe.0:
+  mov rax, [rbp-8]
+  mov [rbp-16], rax
+  mov rax, [rax]
+  mov [rbp-24], rax
+  mov rax, 1
+  mov [rbp-32], rax
+  mov rax, [rbp-24]
+  mov rdi, [rbp-32]
+  add rax, rdi
+  mov [rbp-40], rax
+.Lincremental_probe.2:
+  mov rsp, rbp
+  pop rbp
+  ret
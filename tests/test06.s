@@ -0,0 +1,71 @@
+.intel_syntax noprefix
+.text
+.globl main
+main:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 128
+.Lmain.0:
+  mov rax, 0
+  mov [rbp-24], rax
+  mov [rbp-16], rax
+  mov rax, 0
+  mov [rbp-32], rax
+  mov [rbp-8], rax
+.Lmain.1:
+  mov rax, [rbp-8]
+  mov [rbp-40], rax
+  mov rax, 10
+  mov [rbp-48], rax
+  mov rax, [rbp-40]
+  mov rdi, [rbp-48]
+  cmp rax, rdi
+  jge .Lmain.3
+.Lmain.2:
+  mov rax, [rbp-16]
+  mov [rbp-64], rax
+  mov rax, [rbp-8]
+  mov [rbp-72], rax
+  mov rax, [rbp-64]
+  mov rdi, [rbp-72]
+  add rax, rdi
+  mov [rbp-80], rax
+  mov [rbp-16], rax
+  mov rax, [rbp-8]
+  mov [rbp-88], rax
+  mov rax, 1
+  mov [rbp-96], rax
+  mov rax, [rbp-88]
+  mov rdi, [rbp-96]
+  add rax, rdi
+  mov [rbp-104], rax
+  mov [rbp-8], rax
+  jmp .Lmain.1
+.Lmain.3:
+  mov rax, [rbp-16]
+  mov [rbp-112], rax
+.Lmain.5:
+  mov rsp, rbp
+  pop rbp
+  ret
+.globl incremental_probe
+incremental_probe:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 48
+  mov [rbp-8], rdi
+.Lincremental_probe.0:
+  mov rax, [rbp-8]
+  mov [rbp-16], rax
+  mov rax, [rax]
+  mov [rbp-24], rax
+  mov rax, 1
+  mov [rbp-32], rax
+  mov rax, [rbp-24]
+  mov rdi, [rbp-32]
+  add rax, rdi
+  mov [rbp-40], rax
+.Lincremental_probe.2:
+  mov rsp, rbp
+  pop rbp
+  ret
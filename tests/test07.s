@@ -0,0 +1,70 @@
+.intel_syntax noprefix
+.text
+.globl add
+add:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 48
+  mov [rbp-8], rdi
+  mov [rbp-16], rsi
+.Ladd.0:
+  mov rax, [rbp-8]
+  mov [rbp-24], rax
+  mov rax, [rbp-16]
+  mov [rbp-32], rax
+  mov rax, [rbp-24]
+  mov rdi, [rbp-32]
+  add rax, rdi
+  mov [rbp-40], rax
+.Ladd.2:
+  mov rsp, rbp
+  pop rbp
+  ret
+.globl main
+main:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 80
+.Lmain.0:
+  mov rax, 5
+  mov [rbp-32], rax
+  mov [rbp-16], rax
+  mov rax, 10
+  mov [rbp-40], rax
+  mov [rbp-8], rax
+  mov [rbp-48], rax
+  mov rax, [rbp-16]
+  mov [rbp-56], rax
+  mov rax, [rbp-48]
+  mov rdi, [rbp-56]
+  add rax, rdi
+  mov [rbp-64], rax
+  mov [rbp-24], rax
+.Lmain.1:
+  mov rax, [rbp-24]
+  mov [rbp-72], rax
+.Lmain.4:
+  mov rsp, rbp
+  pop rbp
+  ret
+.globl incremental_probe
+incremental_probe:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 48
+  mov [rbp-8], rdi
+.Lincremental_probe.0:
+  mov rax, [rbp-8]
+  mov [rbp-16], rax
+  mov rax, [rax]
+  mov [rbp-24], rax
+  mov rax, 1
+  mov [rbp-32], rax
+  mov rax, [rbp-24]
+  mov rdi, [rbp-32]
+  add rax, rdi
+  mov [rbp-40], rax
+.Lincremental_probe.2:
+  mov rsp, rbp
+  pop rbp
+  ret
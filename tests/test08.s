@@ -0,0 +1,63 @@
+.intel_syntax noprefix
+.text
+.globl main
+main:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 96
+.Lmain.0:
+  mov rax, 5
+  mov [rbp-16], rax
+  mov [rbp-8], rax
+  mov [rbp-24], rax
+  mov rax, 5
+  mov [rbp-32], rax
+  mov rax, [rbp-24]
+  mov rdi, [rbp-32]
+  cmp rax, rdi
+  jne .Lmain.2
+.Lmain.1:
+  mov rax, [rbp-8]
+  mov [rbp-48], rax
+  mov rax, 10
+  mov [rbp-56], rax
+  mov rax, [rbp-48]
+  mov rdi, [rbp-56]
+  cmp rax, rdi
+  jge .Lmain.5
+.Lmain.4:
+  mov rax, 1
+  mov [rbp-72], rax
+  jmp .Lmain.10
+.Lmain.5:
+  mov rax, 2
+  mov [rbp-80], rax
+  jmp .Lmain.10
+.Lmain.2:
+  mov rax, 3
+  mov [rbp-88], rax
+.Lmain.10:
+  mov rsp, rbp
+  pop rbp
+  ret
+.globl incremental_probe
+incremental_probe:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 48
+  mov [rbp-8], rdi
+.Lincremental_probe.0:
+  mov rax, [rbp-8]
+  mov [rbp-16], rax
+  mov rax, [rax]
+  mov [rbp-24], rax
+  mov rax, 1
+  mov [rbp-32], rax
+  mov rax, [rbp-24]
+  mov rdi, [rbp-32]
+  add rax, rdi
+  mov [rbp-40], rax
+.Lincremental_probe.2:
+  mov rsp, rbp
+  pop rbp
+  ret
@@ -0,0 +1,44 @@
+.intel_syntax noprefix
+.text
+.globl main
+main:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 80
+.Lmain.0:
+  mov rax, 3
+  mov [rbp-32], rax
+  mov [rbp-8], rax
+  lea rax, [rbp-8]
+  mov [rbp-40], rax
+  mov [rbp-24], rax
+  mov [rbp-48], rax
+  mov rax, [rax]
+  mov [rbp-56], rax
+  mov [rbp-16], rax
+  mov [rbp-64], rax
+.Lmain.2:
+  mov rsp, rbp
+  pop rbp
+  ret
+.globl incremental_probe
+incremental_probe:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 48
+  mov [rbp-8], rdi
+.Lincremental_probe.0:
+  mov rax, [rbp-8]
+  mov [rbp-16], rax
+  mov rax, [rax]
+  mov [rbp-24], rax
+  mov rax, 1
+  mov [rbp-32], rax
+  mov rax, [rbp-24]
+  mov rdi, [rbp-32]
+  add rax, rdi
+  mov [rbp-40], rax
+.Lincremental_probe.2:
+  mov rsp, rbp
+  pop rbp
+  ret
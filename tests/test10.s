@@ -0,0 +1,81 @@
+.intel_syntax noprefix
+.text
+.globl fact
+fact:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 96
+  mov [rbp-8], rdi
+.Lfact.0:
+  mov rax, [rbp-8]
+  mov [rbp-16], rax
+  mov rax, 1
+  mov [rbp-24], rax
+  mov rax, [rbp-16]
+  mov rdi, [rbp-24]
+  cmp rax, rdi
+  jg .Lfact.2
+.Lfact.1:
+  mov rax, 1
+  mov [rbp-40], rax
+  jmp .Lfact.5
+.Lfact.2:
+  mov rax, [rbp-8]
+  mov [rbp-48], rax
+  mov rax, [rbp-8]
+  mov [rbp-56], rax
+  mov rax, -1
+  mov [rbp-64], rax
+  mov rax, [rbp-56]
+  mov rdi, [rbp-64]
+  add rax, rdi
+  mov [rbp-72], rax
+  mov rdi, [rbp-72]
+  mov rax, 0
+  call fact
+  mov [rbp-80], rax
+  mov rax, [rbp-48]
+  mov rdi, [rbp-80]
+  imul rax, rdi
+  mov [rbp-88], rax
+.Lfact.5:
+  mov rsp, rbp
+  pop rbp
+  ret
+.globl main
+main:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 32
+.Lmain.0:
+  mov rax, 5
+  mov [rbp-8], rax
+  mov rdi, [rbp-8]
+  mov rax, 0
+  call fact
+  mov [rbp-16], rax
+.Lmain.2:
+  mov rsp, rbp
+  pop rbp
+  ret
+.globl incremental_probe
+incremental_probe:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 48
+  mov [rbp-8], rdi
+.Lincremental_probe.0:
+  mov rax, [rbp-8]
+  mov [rbp-16], rax
+  mov rax, [rax]
+  mov [rbp-24], rax
+  mov rax, 1
+  mov [rbp-32], rax
+  mov rax, [rbp-24]
+  mov rdi, [rbp-32]
+  add rax, rdi
+  mov [rbp-40], rax
+.Lincremental_probe.2:
+  mov rsp, rbp
+  pop rbp
+  ret
@@ -0,0 +1,136 @@
+.intel_syntax noprefix
+.text
+.globl main
+main:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 288
+.Lmain.0:
+  mov rax, 10
+  mov [rbp-24], rax
+  mov [rbp-8], rax
+  mov rax, 0
+  mov [rbp-32], rax
+  mov [rbp-16], rax
+  mov rax, 5
+  mov [rbp-40], rax
+  mov rax, [rbp-8]
+  mov [rbp-48], rax
+  mov rax, [rbp-40]
+  mov rdi, [rbp-48]
+  cmp rax, rdi
+  jge .Lmain.2
+.Lmain.1:
+  mov rax, [rbp-16]
+  mov [rbp-64], rax
+  mov rax, 1
+  mov [rbp-72], rax
+  mov rax, [rbp-64]
+  mov rdi, [rbp-72]
+  add rax, rdi
+  mov [rbp-80], rax
+  mov [rbp-16], rax
+.Lmain.2:
+  mov rax, 10
+  mov [rbp-88], rax
+  mov rax, [rbp-8]
+  mov [rbp-96], rax
+  mov rax, [rbp-88]
+  mov rdi, [rbp-96]
+  cmp rax, rdi
+  jg .Lmain.4
+.Lmain.3:
+  mov rax, [rbp-16]
+  mov [rbp-112], rax
+  mov rax, 1
+  mov [rbp-120], rax
+  mov rax, [rbp-112]
+  mov rdi, [rbp-120]
+  add rax, rdi
+  mov [rbp-128], rax
+  mov [rbp-16], rax
+.Lmain.4:
+  mov rax, [rbp-8]
+  mov [rbp-136], rax
+  mov rax, 20
+  mov [rbp-144], rax
+  mov rax, [rbp-136]
+  mov rdi, [rbp-144]
+  cmp rax, rdi
+  jge .Lmain.6
+.Lmain.5:
+  mov rax, [rbp-16]
+  mov [rbp-160], rax
+  mov rax, 1
+  mov [rbp-168], rax
+  mov rax, [rbp-160]
+  mov rdi, [rbp-168]
+  add rax, rdi
+  mov [rbp-176], rax
+  mov [rbp-16], rax
+.Lmain.6:
+  mov rax, [rbp-8]
+  mov [rbp-184], rax
+  mov rax, 10
+  mov [rbp-192], rax
+  mov rax, [rbp-184]
+  mov rdi, [rbp-192]
+  cmp rax, rdi
+  jg .Lmain.8
+.Lmain.7:
+  mov rax, [rbp-16]
+  mov [rbp-208], rax
+  mov rax, 1
+  mov [rbp-216], rax
+  mov rax, [rbp-208]
+  mov rdi, [rbp-216]
+  add rax, rdi
+  mov [rbp-224], rax
+  mov [rbp-16], rax
+.Lmain.8:
+  mov rax, [rbp-8]
+  mov [rbp-232], rax
+  mov rax, 5
+  mov [rbp-240], rax
+  mov rax, [rbp-232]
+  mov rdi, [rbp-240]
+  cmp rax, rdi
+  je .Lmain.10
+.Lmain.9:
+  mov rax, [rbp-16]
+  mov [rbp-256], rax
+  mov rax, 1
+  mov [rbp-264], rax
+  mov rax, [rbp-256]
+  mov rdi, [rbp-264]
+  add rax, rdi
+  mov [rbp-272], rax
+  mov [rbp-16], rax
+.Lmain.10:
+  mov rax, [rbp-16]
+  mov [rbp-280], rax
+.Lmain.12:
+  mov rsp, rbp
+  pop rbp
+  ret
+.globl incremental_probe
+incremental_probe:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 48
+  mov [rbp-8], rdi
+.Lincremental_probe.0:
+  mov rax, [rbp-8]
+  mov [rbp-16], rax
+  mov rax, [rax]
+  mov [rbp-24], rax
+  mov rax, 1
+  mov [rbp-32], rax
+  mov rax, [rbp-24]
+  mov rdi, [rbp-32]
+  add rax, rdi
+  mov [rbp-40], rax
+.Lincremental_probe.2:
+  mov rsp, rbp
+  pop rbp
+  ret
@@ -0,0 +1,31 @@
+// Test register pressure: more live locals and temporaries than registers
+int id(int x) {
+    return x;
+}
+
+int main() {
+    int a;
+    int b;
+    int c;
+    int d;
+    int e;
+    int f;
+    int g;
+    int h;
+    int i;
+    int s;
+    a = 1;
+    b = 2;
+    c = 3;
+    d = 4;
+    e = 5;
+    f = 6;
+    g = 7;
+    h = 8;
+    s = 0;
+    for (i = 0; i < 3; i = i + 1) {
+        s = s + a + b * (c + d * (e + f * (g + h * id(i))));
+        s = s + (a + (b + (c + (d + (e + (f + (g + (h + id(i))))))))) % 7;
+    }
+    return s % 251;
+}
@@ -0,0 +1,240 @@
+.intel_syntax noprefix
+.text
+.globl id
+id:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 32
+  mov [rbp-8], rdi
+.Lid.0:
+  mov rax, [rbp-8]
+  mov [rbp-16], rax
+.Lid.2:
+  mov rsp, rbp
+  pop rbp
+  ret
+.globl main
+main:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 624
+.Lmain.0:
+  mov rax, 1
+  mov [rbp-120], rax
+  mov [rbp-8], rax
+  mov rax, 2
+  mov [rbp-128], rax
+  mov [rbp-16], rax
+  mov rax, 3
+  mov [rbp-136], rax
+  mov [rbp-24], rax
+  mov rax, 4
+  mov [rbp-144], rax
+  mov [rbp-32], rax
+  mov rax, 5
+  mov [rbp-152], rax
+  mov [rbp-40], rax
+  mov rax, 6
+  mov [rbp-160], rax
+  mov [rbp-48], rax
+  mov rax, 7
+  mov [rbp-168], rax
+  mov [rbp-56], rax
+  mov rax, 8
+  mov [rbp-176], rax
+  mov [rbp-64], rax
+  mov rax, 0
+  mov [rbp-184], rax
+  mov [rbp-80], rax
+  mov rax, 0
+  mov [rbp-192], rax
+  mov [rbp-72], rax
+.Lmain.1:
+  mov rax, [rbp-72]
+  mov [rbp-200], rax
+  mov rax, 3
+  mov [rbp-208], rax
+  mov rax, [rbp-200]
+  mov rdi, [rbp-208]
+  cmp rax, rdi
+  jge .Lmain.3
+.Lmain.2:
+  mov rax, [rbp-80]
+  mov [rbp-224], rax
+  mov rax, [rbp-8]
+  mov [rbp-232], rax
+  mov rax, [rbp-224]
+  mov rdi, [rbp-232]
+  add rax, rdi
+  mov [rbp-240], rax
+  mov rax, [rbp-16]
+  mov [rbp-248], rax
+  mov rax, [rbp-24]
+  mov [rbp-256], rax
+  mov rax, [rbp-32]
+  mov [rbp-264], rax
+  mov rax, [rbp-40]
+  mov [rbp-272], rax
+  mov rax, [rbp-48]
+  mov [rbp-280], rax
+  mov rax, [rbp-56]
+  mov [rbp-288], rax
+  mov rax, [rbp-64]
+  mov [rbp-296], rax
+  mov rax, [rbp-72]
+  mov [rbp-304], rax
+  mov [rbp-88], rax
+  mov [rbp-312], rax
+  mov [rbp-96], rax
+.Lmain.4:
+  mov rax, [rbp-96]
+  mov [rbp-320], rax
+  mov rax, [rbp-296]
+  mov rdi, [rbp-320]
+  imul rax, rdi
+  mov [rbp-328], rax
+  mov rax, [rbp-288]
+  mov rdi, [rbp-328]
+  add rax, rdi
+  mov [rbp-336], rax
+  mov rax, [rbp-280]
+  mov rdi, [rbp-336]
+  imul rax, rdi
+  mov [rbp-344], rax
+  mov rax, [rbp-272]
+  mov rdi, [rbp-344]
+  add rax, rdi
+  mov [rbp-352], rax
+  mov rax, [rbp-264]
+  mov rdi, [rbp-352]
+  imul rax, rdi
+  mov [rbp-360], rax
+  mov rax, [rbp-256]
+  mov rdi, [rbp-360]
+  add rax, rdi
+  mov [rbp-368], rax
+  mov rax, [rbp-248]
+  mov rdi, [rbp-368]
+  imul rax, rdi
+  mov [rbp-376], rax
+  mov rax, [rbp-240]
+  mov rdi, [rbp-376]
+  add rax, rdi
+  mov [rbp-384], rax
+  mov [rbp-80], rax
+  mov [rbp-392], rax
+  mov rax, [rbp-8]
+  mov [rbp-400], rax
+  mov rax, [rbp-16]
+  mov [rbp-408], rax
+  mov rax, [rbp-24]
+  mov [rbp-416], rax
+  mov rax, [rbp-32]
+  mov [rbp-424], rax
+  mov rax, [rbp-40]
+  mov [rbp-432], rax
+  mov rax, [rbp-48]
+  mov [rbp-440], rax
+  mov rax, [rbp-56]
+  mov [rbp-448], rax
+  mov rax, [rbp-64]
+  mov [rbp-456], rax
+  mov rax, [rbp-72]
+  mov [rbp-464], rax
+  mov [rbp-104], rax
+  mov [rbp-472], rax
+  mov [rbp-112], rax
+.Lmain.6:
+  mov rax, [rbp-112]
+  mov [rbp-480], rax
+  mov rax, [rbp-456]
+  mov rdi, [rbp-480]
+  add rax, rdi
+  mov [rbp-488], rax
+  mov rax, [rbp-448]
+  mov rdi, [rbp-488]
+  add rax, rdi
+  mov [rbp-496], rax
+  mov rax, [rbp-440]
+  mov rdi, [rbp-496]
+  add rax, rdi
+  mov [rbp-504], rax
+  mov rax, [rbp-432]
+  mov rdi, [rbp-504]
+  add rax, rdi
+  mov [rbp-512], rax
+  mov rax, [rbp-424]
+  mov rdi, [rbp-512]
+  add rax, rdi
+  mov [rbp-520], rax
+  mov rax, [rbp-416]
+  mov rdi, [rbp-520]
+  add rax, rdi
+  mov [rbp-528], rax
+  mov rax, [rbp-408]
+  mov rdi, [rbp-528]
+  add rax, rdi
+  mov [rbp-536], rax
+  mov rax, [rbp-400]
+  mov rdi, [rbp-536]
+  add rax, rdi
+  mov [rbp-544], rax
+  mov rax, 7
+  mov [rbp-552], rax
+  mov rax, [rbp-544]
+  mov rdi, [rbp-552]
+  cqo
+  idiv rdi
+  mov rax, rdx
+  mov [rbp-560], rax
+  mov rax, [rbp-392]
+  mov rdi, [rbp-560]
+  add rax, rdi
+  mov [rbp-568], rax
+  mov [rbp-80], rax
+  mov rax, [rbp-72]
+  mov [rbp-576], rax
+  mov rax, 1
+  mov [rbp-584], rax
+  mov rax, [rbp-576]
+  mov rdi, [rbp-584]
+  add rax, rdi
+  mov [rbp-592], rax
+  mov [rbp-72], rax
+  jmp .Lmain.1
+.Lmain.3:
+  mov rax, [rbp-80]
+  mov [rbp-600], rax
+  mov rax, 251
+  mov [rbp-608], rax
+  mov rax, [rbp-600]
+  mov rdi, [rbp-608]
+  cqo
+  idiv rdi
+  mov rax, rdx
+  mov [rbp-616], rax
+.Lmain.9:
+  mov rsp, rbp
+  pop rbp
+  ret
+.globl incremental_probe
+incremental_probe:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 48
+  mov [rbp-8], rdi
+.Lincremental_probe.0:
+  mov rax, [rbp-8]
+  mov [rbp-16], rax
+  mov rax, [rax]
+  mov [rbp-24], rax
+  mov rax, 1
+  mov [rbp-32], rax
+  mov rax, [rbp-24]
+  mov rdi, [rbp-32]
+  add rax, rdi
+  mov [rbp-40], rax
+.Lincremental_probe.2:
+  mov rsp, rbp
+  pop rbp
+  ret
@@ -0,0 +1,34 @@
+// Test constant folding and algebraic simplification
+int seven() {
+    return 7;
+}
+
+int main() {
+    int x;
+    int y;
+    int *p;
+    x = 3;
+    y = -x + 10 * 2 - (4 - 2) * 3;
+    y = y * 1 + 0 - 0;
+    y = y + sizeof(char) * 4 - 4;
+    p = &x;
+    *&x = x + 1;
+    y = y + *p - (0 - -1);
+    if (1 < 2)
+        y = y + 1;
+    if (0)
+        y = 100;
+    while (0)
+        y = 200;
+    if (5 < y)
+        y = y + (x * 0);
+    if (20 == y)
+        y = y + seven() * 0;
+    x = 0;
+    while (1) {
+        x = x + 1;
+        if (x == 5)
+            return y - (-5 * -1) + (seven() % 1) * 0 + 8 / 1 + x - 5;
+    }
+    return 0;
+}
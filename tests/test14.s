@@ -0,0 +1,209 @@
+.intel_syntax noprefix
+.text
+.globl seven
+seven:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 16
+.Lseven.0:
+  mov rax, 7
+  mov [rbp-8], rax
+.Lseven.2:
+  mov rsp, rbp
+  pop rbp
+  ret
+.globl main
+main:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 496
+.Lmain.0:
+  mov rax, 3
+  mov [rbp-48], rax
+  mov [rbp-8], rax
+  mov [rbp-56], rax
+  neg rax
+  mov [rbp-64], rax
+  mov rax, 14
+  mov [rbp-72], rax
+  mov rax, [rbp-64]
+  mov rdi, [rbp-72]
+  add rax, rdi
+  mov [rbp-80], rax
+  mov [rbp-16], rax
+  lea rax, [rbp-8]
+  mov [rbp-88], rax
+  mov [rbp-24], rax
+  mov rax, [rbp-8]
+  mov [rbp-96], rax
+  mov rax, 1
+  mov [rbp-104], rax
+  mov rax, [rbp-96]
+  mov rdi, [rbp-104]
+  add rax, rdi
+  mov [rbp-112], rax
+  mov [rbp-8], rax
+  mov rax, [rbp-16]
+  mov [rbp-120], rax
+  mov rax, [rbp-24]
+  mov [rbp-128], rax
+  mov rax, [rax]
+  mov [rbp-136], rax
+  mov rax, [rbp-120]
+  mov rdi, [rbp-136]
+  add rax, rdi
+  mov [rbp-144], rax
+  mov rax, -1
+  mov [rbp-152], rax
+  mov rax, [rbp-144]
+  mov rdi, [rbp-152]
+  add rax, rdi
+  mov [rbp-160], rax
+  mov [rbp-16], rax
+  mov [rbp-168], rax
+  mov rax, 1
+  mov [rbp-176], rax
+  mov rax, [rbp-168]
+  mov rdi, [rbp-176]
+  add rax, rdi
+  mov [rbp-184], rax
+  mov [rbp-16], rax
+  mov rax, 5
+  mov [rbp-192], rax
+  mov rax, [rbp-16]
+  mov [rbp-200], rax
+  mov rax, [rbp-192]
+  mov rdi, [rbp-200]
+  cmp rax, rdi
+  jge .Lmain.2
+.Lmain.1:
+.Lmain.2:
+  mov rax, [rbp-16]
+  mov [rbp-224], rax
+  mov rax, 20
+  mov [rbp-232], rax
+  mov rax, [rbp-224]
+  mov rdi, [rbp-232]
+  cmp rax, rdi
+  jne .Lmain.4
+.Lmain.3:
+  mov rax, [rbp-16]
+  mov [rbp-248], rax
+  mov rax, 7
+  mov [rbp-256], rax
+  mov [rbp-32], rax
+.Lmain.5:
+  mov rax, [rbp-32]
+  mov [rbp-264], rax
+  mov rax, 0
+  mov [rbp-272], rax
+  mov rax, [rbp-264]
+  mov rdi, [rbp-272]
+  imul rax, rdi
+  mov [rbp-280], rax
+  mov rax, [rbp-248]
+  mov rdi, [rbp-280]
+  add rax, rdi
+  mov [rbp-288], rax
+  mov [rbp-16], rax
+.Lmain.4:
+  mov rax, 0
+  mov [rbp-296], rax
+  mov [rbp-8], rax
+.Lmain.7:
+.Lmain.8:
+  mov rax, [rbp-8]
+  mov [rbp-304], rax
+  mov rax, 1
+  mov [rbp-312], rax
+  mov rax, [rbp-304]
+  mov rdi, [rbp-312]
+  add rax, rdi
+  mov [rbp-320], rax
+  mov [rbp-8], rax
+  mov [rbp-328], rax
+  mov rax, 5
+  mov [rbp-336], rax
+  mov rax, [rbp-328]
+  mov rdi, [rbp-336]
+  cmp rax, rdi
+  jne .Lmain.11
+.Lmain.10:
+  mov rax, [rbp-16]
+  mov [rbp-352], rax
+  mov rax, -5
+  mov [rbp-360], rax
+  mov rax, [rbp-352]
+  mov rdi, [rbp-360]
+  add rax, rdi
+  mov [rbp-368], rax
+  mov rax, 7
+  mov [rbp-376], rax
+  mov [rbp-40], rax
+.Lmain.12:
+  mov rax, [rbp-40]
+  mov [rbp-384], rax
+  mov rax, 1
+  mov [rbp-392], rax
+  mov rax, [rbp-384]
+  mov rdi, [rbp-392]
+  cqo
+  idiv rdi
+  mov rax, rdx
+  mov [rbp-400], rax
+  mov rax, 0
+  mov [rbp-408], rax
+  mov rax, [rbp-400]
+  mov rdi, [rbp-408]
+  imul rax, rdi
+  mov [rbp-416], rax
+  mov rax, [rbp-368]
+  mov rdi, [rbp-416]
+  add rax, rdi
+  mov [rbp-424], rax
+  mov rax, 8
+  mov [rbp-432], rax
+  mov rax, [rbp-424]
+  mov rdi, [rbp-432]
+  add rax, rdi
+  mov [rbp-440], rax
+  mov rax, [rbp-8]
+  mov [rbp-448], rax
+  mov rax, [rbp-440]
+  mov rdi, [rbp-448]
+  add rax, rdi
+  mov [rbp-456], rax
+  mov rax, -5
+  mov [rbp-464], rax
+  mov rax, [rbp-456]
+  mov rdi, [rbp-464]
+  add rax, rdi
+  mov [rbp-472], rax
+  jmp .Lmain.16
+.Lmain.11:
+  jmp .Lmain.7
+.Lmain.16:
+  mov rsp, rbp
+  pop rbp
+  ret
+.globl incremental_probe
+incremental_probe:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 48
+  mov [rbp-8], rdi
+.Lincremental_probe.0:
+  mov rax, [rbp-8]
+  mov [rbp-16], rax
+  mov rax, [rax]
+  mov [rbp-24], rax
+  mov rax, 1
+  mov [rbp-32], rax
+  mov rax, [rbp-24]
+  mov rdi, [rbp-32]
+  add rax, rdi
+  mov [rbp-40], rax
+.Lincremental_probe.2:
+  mov rsp, rbp
+  pop rbp
+  ret
@@ -0,0 +1,238 @@
+// Test blocks with more than 100 statements
+int main() {
+    int s;
+    s = 0;
+    {
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+        s = s + 1;
+        s = s + 2;
+        s = s + 0;
+    }
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    s = s - 1;
+    return s;
+}
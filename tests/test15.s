@@ -0,0 +1,1557 @@
+.intel_syntax noprefix
+.text
+.globl main
+main:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 4592
+.Lmain.0:
+  mov rax, 0
+  mov [rbp-16], rax
+  mov [rbp-8], rax
+  mov [rbp-24], rax
+  mov rax, 1
+  mov [rbp-32], rax
+  mov rax, [rbp-24]
+  mov rdi, [rbp-32]
+  add rax, rdi
+  mov [rbp-40], rax
+  mov [rbp-8], rax
+  mov [rbp-48], rax
+  mov rax, 2
+  mov [rbp-56], rax
+  mov rax, [rbp-48]
+  mov rdi, [rbp-56]
+  add rax, rdi
+  mov [rbp-64], rax
+  mov [rbp-8], rax
+  mov [rbp-72], rax
+  mov rax, 1
+  mov [rbp-80], rax
+  mov rax, [rbp-72]
+  mov rdi, [rbp-80]
+  add rax, rdi
+  mov [rbp-88], rax
+  mov [rbp-8], rax
+  mov [rbp-96], rax
+  mov rax, 2
+  mov [rbp-104], rax
+  mov rax, [rbp-96]
+  mov rdi, [rbp-104]
+  add rax, rdi
+  mov [rbp-112], rax
+  mov [rbp-8], rax
+  mov [rbp-120], rax
+  mov rax, 1
+  mov [rbp-128], rax
+  mov rax, [rbp-120]
+  mov rdi, [rbp-128]
+  add rax, rdi
+  mov [rbp-136], rax
+  mov [rbp-8], rax
+  mov [rbp-144], rax
+  mov rax, 2
+  mov [rbp-152], rax
+  mov rax, [rbp-144]
+  mov rdi, [rbp-152]
+  add rax, rdi
+  mov [rbp-160], rax
+  mov [rbp-8], rax
+  mov [rbp-168], rax
+  mov rax, 1
+  mov [rbp-176], rax
+  mov rax, [rbp-168]
+  mov rdi, [rbp-176]
+  add rax, rdi
+  mov [rbp-184], rax
+  mov [rbp-8], rax
+  mov [rbp-192], rax
+  mov rax, 2
+  mov [rbp-200], rax
+  mov rax, [rbp-192]
+  mov rdi, [rbp-200]
+  add rax, rdi
+  mov [rbp-208], rax
+  mov [rbp-8], rax
+  mov [rbp-216], rax
+  mov rax, 1
+  mov [rbp-224], rax
+  mov rax, [rbp-216]
+  mov rdi, [rbp-224]
+  add rax, rdi
+  mov [rbp-232], rax
+  mov [rbp-8], rax
+  mov [rbp-240], rax
+  mov rax, 2
+  mov [rbp-248], rax
+  mov rax, [rbp-240]
+  mov rdi, [rbp-248]
+  add rax, rdi
+  mov [rbp-256], rax
+  mov [rbp-8], rax
+  mov [rbp-264], rax
+  mov rax, 1
+  mov [rbp-272], rax
+  mov rax, [rbp-264]
+  mov rdi, [rbp-272]
+  add rax, rdi
+  mov [rbp-280], rax
+  mov [rbp-8], rax
+  mov [rbp-288], rax
+  mov rax, 2
+  mov [rbp-296], rax
+  mov rax, [rbp-288]
+  mov rdi, [rbp-296]
+  add rax, rdi
+  mov [rbp-304], rax
+  mov [rbp-8], rax
+  mov [rbp-312], rax
+  mov rax, 1
+  mov [rbp-320], rax
+  mov rax, [rbp-312]
+  mov rdi, [rbp-320]
+  add rax, rdi
+  mov [rbp-328], rax
+  mov [rbp-8], rax
+  mov [rbp-336], rax
+  mov rax, 2
+  mov [rbp-344], rax
+  mov rax, [rbp-336]
+  mov rdi, [rbp-344]
+  add rax, rdi
+  mov [rbp-352], rax
+  mov [rbp-8], rax
+  mov [rbp-360], rax
+  mov rax, 1
+  mov [rbp-368], rax
+  mov rax, [rbp-360]
+  mov rdi, [rbp-368]
+  add rax, rdi
+  mov [rbp-376], rax
+  mov [rbp-8], rax
+  mov [rbp-384], rax
+  mov rax, 2
+  mov [rbp-392], rax
+  mov rax, [rbp-384]
+  mov rdi, [rbp-392]
+  add rax, rdi
+  mov [rbp-400], rax
+  mov [rbp-8], rax
+  mov [rbp-408], rax
+  mov rax, 1
+  mov [rbp-416], rax
+  mov rax, [rbp-408]
+  mov rdi, [rbp-416]
+  add rax, rdi
+  mov [rbp-424], rax
+  mov [rbp-8], rax
+  mov [rbp-432], rax
+  mov rax, 2
+  mov [rbp-440], rax
+  mov rax, [rbp-432]
+  mov rdi, [rbp-440]
+  add rax, rdi
+  mov [rbp-448], rax
+  mov [rbp-8], rax
+  mov [rbp-456], rax
+  mov rax, 1
+  mov [rbp-464], rax
+  mov rax, [rbp-456]
+  mov rdi, [rbp-464]
+  add rax, rdi
+  mov [rbp-472], rax
+  mov [rbp-8], rax
+  mov [rbp-480], rax
+  mov rax, 2
+  mov [rbp-488], rax
+  mov rax, [rbp-480]
+  mov rdi, [rbp-488]
+  add rax, rdi
+  mov [rbp-496], rax
+  mov [rbp-8], rax
+  mov [rbp-504], rax
+  mov rax, 1
+  mov [rbp-512], rax
+  mov rax, [rbp-504]
+  mov rdi, [rbp-512]
+  add rax, rdi
+  mov [rbp-520], rax
+  mov [rbp-8], rax
+  mov [rbp-528], rax
+  mov rax, 2
+  mov [rbp-536], rax
+  mov rax, [rbp-528]
+  mov rdi, [rbp-536]
+  add rax, rdi
+  mov [rbp-544], rax
+  mov [rbp-8], rax
+  mov [rbp-552], rax
+  mov rax, 1
+  mov [rbp-560], rax
+  mov rax, [rbp-552]
+  mov rdi, [rbp-560]
+  add rax, rdi
+  mov [rbp-568], rax
+  mov [rbp-8], rax
+  mov [rbp-576], rax
+  mov rax, 2
+  mov [rbp-584], rax
+  mov rax, [rbp-576]
+  mov rdi, [rbp-584]
+  add rax, rdi
+  mov [rbp-592], rax
+  mov [rbp-8], rax
+  mov [rbp-600], rax
+  mov rax, 1
+  mov [rbp-608], rax
+  mov rax, [rbp-600]
+  mov rdi, [rbp-608]
+  add rax, rdi
+  mov [rbp-616], rax
+  mov [rbp-8], rax
+  mov [rbp-624], rax
+  mov rax, 2
+  mov [rbp-632], rax
+  mov rax, [rbp-624]
+  mov rdi, [rbp-632]
+  add rax, rdi
+  mov [rbp-640], rax
+  mov [rbp-8], rax
+  mov [rbp-648], rax
+  mov rax, 1
+  mov [rbp-656], rax
+  mov rax, [rbp-648]
+  mov rdi, [rbp-656]
+  add rax, rdi
+  mov [rbp-664], rax
+  mov [rbp-8], rax
+  mov [rbp-672], rax
+  mov rax, 2
+  mov [rbp-680], rax
+  mov rax, [rbp-672]
+  mov rdi, [rbp-680]
+  add rax, rdi
+  mov [rbp-688], rax
+  mov [rbp-8], rax
+  mov [rbp-696], rax
+  mov rax, 1
+  mov [rbp-704], rax
+  mov rax, [rbp-696]
+  mov rdi, [rbp-704]
+  add rax, rdi
+  mov [rbp-712], rax
+  mov [rbp-8], rax
+  mov [rbp-720], rax
+  mov rax, 2
+  mov [rbp-728], rax
+  mov rax, [rbp-720]
+  mov rdi, [rbp-728]
+  add rax, rdi
+  mov [rbp-736], rax
+  mov [rbp-8], rax
+  mov [rbp-744], rax
+  mov rax, 1
+  mov [rbp-752], rax
+  mov rax, [rbp-744]
+  mov rdi, [rbp-752]
+  add rax, rdi
+  mov [rbp-760], rax
+  mov [rbp-8], rax
+  mov [rbp-768], rax
+  mov rax, 2
+  mov [rbp-776], rax
+  mov rax, [rbp-768]
+  mov rdi, [rbp-776]
+  add rax, rdi
+  mov [rbp-784], rax
+  mov [rbp-8], rax
+  mov [rbp-792], rax
+  mov rax, 1
+  mov [rbp-800], rax
+  mov rax, [rbp-792]
+  mov rdi, [rbp-800]
+  add rax, rdi
+  mov [rbp-808], rax
+  mov [rbp-8], rax
+  mov [rbp-816], rax
+  mov rax, 2
+  mov [rbp-824], rax
+  mov rax, [rbp-816]
+  mov rdi, [rbp-824]
+  add rax, rdi
+  mov [rbp-832], rax
+  mov [rbp-8], rax
+  mov [rbp-840], rax
+  mov rax, 1
+  mov [rbp-848], rax
+  mov rax, [rbp-840]
+  mov rdi, [rbp-848]
+  add rax, rdi
+  mov [rbp-856], rax
+  mov [rbp-8], rax
+  mov [rbp-864], rax
+  mov rax, 2
+  mov [rbp-872], rax
+  mov rax, [rbp-864]
+  mov rdi, [rbp-872]
+  add rax, rdi
+  mov [rbp-880], rax
+  mov [rbp-8], rax
+  mov [rbp-888], rax
+  mov rax, 1
+  mov [rbp-896], rax
+  mov rax, [rbp-888]
+  mov rdi, [rbp-896]
+  add rax, rdi
+  mov [rbp-904], rax
+  mov [rbp-8], rax
+  mov [rbp-912], rax
+  mov rax, 2
+  mov [rbp-920], rax
+  mov rax, [rbp-912]
+  mov rdi, [rbp-920]
+  add rax, rdi
+  mov [rbp-928], rax
+  mov [rbp-8], rax
+  mov [rbp-936], rax
+  mov rax, 1
+  mov [rbp-944], rax
+  mov rax, [rbp-936]
+  mov rdi, [rbp-944]
+  add rax, rdi
+  mov [rbp-952], rax
+  mov [rbp-8], rax
+  mov [rbp-960], rax
+  mov rax, 2
+  mov [rbp-968], rax
+  mov rax, [rbp-960]
+  mov rdi, [rbp-968]
+  add rax, rdi
+  mov [rbp-976], rax
+  mov [rbp-8], rax
+  mov [rbp-984], rax
+  mov rax, 1
+  mov [rbp-992], rax
+  mov rax, [rbp-984]
+  mov rdi, [rbp-992]
+  add rax, rdi
+  mov [rbp-1000], rax
+  mov [rbp-8], rax
+  mov [rbp-1008], rax
+  mov rax, 2
+  mov [rbp-1016], rax
+  mov rax, [rbp-1008]
+  mov rdi, [rbp-1016]
+  add rax, rdi
+  mov [rbp-1024], rax
+  mov [rbp-8], rax
+  mov [rbp-1032], rax
+  mov rax, 1
+  mov [rbp-1040], rax
+  mov rax, [rbp-1032]
+  mov rdi, [rbp-1040]
+  add rax, rdi
+  mov [rbp-1048], rax
+  mov [rbp-8], rax
+  mov [rbp-1056], rax
+  mov rax, 2
+  mov [rbp-1064], rax
+  mov rax, [rbp-1056]
+  mov rdi, [rbp-1064]
+  add rax, rdi
+  mov [rbp-1072], rax
+  mov [rbp-8], rax
+  mov [rbp-1080], rax
+  mov rax, 1
+  mov [rbp-1088], rax
+  mov rax, [rbp-1080]
+  mov rdi, [rbp-1088]
+  add rax, rdi
+  mov [rbp-1096], rax
+  mov [rbp-8], rax
+  mov [rbp-1104], rax
+  mov rax, 2
+  mov [rbp-1112], rax
+  mov rax, [rbp-1104]
+  mov rdi, [rbp-1112]
+  add rax, rdi
+  mov [rbp-1120], rax
+  mov [rbp-8], rax
+  mov [rbp-1128], rax
+  mov rax, 1
+  mov [rbp-1136], rax
+  mov rax, [rbp-1128]
+  mov rdi, [rbp-1136]
+  add rax, rdi
+  mov [rbp-1144], rax
+  mov [rbp-8], rax
+  mov [rbp-1152], rax
+  mov rax, 2
+  mov [rbp-1160], rax
+  mov rax, [rbp-1152]
+  mov rdi, [rbp-1160]
+  add rax, rdi
+  mov [rbp-1168], rax
+  mov [rbp-8], rax
+  mov [rbp-1176], rax
+  mov rax, 1
+  mov [rbp-1184], rax
+  mov rax, [rbp-1176]
+  mov rdi, [rbp-1184]
+  add rax, rdi
+  mov [rbp-1192], rax
+  mov [rbp-8], rax
+  mov [rbp-1200], rax
+  mov rax, 2
+  mov [rbp-1208], rax
+  mov rax, [rbp-1200]
+  mov rdi, [rbp-1208]
+  add rax, rdi
+  mov [rbp-1216], rax
+  mov [rbp-8], rax
+  mov [rbp-1224], rax
+  mov rax, 1
+  mov [rbp-1232], rax
+  mov rax, [rbp-1224]
+  mov rdi, [rbp-1232]
+  add rax, rdi
+  mov [rbp-1240], rax
+  mov [rbp-8], rax
+  mov [rbp-1248], rax
+  mov rax, 2
+  mov [rbp-1256], rax
+  mov rax, [rbp-1248]
+  mov rdi, [rbp-1256]
+  add rax, rdi
+  mov [rbp-1264], rax
+  mov [rbp-8], rax
+  mov [rbp-1272], rax
+  mov rax, 1
+  mov [rbp-1280], rax
+  mov rax, [rbp-1272]
+  mov rdi, [rbp-1280]
+  add rax, rdi
+  mov [rbp-1288], rax
+  mov [rbp-8], rax
+  mov [rbp-1296], rax
+  mov rax, 2
+  mov [rbp-1304], rax
+  mov rax, [rbp-1296]
+  mov rdi, [rbp-1304]
+  add rax, rdi
+  mov [rbp-1312], rax
+  mov [rbp-8], rax
+  mov [rbp-1320], rax
+  mov rax, 1
+  mov [rbp-1328], rax
+  mov rax, [rbp-1320]
+  mov rdi, [rbp-1328]
+  add rax, rdi
+  mov [rbp-1336], rax
+  mov [rbp-8], rax
+  mov [rbp-1344], rax
+  mov rax, 2
+  mov [rbp-1352], rax
+  mov rax, [rbp-1344]
+  mov rdi, [rbp-1352]
+  add rax, rdi
+  mov [rbp-1360], rax
+  mov [rbp-8], rax
+  mov [rbp-1368], rax
+  mov rax, 1
+  mov [rbp-1376], rax
+  mov rax, [rbp-1368]
+  mov rdi, [rbp-1376]
+  add rax, rdi
+  mov [rbp-1384], rax
+  mov [rbp-8], rax
+  mov [rbp-1392], rax
+  mov rax, 2
+  mov [rbp-1400], rax
+  mov rax, [rbp-1392]
+  mov rdi, [rbp-1400]
+  add rax, rdi
+  mov [rbp-1408], rax
+  mov [rbp-8], rax
+  mov [rbp-1416], rax
+  mov rax, 1
+  mov [rbp-1424], rax
+  mov rax, [rbp-1416]
+  mov rdi, [rbp-1424]
+  add rax, rdi
+  mov [rbp-1432], rax
+  mov [rbp-8], rax
+  mov [rbp-1440], rax
+  mov rax, 2
+  mov [rbp-1448], rax
+  mov rax, [rbp-1440]
+  mov rdi, [rbp-1448]
+  add rax, rdi
+  mov [rbp-1456], rax
+  mov [rbp-8], rax
+  mov [rbp-1464], rax
+  mov rax, 1
+  mov [rbp-1472], rax
+  mov rax, [rbp-1464]
+  mov rdi, [rbp-1472]
+  add rax, rdi
+  mov [rbp-1480], rax
+  mov [rbp-8], rax
+  mov [rbp-1488], rax
+  mov rax, 2
+  mov [rbp-1496], rax
+  mov rax, [rbp-1488]
+  mov rdi, [rbp-1496]
+  add rax, rdi
+  mov [rbp-1504], rax
+  mov [rbp-8], rax
+  mov [rbp-1512], rax
+  mov rax, 1
+  mov [rbp-1520], rax
+  mov rax, [rbp-1512]
+  mov rdi, [rbp-1520]
+  add rax, rdi
+  mov [rbp-1528], rax
+  mov [rbp-8], rax
+  mov [rbp-1536], rax
+  mov rax, 2
+  mov [rbp-1544], rax
+  mov rax, [rbp-1536]
+  mov rdi, [rbp-1544]
+  add rax, rdi
+  mov [rbp-1552], rax
+  mov [rbp-8], rax
+  mov [rbp-1560], rax
+  mov rax, 1
+  mov [rbp-1568], rax
+  mov rax, [rbp-1560]
+  mov rdi, [rbp-1568]
+  add rax, rdi
+  mov [rbp-1576], rax
+  mov [rbp-8], rax
+  mov [rbp-1584], rax
+  mov rax, 2
+  mov [rbp-1592], rax
+  mov rax, [rbp-1584]
+  mov rdi, [rbp-1592]
+  add rax, rdi
+  mov [rbp-1600], rax
+  mov [rbp-8], rax
+  mov [rbp-1608], rax
+  mov rax, 1
+  mov [rbp-1616], rax
+  mov rax, [rbp-1608]
+  mov rdi, [rbp-1616]
+  add rax, rdi
+  mov [rbp-1624], rax
+  mov [rbp-8], rax
+  mov [rbp-1632], rax
+  mov rax, 2
+  mov [rbp-1640], rax
+  mov rax, [rbp-1632]
+  mov rdi, [rbp-1640]
+  add rax, rdi
+  mov [rbp-1648], rax
+  mov [rbp-8], rax
+  mov [rbp-1656], rax
+  mov rax, 1
+  mov [rbp-1664], rax
+  mov rax, [rbp-1656]
+  mov rdi, [rbp-1664]
+  add rax, rdi
+  mov [rbp-1672], rax
+  mov [rbp-8], rax
+  mov [rbp-1680], rax
+  mov rax, 2
+  mov [rbp-1688], rax
+  mov rax, [rbp-1680]
+  mov rdi, [rbp-1688]
+  add rax, rdi
+  mov [rbp-1696], rax
+  mov [rbp-8], rax
+  mov [rbp-1704], rax
+  mov rax, 1
+  mov [rbp-1712], rax
+  mov rax, [rbp-1704]
+  mov rdi, [rbp-1712]
+  add rax, rdi
+  mov [rbp-1720], rax
+  mov [rbp-8], rax
+  mov [rbp-1728], rax
+  mov rax, 2
+  mov [rbp-1736], rax
+  mov rax, [rbp-1728]
+  mov rdi, [rbp-1736]
+  add rax, rdi
+  mov [rbp-1744], rax
+  mov [rbp-8], rax
+  mov [rbp-1752], rax
+  mov rax, 1
+  mov [rbp-1760], rax
+  mov rax, [rbp-1752]
+  mov rdi, [rbp-1760]
+  add rax, rdi
+  mov [rbp-1768], rax
+  mov [rbp-8], rax
+  mov [rbp-1776], rax
+  mov rax, 2
+  mov [rbp-1784], rax
+  mov rax, [rbp-1776]
+  mov rdi, [rbp-1784]
+  add rax, rdi
+  mov [rbp-1792], rax
+  mov [rbp-8], rax
+  mov [rbp-1800], rax
+  mov rax, 1
+  mov [rbp-1808], rax
+  mov rax, [rbp-1800]
+  mov rdi, [rbp-1808]
+  add rax, rdi
+  mov [rbp-1816], rax
+  mov [rbp-8], rax
+  mov [rbp-1824], rax
+  mov rax, 2
+  mov [rbp-1832], rax
+  mov rax, [rbp-1824]
+  mov rdi, [rbp-1832]
+  add rax, rdi
+  mov [rbp-1840], rax
+  mov [rbp-8], rax
+  mov [rbp-1848], rax
+  mov rax, 1
+  mov [rbp-1856], rax
+  mov rax, [rbp-1848]
+  mov rdi, [rbp-1856]
+  add rax, rdi
+  mov [rbp-1864], rax
+  mov [rbp-8], rax
+  mov [rbp-1872], rax
+  mov rax, 2
+  mov [rbp-1880], rax
+  mov rax, [rbp-1872]
+  mov rdi, [rbp-1880]
+  add rax, rdi
+  mov [rbp-1888], rax
+  mov [rbp-8], rax
+  mov [rbp-1896], rax
+  mov rax, 1
+  mov [rbp-1904], rax
+  mov rax, [rbp-1896]
+  mov rdi, [rbp-1904]
+  add rax, rdi
+  mov [rbp-1912], rax
+  mov [rbp-8], rax
+  mov [rbp-1920], rax
+  mov rax, 2
+  mov [rbp-1928], rax
+  mov rax, [rbp-1920]
+  mov rdi, [rbp-1928]
+  add rax, rdi
+  mov [rbp-1936], rax
+  mov [rbp-8], rax
+  mov [rbp-1944], rax
+  mov rax, -1
+  mov [rbp-1952], rax
+  mov rax, [rbp-1944]
+  mov rdi, [rbp-1952]
+  add rax, rdi
+  mov [rbp-1960], rax
+  mov [rbp-8], rax
+  mov [rbp-1968], rax
+  mov rax, -1
+  mov [rbp-1976], rax
+  mov rax, [rbp-1968]
+  mov rdi, [rbp-1976]
+  add rax, rdi
+  mov [rbp-1984], rax
+  mov [rbp-8], rax
+  mov [rbp-1992], rax
+  mov rax, -1
+  mov [rbp-2000], rax
+  mov rax, [rbp-1992]
+  mov rdi, [rbp-2000]
+  add rax, rdi
+  mov [rbp-2008], rax
+  mov [rbp-8], rax
+  mov [rbp-2016], rax
+  mov rax, -1
+  mov [rbp-2024], rax
+  mov rax, [rbp-2016]
+  mov rdi, [rbp-2024]
+  add rax, rdi
+  mov [rbp-2032], rax
+  mov [rbp-8], rax
+  mov [rbp-2040], rax
+  mov rax, -1
+  mov [rbp-2048], rax
+  mov rax, [rbp-2040]
+  mov rdi, [rbp-2048]
+  add rax, rdi
+  mov [rbp-2056], rax
+  mov [rbp-8], rax
+  mov [rbp-2064], rax
+  mov rax, -1
+  mov [rbp-2072], rax
+  mov rax, [rbp-2064]
+  mov rdi, [rbp-2072]
+  add rax, rdi
+  mov [rbp-2080], rax
+  mov [rbp-8], rax
+  mov [rbp-2088], rax
+  mov rax, -1
+  mov [rbp-2096], rax
+  mov rax, [rbp-2088]
+  mov rdi, [rbp-2096]
+  add rax, rdi
+  mov [rbp-2104], rax
+  mov [rbp-8], rax
+  mov [rbp-2112], rax
+  mov rax, -1
+  mov [rbp-2120], rax
+  mov rax, [rbp-2112]
+  mov rdi, [rbp-2120]
+  add rax, rdi
+  mov [rbp-2128], rax
+  mov [rbp-8], rax
+  mov [rbp-2136], rax
+  mov rax, -1
+  mov [rbp-2144], rax
+  mov rax, [rbp-2136]
+  mov rdi, [rbp-2144]
+  add rax, rdi
+  mov [rbp-2152], rax
+  mov [rbp-8], rax
+  mov [rbp-2160], rax
+  mov rax, -1
+  mov [rbp-2168], rax
+  mov rax, [rbp-2160]
+  mov rdi, [rbp-2168]
+  add rax, rdi
+  mov [rbp-2176], rax
+  mov [rbp-8], rax
+  mov [rbp-2184], rax
+  mov rax, -1
+  mov [rbp-2192], rax
+  mov rax, [rbp-2184]
+  mov rdi, [rbp-2192]
+  add rax, rdi
+  mov [rbp-2200], rax
+  mov [rbp-8], rax
+  mov [rbp-2208], rax
+  mov rax, -1
+  mov [rbp-2216], rax
+  mov rax, [rbp-2208]
+  mov rdi, [rbp-2216]
+  add rax, rdi
+  mov [rbp-2224], rax
+  mov [rbp-8], rax
+  mov [rbp-2232], rax
+  mov rax, -1
+  mov [rbp-2240], rax
+  mov rax, [rbp-2232]
+  mov rdi, [rbp-2240]
+  add rax, rdi
+  mov [rbp-2248], rax
+  mov [rbp-8], rax
+  mov [rbp-2256], rax
+  mov rax, -1
+  mov [rbp-2264], rax
+  mov rax, [rbp-2256]
+  mov rdi, [rbp-2264]
+  add rax, rdi
+  mov [rbp-2272], rax
+  mov [rbp-8], rax
+  mov [rbp-2280], rax
+  mov rax, -1
+  mov [rbp-2288], rax
+  mov rax, [rbp-2280]
+  mov rdi, [rbp-2288]
+  add rax, rdi
+  mov [rbp-2296], rax
+  mov [rbp-8], rax
+  mov [rbp-2304], rax
+  mov rax, -1
+  mov [rbp-2312], rax
+  mov rax, [rbp-2304]
+  mov rdi, [rbp-2312]
+  add rax, rdi
+  mov [rbp-2320], rax
+  mov [rbp-8], rax
+  mov [rbp-2328], rax
+  mov rax, -1
+  mov [rbp-2336], rax
+  mov rax, [rbp-2328]
+  mov rdi, [rbp-2336]
+  add rax, rdi
+  mov [rbp-2344], rax
+  mov [rbp-8], rax
+  mov [rbp-2352], rax
+  mov rax, -1
+  mov [rbp-2360], rax
+  mov rax, [rbp-2352]
+  mov rdi, [rbp-2360]
+  add rax, rdi
+  mov [rbp-2368], rax
+  mov [rbp-8], rax
+  mov [rbp-2376], rax
+  mov rax, -1
+  mov [rbp-2384], rax
+  mov rax, [rbp-2376]
+  mov rdi, [rbp-2384]
+  add rax, rdi
+  mov [rbp-2392], rax
+  mov [rbp-8], rax
+  mov [rbp-2400], rax
+  mov rax, -1
+  mov [rbp-2408], rax
+  mov rax, [rbp-2400]
+  mov rdi, [rbp-2408]
+  add rax, rdi
+  mov [rbp-2416], rax
+  mov [rbp-8], rax
+  mov [rbp-2424], rax
+  mov rax, -1
+  mov [rbp-2432], rax
+  mov rax, [rbp-2424]
+  mov rdi, [rbp-2432]
+  add rax, rdi
+  mov [rbp-2440], rax
+  mov [rbp-8], rax
+  mov [rbp-2448], rax
+  mov rax, -1
+  mov [rbp-2456], rax
+  mov rax, [rbp-2448]
+  mov rdi, [rbp-2456]
+  add rax, rdi
+  mov [rbp-2464], rax
+  mov [rbp-8], rax
+  mov [rbp-2472], rax
+  mov rax, -1
+  mov [rbp-2480], rax
+  mov rax, [rbp-2472]
+  mov rdi, [rbp-2480]
+  add rax, rdi
+  mov [rbp-2488], rax
+  mov [rbp-8], rax
+  mov [rbp-2496], rax
+  mov rax, -1
+  mov [rbp-2504], rax
+  mov rax, [rbp-2496]
+  mov rdi, [rbp-2504]
+  add rax, rdi
+  mov [rbp-2512], rax
+  mov [rbp-8], rax
+  mov [rbp-2520], rax
+  mov rax, -1
+  mov [rbp-2528], rax
+  mov rax, [rbp-2520]
+  mov rdi, [rbp-2528]
+  add rax, rdi
+  mov [rbp-2536], rax
+  mov [rbp-8], rax
+  mov [rbp-2544], rax
+  mov rax, -1
+  mov [rbp-2552], rax
+  mov rax, [rbp-2544]
+  mov rdi, [rbp-2552]
+  add rax, rdi
+  mov [rbp-2560], rax
+  mov [rbp-8], rax
+  mov [rbp-2568], rax
+  mov rax, -1
+  mov [rbp-2576], rax
+  mov rax, [rbp-2568]
+  mov rdi, [rbp-2576]
+  add rax, rdi
+  mov [rbp-2584], rax
+  mov [rbp-8], rax
+  mov [rbp-2592], rax
+  mov rax, -1
+  mov [rbp-2600], rax
+  mov rax, [rbp-2592]
+  mov rdi, [rbp-2600]
+  add rax, rdi
+  mov [rbp-2608], rax
+  mov [rbp-8], rax
+  mov [rbp-2616], rax
+  mov rax, -1
+  mov [rbp-2624], rax
+  mov rax, [rbp-2616]
+  mov rdi, [rbp-2624]
+  add rax, rdi
+  mov [rbp-2632], rax
+  mov [rbp-8], rax
+  mov [rbp-2640], rax
+  mov rax, -1
+  mov [rbp-2648], rax
+  mov rax, [rbp-2640]
+  mov rdi, [rbp-2648]
+  add rax, rdi
+  mov [rbp-2656], rax
+  mov [rbp-8], rax
+  mov [rbp-2664], rax
+  mov rax, -1
+  mov [rbp-2672], rax
+  mov rax, [rbp-2664]
+  mov rdi, [rbp-2672]
+  add rax, rdi
+  mov [rbp-2680], rax
+  mov [rbp-8], rax
+  mov [rbp-2688], rax
+  mov rax, -1
+  mov [rbp-2696], rax
+  mov rax, [rbp-2688]
+  mov rdi, [rbp-2696]
+  add rax, rdi
+  mov [rbp-2704], rax
+  mov [rbp-8], rax
+  mov [rbp-2712], rax
+  mov rax, -1
+  mov [rbp-2720], rax
+  mov rax, [rbp-2712]
+  mov rdi, [rbp-2720]
+  add rax, rdi
+  mov [rbp-2728], rax
+  mov [rbp-8], rax
+  mov [rbp-2736], rax
+  mov rax, -1
+  mov [rbp-2744], rax
+  mov rax, [rbp-2736]
+  mov rdi, [rbp-2744]
+  add rax, rdi
+  mov [rbp-2752], rax
+  mov [rbp-8], rax
+  mov [rbp-2760], rax
+  mov rax, -1
+  mov [rbp-2768], rax
+  mov rax, [rbp-2760]
+  mov rdi, [rbp-2768]
+  add rax, rdi
+  mov [rbp-2776], rax
+  mov [rbp-8], rax
+  mov [rbp-2784], rax
+  mov rax, -1
+  mov [rbp-2792], rax
+  mov rax, [rbp-2784]
+  mov rdi, [rbp-2792]
+  add rax, rdi
+  mov [rbp-2800], rax
+  mov [rbp-8], rax
+  mov [rbp-2808], rax
+  mov rax, -1
+  mov [rbp-2816], rax
+  mov rax, [rbp-2808]
+  mov rdi, [rbp-2816]
+  add rax, rdi
+  mov [rbp-2824], rax
+  mov [rbp-8], rax
+  mov [rbp-2832], rax
+  mov rax, -1
+  mov [rbp-2840], rax
+  mov rax, [rbp-2832]
+  mov rdi, [rbp-2840]
+  add rax, rdi
+  mov [rbp-2848], rax
+  mov [rbp-8], rax
+  mov [rbp-2856], rax
+  mov rax, -1
+  mov [rbp-2864], rax
+  mov rax, [rbp-2856]
+  mov rdi, [rbp-2864]
+  add rax, rdi
+  mov [rbp-2872], rax
+  mov [rbp-8], rax
+  mov [rbp-2880], rax
+  mov rax, -1
+  mov [rbp-2888], rax
+  mov rax, [rbp-2880]
+  mov rdi, [rbp-2888]
+  add rax, rdi
+  mov [rbp-2896], rax
+  mov [rbp-8], rax
+  mov [rbp-2904], rax
+  mov rax, -1
+  mov [rbp-2912], rax
+  mov rax, [rbp-2904]
+  mov rdi, [rbp-2912]
+  add rax, rdi
+  mov [rbp-2920], rax
+  mov [rbp-8], rax
+  mov [rbp-2928], rax
+  mov rax, -1
+  mov [rbp-2936], rax
+  mov rax, [rbp-2928]
+  mov rdi, [rbp-2936]
+  add rax, rdi
+  mov [rbp-2944], rax
+  mov [rbp-8], rax
+  mov [rbp-2952], rax
+  mov rax, -1
+  mov [rbp-2960], rax
+  mov rax, [rbp-2952]
+  mov rdi, [rbp-2960]
+  add rax, rdi
+  mov [rbp-2968], rax
+  mov [rbp-8], rax
+  mov [rbp-2976], rax
+  mov rax, -1
+  mov [rbp-2984], rax
+  mov rax, [rbp-2976]
+  mov rdi, [rbp-2984]
+  add rax, rdi
+  mov [rbp-2992], rax
+  mov [rbp-8], rax
+  mov [rbp-3000], rax
+  mov rax, -1
+  mov [rbp-3008], rax
+  mov rax, [rbp-3000]
+  mov rdi, [rbp-3008]
+  add rax, rdi
+  mov [rbp-3016], rax
+  mov [rbp-8], rax
+  mov [rbp-3024], rax
+  mov rax, -1
+  mov [rbp-3032], rax
+  mov rax, [rbp-3024]
+  mov rdi, [rbp-3032]
+  add rax, rdi
+  mov [rbp-3040], rax
+  mov [rbp-8], rax
+  mov [rbp-3048], rax
+  mov rax, -1
+  mov [rbp-3056], rax
+  mov rax, [rbp-3048]
+  mov rdi, [rbp-3056]
+  add rax, rdi
+  mov [rbp-3064], rax
+  mov [rbp-8], rax
+  mov [rbp-3072], rax
+  mov rax, -1
+  mov [rbp-3080], rax
+  mov rax, [rbp-3072]
+  mov rdi, [rbp-3080]
+  add rax, rdi
+  mov [rbp-3088], rax
+  mov [rbp-8], rax
+  mov [rbp-3096], rax
+  mov rax, -1
+  mov [rbp-3104], rax
+  mov rax, [rbp-3096]
+  mov rdi, [rbp-3104]
+  add rax, rdi
+  mov [rbp-3112], rax
+  mov [rbp-8], rax
+  mov [rbp-3120], rax
+  mov rax, -1
+  mov [rbp-3128], rax
+  mov rax, [rbp-3120]
+  mov rdi, [rbp-3128]
+  add rax, rdi
+  mov [rbp-3136], rax
+  mov [rbp-8], rax
+  mov [rbp-3144], rax
+  mov rax, -1
+  mov [rbp-3152], rax
+  mov rax, [rbp-3144]
+  mov rdi, [rbp-3152]
+  add rax, rdi
+  mov [rbp-3160], rax
+  mov [rbp-8], rax
+  mov [rbp-3168], rax
+  mov rax, -1
+  mov [rbp-3176], rax
+  mov rax, [rbp-3168]
+  mov rdi, [rbp-3176]
+  add rax, rdi
+  mov [rbp-3184], rax
+  mov [rbp-8], rax
+  mov [rbp-3192], rax
+  mov rax, -1
+  mov [rbp-3200], rax
+  mov rax, [rbp-3192]
+  mov rdi, [rbp-3200]
+  add rax, rdi
+  mov [rbp-3208], rax
+  mov [rbp-8], rax
+  mov [rbp-3216], rax
+  mov rax, -1
+  mov [rbp-3224], rax
+  mov rax, [rbp-3216]
+  mov rdi, [rbp-3224]
+  add rax, rdi
+  mov [rbp-3232], rax
+  mov [rbp-8], rax
+  mov [rbp-3240], rax
+  mov rax, -1
+  mov [rbp-3248], rax
+  mov rax, [rbp-3240]
+  mov rdi, [rbp-3248]
+  add rax, rdi
+  mov [rbp-3256], rax
+  mov [rbp-8], rax
+  mov [rbp-3264], rax
+  mov rax, -1
+  mov [rbp-3272], rax
+  mov rax, [rbp-3264]
+  mov rdi, [rbp-3272]
+  add rax, rdi
+  mov [rbp-3280], rax
+  mov [rbp-8], rax
+  mov [rbp-3288], rax
+  mov rax, -1
+  mov [rbp-3296], rax
+  mov rax, [rbp-3288]
+  mov rdi, [rbp-3296]
+  add rax, rdi
+  mov [rbp-3304], rax
+  mov [rbp-8], rax
+  mov [rbp-3312], rax
+  mov rax, -1
+  mov [rbp-3320], rax
+  mov rax, [rbp-3312]
+  mov rdi, [rbp-3320]
+  add rax, rdi
+  mov [rbp-3328], rax
+  mov [rbp-8], rax
+  mov [rbp-3336], rax
+  mov rax, -1
+  mov [rbp-3344], rax
+  mov rax, [rbp-3336]
+  mov rdi, [rbp-3344]
+  add rax, rdi
+  mov [rbp-3352], rax
+  mov [rbp-8], rax
+  mov [rbp-3360], rax
+  mov rax, -1
+  mov [rbp-3368], rax
+  mov rax, [rbp-3360]
+  mov rdi, [rbp-3368]
+  add rax, rdi
+  mov [rbp-3376], rax
+  mov [rbp-8], rax
+  mov [rbp-3384], rax
+  mov rax, -1
+  mov [rbp-3392], rax
+  mov rax, [rbp-3384]
+  mov rdi, [rbp-3392]
+  add rax, rdi
+  mov [rbp-3400], rax
+  mov [rbp-8], rax
+  mov [rbp-3408], rax
+  mov rax, -1
+  mov [rbp-3416], rax
+  mov rax, [rbp-3408]
+  mov rdi, [rbp-3416]
+  add rax, rdi
+  mov [rbp-3424], rax
+  mov [rbp-8], rax
+  mov [rbp-3432], rax
+  mov rax, -1
+  mov [rbp-3440], rax
+  mov rax, [rbp-3432]
+  mov rdi, [rbp-3440]
+  add rax, rdi
+  mov [rbp-3448], rax
+  mov [rbp-8], rax
+  mov [rbp-3456], rax
+  mov rax, -1
+  mov [rbp-3464], rax
+  mov rax, [rbp-3456]
+  mov rdi, [rbp-3464]
+  add rax, rdi
+  mov [rbp-3472], rax
+  mov [rbp-8], rax
+  mov [rbp-3480], rax
+  mov rax, -1
+  mov [rbp-3488], rax
+  mov rax, [rbp-3480]
+  mov rdi, [rbp-3488]
+  add rax, rdi
+  mov [rbp-3496], rax
+  mov [rbp-8], rax
+  mov [rbp-3504], rax
+  mov rax, -1
+  mov [rbp-3512], rax
+  mov rax, [rbp-3504]
+  mov rdi, [rbp-3512]
+  add rax, rdi
+  mov [rbp-3520], rax
+  mov [rbp-8], rax
+  mov [rbp-3528], rax
+  mov rax, -1
+  mov [rbp-3536], rax
+  mov rax, [rbp-3528]
+  mov rdi, [rbp-3536]
+  add rax, rdi
+  mov [rbp-3544], rax
+  mov [rbp-8], rax
+  mov [rbp-3552], rax
+  mov rax, -1
+  mov [rbp-3560], rax
+  mov rax, [rbp-3552]
+  mov rdi, [rbp-3560]
+  add rax, rdi
+  mov [rbp-3568], rax
+  mov [rbp-8], rax
+  mov [rbp-3576], rax
+  mov rax, -1
+  mov [rbp-3584], rax
+  mov rax, [rbp-3576]
+  mov rdi, [rbp-3584]
+  add rax, rdi
+  mov [rbp-3592], rax
+  mov [rbp-8], rax
+  mov [rbp-3600], rax
+  mov rax, -1
+  mov [rbp-3608], rax
+  mov rax, [rbp-3600]
+  mov rdi, [rbp-3608]
+  add rax, rdi
+  mov [rbp-3616], rax
+  mov [rbp-8], rax
+  mov [rbp-3624], rax
+  mov rax, -1
+  mov [rbp-3632], rax
+  mov rax, [rbp-3624]
+  mov rdi, [rbp-3632]
+  add rax, rdi
+  mov [rbp-3640], rax
+  mov [rbp-8], rax
+  mov [rbp-3648], rax
+  mov rax, -1
+  mov [rbp-3656], rax
+  mov rax, [rbp-3648]
+  mov rdi, [rbp-3656]
+  add rax, rdi
+  mov [rbp-3664], rax
+  mov [rbp-8], rax
+  mov [rbp-3672], rax
+  mov rax, -1
+  mov [rbp-3680], rax
+  mov rax, [rbp-3672]
+  mov rdi, [rbp-3680]
+  add rax, rdi
+  mov [rbp-3688], rax
+  mov [rbp-8], rax
+  mov [rbp-3696], rax
+  mov rax, -1
+  mov [rbp-3704], rax
+  mov rax, [rbp-3696]
+  mov rdi, [rbp-3704]
+  add rax, rdi
+  mov [rbp-3712], rax
+  mov [rbp-8], rax
+  mov [rbp-3720], rax
+  mov rax, -1
+  mov [rbp-3728], rax
+  mov rax, [rbp-3720]
+  mov rdi, [rbp-3728]
+  add rax, rdi
+  mov [rbp-3736], rax
+  mov [rbp-8], rax
+  mov [rbp-3744], rax
+  mov rax, -1
+  mov [rbp-3752], rax
+  mov rax, [rbp-3744]
+  mov rdi, [rbp-3752]
+  add rax, rdi
+  mov [rbp-3760], rax
+  mov [rbp-8], rax
+  mov [rbp-3768], rax
+  mov rax, -1
+  mov [rbp-3776], rax
+  mov rax, [rbp-3768]
+  mov rdi, [rbp-3776]
+  add rax, rdi
+  mov [rbp-3784], rax
+  mov [rbp-8], rax
+  mov [rbp-3792], rax
+  mov rax, -1
+  mov [rbp-3800], rax
+  mov rax, [rbp-3792]
+  mov rdi, [rbp-3800]
+  add rax, rdi
+  mov [rbp-3808], rax
+  mov [rbp-8], rax
+  mov [rbp-3816], rax
+  mov rax, -1
+  mov [rbp-3824], rax
+  mov rax, [rbp-3816]
+  mov rdi, [rbp-3824]
+  add rax, rdi
+  mov [rbp-3832], rax
+  mov [rbp-8], rax
+  mov [rbp-3840], rax
+  mov rax, -1
+  mov [rbp-3848], rax
+  mov rax, [rbp-3840]
+  mov rdi, [rbp-3848]
+  add rax, rdi
+  mov [rbp-3856], rax
+  mov [rbp-8], rax
+  mov [rbp-3864], rax
+  mov rax, -1
+  mov [rbp-3872], rax
+  mov rax, [rbp-3864]
+  mov rdi, [rbp-3872]
+  add rax, rdi
+  mov [rbp-3880], rax
+  mov [rbp-8], rax
+  mov [rbp-3888], rax
+  mov rax, -1
+  mov [rbp-3896], rax
+  mov rax, [rbp-3888]
+  mov rdi, [rbp-3896]
+  add rax, rdi
+  mov [rbp-3904], rax
+  mov [rbp-8], rax
+  mov [rbp-3912], rax
+  mov rax, -1
+  mov [rbp-3920], rax
+  mov rax, [rbp-3912]
+  mov rdi, [rbp-3920]
+  add rax, rdi
+  mov [rbp-3928], rax
+  mov [rbp-8], rax
+  mov [rbp-3936], rax
+  mov rax, -1
+  mov [rbp-3944], rax
+  mov rax, [rbp-3936]
+  mov rdi, [rbp-3944]
+  add rax, rdi
+  mov [rbp-3952], rax
+  mov [rbp-8], rax
+  mov [rbp-3960], rax
+  mov rax, -1
+  mov [rbp-3968], rax
+  mov rax, [rbp-3960]
+  mov rdi, [rbp-3968]
+  add rax, rdi
+  mov [rbp-3976], rax
+  mov [rbp-8], rax
+  mov [rbp-3984], rax
+  mov rax, -1
+  mov [rbp-3992], rax
+  mov rax, [rbp-3984]
+  mov rdi, [rbp-3992]
+  add rax, rdi
+  mov [rbp-4000], rax
+  mov [rbp-8], rax
+  mov [rbp-4008], rax
+  mov rax, -1
+  mov [rbp-4016], rax
+  mov rax, [rbp-4008]
+  mov rdi, [rbp-4016]
+  add rax, rdi
+  mov [rbp-4024], rax
+  mov [rbp-8], rax
+  mov [rbp-4032], rax
+  mov rax, -1
+  mov [rbp-4040], rax
+  mov rax, [rbp-4032]
+  mov rdi, [rbp-4040]
+  add rax, rdi
+  mov [rbp-4048], rax
+  mov [rbp-8], rax
+  mov [rbp-4056], rax
+  mov rax, -1
+  mov [rbp-4064], rax
+  mov rax, [rbp-4056]
+  mov rdi, [rbp-4064]
+  add rax, rdi
+  mov [rbp-4072], rax
+  mov [rbp-8], rax
+  mov [rbp-4080], rax
+  mov rax, -1
+  mov [rbp-4088], rax
+  mov rax, [rbp-4080]
+  mov rdi, [rbp-4088]
+  add rax, rdi
+  mov [rbp-4096], rax
+  mov [rbp-8], rax
+  mov [rbp-4104], rax
+  mov rax, -1
+  mov [rbp-4112], rax
+  mov rax, [rbp-4104]
+  mov rdi, [rbp-4112]
+  add rax, rdi
+  mov [rbp-4120], rax
+  mov [rbp-8], rax
+  mov [rbp-4128], rax
+  mov rax, -1
+  mov [rbp-4136], rax
+  mov rax, [rbp-4128]
+  mov rdi, [rbp-4136]
+  add rax, rdi
+  mov [rbp-4144], rax
+  mov [rbp-8], rax
+  mov [rbp-4152], rax
+  mov rax, -1
+  mov [rbp-4160], rax
+  mov rax, [rbp-4152]
+  mov rdi, [rbp-4160]
+  add rax, rdi
+  mov [rbp-4168], rax
+  mov [rbp-8], rax
+  mov [rbp-4176], rax
+  mov rax, -1
+  mov [rbp-4184], rax
+  mov rax, [rbp-4176]
+  mov rdi, [rbp-4184]
+  add rax, rdi
+  mov [rbp-4192], rax
+  mov [rbp-8], rax
+  mov [rbp-4200], rax
+  mov rax, -1
+  mov [rbp-4208], rax
+  mov rax, [rbp-4200]
+  mov rdi, [rbp-4208]
+  add rax, rdi
+  mov [rbp-4216], rax
+  mov [rbp-8], rax
+  mov [rbp-4224], rax
+  mov rax, -1
+  mov [rbp-4232], rax
+  mov rax, [rbp-4224]
+  mov rdi, [rbp-4232]
+  add rax, rdi
+  mov [rbp-4240], rax
+  mov [rbp-8], rax
+  mov [rbp-4248], rax
+  mov rax, -1
+  mov [rbp-4256], rax
+  mov rax, [rbp-4248]
+  mov rdi, [rbp-4256]
+  add rax, rdi
+  mov [rbp-4264], rax
+  mov [rbp-8], rax
+  mov [rbp-4272], rax
+  mov rax, -1
+  mov [rbp-4280], rax
+  mov rax, [rbp-4272]
+  mov rdi, [rbp-4280]
+  add rax, rdi
+  mov [rbp-4288], rax
+  mov [rbp-8], rax
+  mov [rbp-4296], rax
+  mov rax, -1
+  mov [rbp-4304], rax
+  mov rax, [rbp-4296]
+  mov rdi, [rbp-4304]
+  add rax, rdi
+  mov [rbp-4312], rax
+  mov [rbp-8], rax
+  mov [rbp-4320], rax
+  mov rax, -1
+  mov [rbp-4328], rax
+  mov rax, [rbp-4320]
+  mov rdi, [rbp-4328]
+  add rax, rdi
+  mov [rbp-4336], rax
+  mov [rbp-8], rax
+  mov [rbp-4344], rax
+  mov rax, -1
+  mov [rbp-4352], rax
+  mov rax, [rbp-4344]
+  mov rdi, [rbp-4352]
+  add rax, rdi
+  mov [rbp-4360], rax
+  mov [rbp-8], rax
+  mov [rbp-4368], rax
+  mov rax, -1
+  mov [rbp-4376], rax
+  mov rax, [rbp-4368]
+  mov rdi, [rbp-4376]
+  add rax, rdi
+  mov [rbp-4384], rax
+  mov [rbp-8], rax
+  mov [rbp-4392], rax
+  mov rax, -1
+  mov [rbp-4400], rax
+  mov rax, [rbp-4392]
+  mov rdi, [rbp-4400]
+  add rax, rdi
+  mov [rbp-4408], rax
+  mov [rbp-8], rax
+  mov [rbp-4416], rax
+  mov rax, -1
+  mov [rbp-4424], rax
+  mov rax, [rbp-4416]
+  mov rdi, [rbp-4424]
+  add rax, rdi
+  mov [rbp-4432], rax
+  mov [rbp-8], rax
+  mov [rbp-4440], rax
+  mov rax, -1
+  mov [rbp-4448], rax
+  mov rax, [rbp-4440]
+  mov rdi, [rbp-4448]
+  add rax, rdi
+  mov [rbp-4456], rax
+  mov [rbp-8], rax
+  mov [rbp-4464], rax
+  mov rax, -1
+  mov [rbp-4472], rax
+  mov rax, [rbp-4464]
+  mov rdi, [rbp-4472]
+  add rax, rdi
+  mov [rbp-4480], rax
+  mov [rbp-8], rax
+  mov [rbp-4488], rax
+  mov rax, -1
+  mov [rbp-4496], rax
+  mov rax, [rbp-4488]
+  mov rdi, [rbp-4496]
+  add rax, rdi
+  mov [rbp-4504], rax
+  mov [rbp-8], rax
+  mov [rbp-4512], rax
+  mov rax, -1
+  mov [rbp-4520], rax
+  mov rax, [rbp-4512]
+  mov rdi, [rbp-4520]
+  add rax, rdi
+  mov [rbp-4528], rax
+  mov [rbp-8], rax
+  mov [rbp-4536], rax
+  mov rax, -1
+  mov [rbp-4544], rax
+  mov rax, [rbp-4536]
+  mov rdi, [rbp-4544]
+  add rax, rdi
+  mov [rbp-4552], rax
+  mov [rbp-8], rax
+  mov [rbp-4560], rax
+  mov rax, -1
+  mov [rbp-4568], rax
+  mov rax, [rbp-4560]
+  mov rdi, [rbp-4568]
+  add rax, rdi
+  mov [rbp-4576], rax
+  mov [rbp-8], rax
+  mov [rbp-4584], rax
+.Lmain.2:
+  mov rsp, rbp
+  pop rbp
+  ret
+.globl incremental_probe
+incremental_probe:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 48
+  mov [rbp-8], rdi
+.Lincremental_probe.0:
+  mov rax, [rbp-8]
+  mov [rbp-16], rax
+  mov rax, [rax]
+  mov [rbp-24], rax
+  mov rax, 1
+  mov [rbp-32], rax
+  mov rax, [rbp-24]
+  mov rdi, [rbp-32]
+  add rax, rdi
+  mov [rbp-40], rax
+.Lincremental_probe.2:
+  mov rsp, rbp
+  pop rbp
+  ret
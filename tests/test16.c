@@ -0,0 +1,12 @@
+// Test calls to C library functions
+int main() {
+    int n;
+    n = strlen("hello") + atoi("30");
+    if (abs(-7) != 7)
+        return 1;
+    // Called with n pushed without register allocation, so the stack
+    // must be padded to keep it aligned
+    if (n + strtol("12", 0, 10) != 47)
+        return 2;
+    return n;
+}
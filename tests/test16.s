@@ -0,0 +1,106 @@
+.intel_syntax noprefix
+.text
+.globl main
+main:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 176
+.Lmain.0:
+  lea rax, [rip + .Lmain.s0]
+  mov [rbp-16], rax
+  mov rdi, [rbp-16]
+  mov rax, 0
+  call strlen
+  mov [rbp-24], rax
+  lea rax, [rip + .Lmain.s1]
+  mov [rbp-32], rax
+  mov rdi, [rbp-32]
+  mov rax, 0
+  call atoi
+  mov [rbp-40], rax
+  mov rax, [rbp-24]
+  mov rdi, [rbp-40]
+  add rax, rdi
+  mov [rbp-48], rax
+  mov [rbp-8], rax
+  mov rax, -7
+  mov [rbp-56], rax
+  mov rdi, [rbp-56]
+  mov rax, 0
+  call abs
+  mov [rbp-64], rax
+  mov rax, 7
+  mov [rbp-72], rax
+  mov rax, [rbp-64]
+  mov rdi, [rbp-72]
+  cmp rax, rdi
+  je .Lmain.2
+.Lmain.1:
+  mov rax, 1
+  mov [rbp-88], rax
+  jmp .Lmain.8
+.Lmain.2:
+  mov rax, [rbp-8]
+  mov [rbp-96], rax
+  mov rax, 10
+  mov [rbp-104], rax
+  mov rax, 0
+  mov [rbp-112], rax
+  lea rax, [rip + .Lmain.s2]
+  mov [rbp-120], rax
+  mov rdi, [rbp-120]
+  mov rsi, [rbp-112]
+  mov rdx, [rbp-104]
+  mov rax, 0
+  call strtol
+  mov [rbp-128], rax
+  mov rax, [rbp-96]
+  mov rdi, [rbp-128]
+  add rax, rdi
+  mov [rbp-136], rax
+  mov rax, 47
+  mov [rbp-144], rax
+  mov rax, [rbp-136]
+  mov rdi, [rbp-144]
+  cmp rax, rdi
+  je .Lmain.5
+.Lmain.4:
+  mov rax, 2
+  mov [rbp-160], rax
+  jmp .Lmain.8
+.Lmain.5:
+  mov rax, [rbp-8]
+  mov [rbp-168], rax
+.Lmain.8:
+  mov rsp, rbp
+  pop rbp
+  ret
+.data
+.Lmain.s0:
+  .string "hello"
+.Lmain.s1:
+  .string "30"
+.Lmain.s2:
+  .string "12"
+.text
+.globl incremental_probe
+incremental_probe:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 48
+  mov [rbp-8], rdi
+.Lincremental_probe.0:
+  mov rax, [rbp-8]
+  mov [rbp-16], rax
+  mov rax, [rax]
+  mov [rbp-24], rax
+  mov rax, 1
+  mov [rbp-32], rax
+  mov rax, [rbp-24]
+  mov rdi, [rbp-32]
+  add rax, rdi
+  mov [rbp-40], rax
+.Lincremental_probe.2:
+  mov rsp, rbp
+  pop rbp
+  ret
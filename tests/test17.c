@@ -0,0 +1,49 @@
+// Test branch conditions: every comparison with constant, register and
+// memory operands on either side, and conditions that are not comparisons
+int count(int from, int to) {
+    int n;
+    n = 0;
+    while (from < to) {
+        from = from + 1;
+        n = n + 1;
+    }
+    return n;
+}
+
+int main() {
+    int a;
+    int b;
+    int c;
+    int *p;
+    int n;
+    a = 3;
+    b = 5;
+    p = &c;
+    c = 4;
+    n = 0;
+
+    if (a < b) n = n + 1;
+    if (b < a) return 1;
+    if (a <= 3) n = n + 1;
+    if (4 <= a) return 2;
+    if (b > a) n = n + 1;
+    if (a >= b) return 3;
+    if (7 > b) n = n + 1;
+    if (3 == a) n = n + 1;
+    if (a != 3) return 4;
+    if (*p == 4) n = n + 1;
+    if (c < a) return 5;
+    if (a + 1 == c) n = n + 1;
+    if (a - 3) return 6;
+    if (b) n = n + 1;
+    if (count(0, 0)) return 7;
+    if (a == b) return 8; else n = n + 1;
+
+    for (a = 10; a >= 0; a = a - 1)
+        n = n + 1;
+    for (a = 0; 5 > a; a = a + 1)
+        while (c != 0)
+            c = c - 1;
+    for (;;)
+        return n + count(2, 9) + c;
+}
@@ -0,0 +1,543 @@
+.intel_syntax noprefix
+.text
+.globl count
+count:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 128
+  mov [rbp-8], rdi
+  mov [rbp-16], rsi
+.Lcount.0:
+  mov rax, 0
+  mov [rbp-32], rax
+  mov [rbp-24], rax
+.Lcount.1:
+  mov rax, [rbp-8]
+  mov [rbp-40], rax
+  mov rax, [rbp-16]
+  mov [rbp-48], rax
+  mov rax, [rbp-40]
+  mov rdi, [rbp-48]
+  cmp rax, rdi
+  jge .Lcount.3
+.Lcount.2:
+  mov rax, [rbp-8]
+  mov [rbp-64], rax
+  mov rax, 1
+  mov [rbp-72], rax
+  mov rax, [rbp-64]
+  mov rdi, [rbp-72]
+  add rax, rdi
+  mov [rbp-80], rax
+  mov [rbp-8], rax
+  mov rax, [rbp-24]
+  mov [rbp-88], rax
+  mov rax, 1
+  mov [rbp-96], rax
+  mov rax, [rbp-88]
+  mov rdi, [rbp-96]
+  add rax, rdi
+  mov [rbp-104], rax
+  mov [rbp-24], rax
+  jmp .Lcount.1
+.Lcount.3:
+  mov rax, [rbp-24]
+  mov [rbp-112], rax
+.Lcount.5:
+  mov rsp, rbp
+  pop rbp
+  ret
+.globl main
+main:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 1248
+.Lmain.0:
+  mov rax, 3
+  mov [rbp-112], rax
+  mov [rbp-8], rax
+  mov rax, 5
+  mov [rbp-120], rax
+  mov [rbp-16], rax
+  lea rax, [rbp-24]
+  mov [rbp-128], rax
+  mov [rbp-32], rax
+  mov rax, 4
+  mov [rbp-136], rax
+  mov [rbp-24], rax
+  mov rax, 0
+  mov [rbp-144], rax
+  mov [rbp-40], rax
+  mov rax, [rbp-8]
+  mov [rbp-152], rax
+  mov rax, [rbp-16]
+  mov [rbp-160], rax
+  mov rax, [rbp-152]
+  mov rdi, [rbp-160]
+  cmp rax, rdi
+  jge .Lmain.2
+.Lmain.1:
+  mov rax, [rbp-40]
+  mov [rbp-176], rax
+  mov rax, 1
+  mov [rbp-184], rax
+  mov rax, [rbp-176]
+  mov rdi, [rbp-184]
+  add rax, rdi
+  mov [rbp-192], rax
+  mov [rbp-40], rax
+.Lmain.2:
+  mov rax, [rbp-16]
+  mov [rbp-200], rax
+  mov rax, [rbp-8]
+  mov [rbp-208], rax
+  mov rax, [rbp-200]
+  mov rdi, [rbp-208]
+  cmp rax, rdi
+  jge .Lmain.4
+.Lmain.3:
+  mov rax, 1
+  mov [rbp-224], rax
+  jmp .Lmain.65
+.Lmain.4:
+  mov rax, [rbp-8]
+  mov [rbp-232], rax
+  mov rax, 3
+  mov [rbp-240], rax
+  mov rax, [rbp-232]
+  mov rdi, [rbp-240]
+  cmp rax, rdi
+  jg .Lmain.7
+.Lmain.6:
+  mov rax, [rbp-40]
+  mov [rbp-256], rax
+  mov rax, 1
+  mov [rbp-264], rax
+  mov rax, [rbp-256]
+  mov rdi, [rbp-264]
+  add rax, rdi
+  mov [rbp-272], rax
+  mov [rbp-40], rax
+.Lmain.7:
+  mov rax, 4
+  mov [rbp-280], rax
+  mov rax, [rbp-8]
+  mov [rbp-288], rax
+  mov rax, [rbp-280]
+  mov rdi, [rbp-288]
+  cmp rax, rdi
+  jg .Lmain.9
+.Lmain.8:
+  mov rax, 2
+  mov [rbp-304], rax
+  jmp .Lmain.65
+.Lmain.9:
+  mov rax, [rbp-8]
+  mov [rbp-312], rax
+  mov rax, [rbp-16]
+  mov [rbp-320], rax
+  mov rax, [rbp-312]
+  mov rdi, [rbp-320]
+  cmp rax, rdi
+  jge .Lmain.12
+.Lmain.11:
+  mov rax, [rbp-40]
+  mov [rbp-336], rax
+  mov rax, 1
+  mov [rbp-344], rax
+  mov rax, [rbp-336]
+  mov rdi, [rbp-344]
+  add rax, rdi
+  mov [rbp-352], rax
+  mov [rbp-40], rax
+.Lmain.12:
+  mov rax, [rbp-16]
+  mov [rbp-360], rax
+  mov rax, [rbp-8]
+  mov [rbp-368], rax
+  mov rax, [rbp-360]
+  mov rdi, [rbp-368]
+  cmp rax, rdi
+  jg .Lmain.14
+.Lmain.13:
+  mov rax, 3
+  mov [rbp-384], rax
+  jmp .Lmain.65
+.Lmain.14:
+  mov rax, [rbp-16]
+  mov [rbp-392], rax
+  mov rax, 7
+  mov [rbp-400], rax
+  mov rax, [rbp-392]
+  mov rdi, [rbp-400]
+  cmp rax, rdi
+  jge .Lmain.17
+.Lmain.16:
+  mov rax, [rbp-40]
+  mov [rbp-416], rax
+  mov rax, 1
+  mov [rbp-424], rax
+  mov rax, [rbp-416]
+  mov rdi, [rbp-424]
+  add rax, rdi
+  mov [rbp-432], rax
+  mov [rbp-40], rax
+.Lmain.17:
+  mov rax, [rbp-8]
+  mov [rbp-440], rax
+  mov rax, 3
+  mov [rbp-448], rax
+  mov rax, [rbp-440]
+  mov rdi, [rbp-448]
+  cmp rax, rdi
+  jne .Lmain.19
+.Lmain.18:
+  mov rax, [rbp-40]
+  mov [rbp-464], rax
+  mov rax, 1
+  mov [rbp-472], rax
+  mov rax, [rbp-464]
+  mov rdi, [rbp-472]
+  add rax, rdi
+  mov [rbp-480], rax
+  mov [rbp-40], rax
+.Lmain.19:
+  mov rax, [rbp-8]
+  mov [rbp-488], rax
+  mov rax, 3
+  mov [rbp-496], rax
+  mov rax, [rbp-488]
+  mov rdi, [rbp-496]
+  cmp rax, rdi
+  je .Lmain.21
+.Lmain.20:
+  mov rax, 4
+  mov [rbp-512], rax
+  jmp .Lmain.65
+.Lmain.21:
+  mov rax, [rbp-32]
+  mov [rbp-520], rax
+  mov rax, [rax]
+  mov [rbp-528], rax
+  mov rax, 4
+  mov [rbp-536], rax
+  mov rax, [rbp-528]
+  mov rdi, [rbp-536]
+  cmp rax, rdi
+  jne .Lmain.24
+.Lmain.23:
+  mov rax, [rbp-40]
+  mov [rbp-552], rax
+  mov rax, 1
+  mov [rbp-560], rax
+  mov rax, [rbp-552]
+  mov rdi, [rbp-560]
+  add rax, rdi
+  mov [rbp-568], rax
+  mov [rbp-40], rax
+.Lmain.24:
+  mov rax, [rbp-24]
+  mov [rbp-576], rax
+  mov rax, [rbp-8]
+  mov [rbp-584], rax
+  mov rax, [rbp-576]
+  mov rdi, [rbp-584]
+  cmp rax, rdi
+  jge .Lmain.26
+.Lmain.25:
+  mov rax, 5
+  mov [rbp-600], rax
+  jmp .Lmain.65
+.Lmain.26:
+  mov rax, [rbp-8]
+  mov [rbp-608], rax
+  mov rax, 1
+  mov [rbp-616], rax
+  mov rax, [rbp-608]
+  mov rdi, [rbp-616]
+  add rax, rdi
+  mov [rbp-624], rax
+  mov rax, [rbp-24]
+  mov [rbp-632], rax
+  mov rax, [rbp-624]
+  mov rdi, [rbp-632]
+  cmp rax, rdi
+  jne .Lmain.29
+.Lmain.28:
+  mov rax, [rbp-40]
+  mov [rbp-648], rax
+  mov rax, 1
+  mov [rbp-656], rax
+  mov rax, [rbp-648]
+  mov rdi, [rbp-656]
+  add rax, rdi
+  mov [rbp-664], rax
+  mov [rbp-40], rax
+.Lmain.29:
+  mov rax, [rbp-8]
+  mov [rbp-672], rax
+  mov rax, -3
+  mov [rbp-680], rax
+  mov rax, [rbp-672]
+  mov rdi, [rbp-680]
+  add rax, rdi
+  mov [rbp-688], rax
+  test rax, rax
+  je .Lmain.31
+.Lmain.30:
+  mov rax, 6
+  mov [rbp-696], rax
+  jmp .Lmain.65
+.Lmain.31:
+  mov rax, [rbp-16]
+  mov [rbp-704], rax
+  test rax, rax
+  je .Lmain.34
+.Lmain.33:
+  mov rax, [rbp-40]
+  mov [rbp-712], rax
+  mov rax, 1
+  mov [rbp-720], rax
+  mov rax, [rbp-712]
+  mov rdi, [rbp-720]
+  add rax, rdi
+  mov [rbp-728], rax
+  mov [rbp-40], rax
+.Lmain.34:
+  mov rax, 0
+  mov [rbp-736], rax
+  mov [rbp-56], rax
+  mov rax, 0
+  mov [rbp-744], rax
+  mov [rbp-48], rax
+  mov rax, 0
+  mov [rbp-752], rax
+  mov [rbp-64], rax
+.Lmain.38:
+  mov rax, [rbp-48]
+  mov [rbp-760], rax
+  mov rax, [rbp-56]
+  mov [rbp-768], rax
+  mov rax, [rbp-760]
+  mov rdi, [rbp-768]
+  cmp rax, rdi
+  jge .Lmain.40
+.Lmain.39:
+  mov rax, [rbp-48]
+  mov [rbp-784], rax
+  mov rax, 1
+  mov [rbp-792], rax
+  mov rax, [rbp-784]
+  mov rdi, [rbp-792]
+  add rax, rdi
+  mov [rbp-800], rax
+  mov [rbp-48], rax
+  mov rax, [rbp-64]
+  mov [rbp-808], rax
+  mov rax, 1
+  mov [rbp-816], rax
+  mov rax, [rbp-808]
+  mov rdi, [rbp-816]
+  add rax, rdi
+  mov [rbp-824], rax
+  mov [rbp-64], rax
+  jmp .Lmain.38
+.Lmain.40:
+  mov rax, [rbp-64]
+  mov [rbp-832], rax
+  mov [rbp-72], rax
+.Lmain.37:
+  mov rax, [rbp-72]
+  mov [rbp-840], rax
+  test rax, rax
+  je .Lmain.36
+.Lmain.35:
+  mov rax, 7
+  mov [rbp-848], rax
+  jmp .Lmain.65
+.Lmain.36:
+  mov rax, [rbp-8]
+  mov [rbp-856], rax
+  mov rax, [rbp-16]
+  mov [rbp-864], rax
+  mov rax, [rbp-856]
+  mov rdi, [rbp-864]
+  cmp rax, rdi
+  jne .Lmain.44
+.Lmain.43:
+  mov rax, 8
+  mov [rbp-880], rax
+  jmp .Lmain.65
+.Lmain.44:
+  mov rax, [rbp-40]
+  mov [rbp-888], rax
+  mov rax, 1
+  mov [rbp-896], rax
+  mov rax, [rbp-888]
+  mov rdi, [rbp-896]
+  add rax, rdi
+  mov [rbp-904], rax
+  mov [rbp-40], rax
+.Lmain.45:
+  mov rax, 10
+  mov [rbp-912], rax
+  mov [rbp-8], rax
+.Lmain.47:
+  mov rax, 0
+  mov [rbp-920], rax
+  mov rax, [rbp-8]
+  mov [rbp-928], rax
+  mov rax, [rbp-920]
+  mov rdi, [rbp-928]
+  cmp rax, rdi
+  jg .Lmain.49
+.Lmain.48:
+  mov rax, [rbp-40]
+  mov [rbp-944], rax
+  mov rax, 1
+  mov [rbp-952], rax
+  mov rax, [rbp-944]
+  mov rdi, [rbp-952]
+  add rax, rdi
+  mov [rbp-960], rax
+  mov [rbp-40], rax
+  mov rax, [rbp-8]
+  mov [rbp-968], rax
+  mov rax, -1
+  mov [rbp-976], rax
+  mov rax, [rbp-968]
+  mov rdi, [rbp-976]
+  add rax, rdi
+  mov [rbp-984], rax
+  mov [rbp-8], rax
+  jmp .Lmain.47
+.Lmain.49:
+  mov rax, 0
+  mov [rbp-992], rax
+  mov [rbp-8], rax
+.Lmain.50:
+  mov rax, [rbp-8]
+  mov [rbp-1000], rax
+  mov rax, 5
+  mov [rbp-1008], rax
+  mov rax, [rbp-1000]
+  mov rdi, [rbp-1008]
+  cmp rax, rdi
+  jge .Lmain.52
+.Lmain.51:
+.Lmain.53:
+  mov rax, [rbp-24]
+  mov [rbp-1024], rax
+  mov rax, 0
+  mov [rbp-1032], rax
+  mov rax, [rbp-1024]
+  mov rdi, [rbp-1032]
+  cmp rax, rdi
+  je .Lmain.55
+.Lmain.54:
+  mov rax, [rbp-24]
+  mov [rbp-1048], rax
+  mov rax, -1
+  mov [rbp-1056], rax
+  mov rax, [rbp-1048]
+  mov rdi, [rbp-1056]
+  add rax, rdi
+  mov [rbp-1064], rax
+  mov [rbp-24], rax
+  jmp .Lmain.53
+.Lmain.55:
+  mov rax, [rbp-8]
+  mov [rbp-1072], rax
+  mov rax, 1
+  mov [rbp-1080], rax
+  mov rax, [rbp-1072]
+  mov rdi, [rbp-1080]
+  add rax, rdi
+  mov [rbp-1088], rax
+  mov [rbp-8], rax
+  jmp .Lmain.50
+.Lmain.52:
+.Lmain.56:
+.Lmain.57:
+  mov rax, [rbp-40]
+  mov [rbp-1096], rax
+  mov rax, 9
+  mov [rbp-1104], rax
+  mov [rbp-88], rax
+  mov rax, 2
+  mov [rbp-1112], rax
+  mov [rbp-80], rax
+  mov rax, 0
+  mov [rbp-1120], rax
+  mov [rbp-96], rax
+.Lmain.60:
+  mov rax, [rbp-80]
+  mov [rbp-1128], rax
+  mov rax, [rbp-88]
+  mov [rbp-1136], rax
+  mov rax, [rbp-1128]
+  mov rdi, [rbp-1136]
+  cmp rax, rdi
+  jge .Lmain.62
+.Lmain.61:
+  mov rax, [rbp-80]
+  mov [rbp-1152], rax
+  mov rax, 1
+  mov [rbp-1160], rax
+  mov rax, [rbp-1152]
+  mov rdi, [rbp-1160]
+  add rax, rdi
+  mov [rbp-1168], rax
+  mov [rbp-80], rax
+  mov rax, [rbp-96]
+  mov [rbp-1176], rax
+  mov rax, 1
+  mov [rbp-1184], rax
+  mov rax, [rbp-1176]
+  mov rdi, [rbp-1184]
+  add rax, rdi
+  mov [rbp-1192], rax
+  mov [rbp-96], rax
+  jmp .Lmain.60
+.Lmain.62:
+  mov rax, [rbp-96]
+  mov [rbp-1200], rax
+  mov [rbp-104], rax
+.Lmain.59:
+  mov rax, [rbp-104]
+  mov [rbp-1208], rax
+  mov rax, [rbp-1096]
+  mov rdi, [rbp-1208]
+  add rax, rdi
+  mov [rbp-1216], rax
+  mov rax, [rbp-24]
+  mov [rbp-1224], rax
+  mov rax, [rbp-1216]
+  mov rdi, [rbp-1224]
+  add rax, rdi
+  mov [rbp-1232], rax
+.Lmain.65:
+  mov rsp, rbp
+  pop rbp
+  ret
+.globl incremental_probe
+incremental_probe:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 48
+  mov [rbp-8], rdi
+.Lincremental_probe.0:
+  mov rax, [rbp-8]
+  mov [rbp-16], rax
+  mov rax, [rax]
+  mov [rbp-24], rax
+  mov rax, 1
+  mov [rbp-32], rax
+  mov rax, [rbp-24]
+  mov rdi, [rbp-32]
+  add rax, rdi
+  mov [rbp-40], rax
+.Lincremental_probe.2:
+  mov rsp, rbp
+  pop rbp
+  ret
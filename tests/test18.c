@@ -0,0 +1,55 @@
+// Test inlined calls: early returns, loops, locals whose address is taken,
+// writes through pointer parameters and calls nested in arguments
+int sq(int x) {
+    return x * x;
+}
+
+int clamp(int v, int lo, int hi) {
+    if (v < lo)
+        return lo;
+    if (v > hi)
+        return hi;
+    return v;
+}
+
+int sum_to(int n) {
+    int s;
+    s = 0;
+    while (n > 0) {
+        s = s + n;
+        n = n - 1;
+    }
+    return s;
+}
+
+int bump(int *p) {
+    *p = *p + 1;
+    return *p;
+}
+
+int via_addr(int x) {
+    int y;
+    int *q;
+    q = &y;
+    *q = x + 2;
+    return y;
+}
+
+int main() {
+    int i;
+    int n;
+    int c;
+    n = 0;
+    c = 0;
+    for (i = 0; i < 10; i = i + 1)
+        n = n + clamp(sq(i), 4, 50);
+    if (sum_to(4) != 10)
+        return 1;
+    while (bump(&c) < 5)
+        n = n + 1;
+    if (sq(sq(2)) != 16)
+        return 2;
+    if (via_addr(via_addr(1)) != 5)
+        return 3;
+    return n - 200 + 1 + sq(2) * clamp(100, 0, 3) - via_addr(sum_to(3));
+}
@@ -0,0 +1,619 @@
+.intel_syntax noprefix
+.text
+.globl sq
+sq:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 48
+  mov [rbp-8], rdi
+.Lsq.0:
+  mov rax, [rbp-8]
+  mov [rbp-16], rax
+  mov rax, [rbp-8]
+  mov [rbp-24], rax
+  mov rax, [rbp-16]
+  mov rdi, [rbp-24]
+  imul rax, rdi
+  mov [rbp-32], rax
+.Lsq.2:
+  mov rsp, rbp
+  pop rbp
+  ret
+.globl clamp
+clamp:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 112
+  mov [rbp-8], rdi
+  mov [rbp-16], rsi
+  mov [rbp-24], rdx
+.Lclamp.0:
+  mov rax, [rbp-8]
+  mov [rbp-32], rax
+  mov rax, [rbp-16]
+  mov [rbp-40], rax
+  mov rax, [rbp-32]
+  mov rdi, [rbp-40]
+  cmp rax, rdi
+  jge .Lclamp.2
+.Lclamp.1:
+  mov rax, [rbp-16]
+  mov [rbp-56], rax
+  jmp .Lclamp.8
+.Lclamp.2:
+  mov rax, [rbp-24]
+  mov [rbp-64], rax
+  mov rax, [rbp-8]
+  mov [rbp-72], rax
+  mov rax, [rbp-64]
+  mov rdi, [rbp-72]
+  cmp rax, rdi
+  jge .Lclamp.5
+.Lclamp.4:
+  mov rax, [rbp-24]
+  mov [rbp-88], rax
+  jmp .Lclamp.8
+.Lclamp.5:
+  mov rax, [rbp-8]
+  mov [rbp-96], rax
+.Lclamp.8:
+  mov rsp, rbp
+  pop rbp
+  ret
+.globl sum_to
+sum_to:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 112
+  mov [rbp-8], rdi
+.Lsum_to.0:
+  mov rax, 0
+  mov [rbp-24], rax
+  mov [rbp-16], rax
+.Lsum_to.1:
+  mov rax, 0
+  mov [rbp-32], rax
+  mov rax, [rbp-8]
+  mov [rbp-40], rax
+  mov rax, [rbp-32]
+  mov rdi, [rbp-40]
+  cmp rax, rdi
+  jge .Lsum_to.3
+.Lsum_to.2:
+  mov rax, [rbp-16]
+  mov [rbp-56], rax
+  mov rax, [rbp-8]
+  mov [rbp-64], rax
+  mov rax, [rbp-56]
+  mov rdi, [rbp-64]
+  add rax, rdi
+  mov [rbp-72], rax
+  mov [rbp-16], rax
+  mov rax, [rbp-8]
+  mov [rbp-80], rax
+  mov rax, -1
+  mov [rbp-88], rax
+  mov rax, [rbp-80]
+  mov rdi, [rbp-88]
+  add rax, rdi
+  mov [rbp-96], rax
+  mov [rbp-8], rax
+  jmp .Lsum_to.1
+.Lsum_to.3:
+  mov rax, [rbp-16]
+  mov [rbp-104], rax
+.Lsum_to.5:
+  mov rsp, rbp
+  pop rbp
+  ret
+.globl bump
+bump:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 80
+  mov [rbp-8], rdi
+.Lbump.0:
+  mov rax, [rbp-8]
+  mov [rbp-16], rax
+  mov rax, [rbp-8]
+  mov [rbp-24], rax
+  mov rax, [rax]
+  mov [rbp-32], rax
+  mov rax, 1
+  mov [rbp-40], rax
+  mov rax, [rbp-32]
+  mov rdi, [rbp-40]
+  add rax, rdi
+  mov [rbp-48], rax
+  mov rdi, [rbp-16]
+  mov rax, [rbp-48]
+  mov [rdi], rax
+  mov rax, [rbp-8]
+  mov [rbp-56], rax
+  mov rax, [rax]
+  mov [rbp-64], rax
+.Lbump.2:
+  mov rsp, rbp
+  pop rbp
+  ret
+.globl via_addr
+via_addr:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 80
+  mov [rbp-8], rdi
+.Lvia_addr.0:
+  lea rax, [rbp-16]
+  mov [rbp-32], rax
+  mov [rbp-24], rax
+  mov [rbp-40], rax
+  mov rax, [rbp-8]
+  mov [rbp-48], rax
+  mov rax, 2
+  mov [rbp-56], rax
+  mov rax, [rbp-48]
+  mov rdi, [rbp-56]
+  add rax, rdi
+  mov [rbp-64], rax
+  mov rdi, [rbp-40]
+  mov rax, [rbp-64]
+  mov [rdi], rax
+  mov rax, [rbp-16]
+  mov [rbp-72], rax
+.Lvia_addr.2:
+  mov rsp, rbp
+  pop rbp
+  ret
+.globl main
+main:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 1376
+.Lmain.0:
+  mov rax, 0
+  mov [rbp-320], rax
+  mov [rbp-16], rax
+  mov rax, 0
+  mov [rbp-328], rax
+  mov [rbp-24], rax
+  mov rax, 0
+  mov [rbp-336], rax
+  mov [rbp-8], rax
+.Lmain.1:
+  mov rax, [rbp-8]
+  mov [rbp-344], rax
+  mov rax, 10
+  mov [rbp-352], rax
+  mov rax, [rbp-344]
+  mov rdi, [rbp-352]
+  cmp rax, rdi
+  jge .Lmain.3
+.Lmain.2:
+  mov rax, [rbp-16]
+  mov [rbp-368], rax
+  mov rax, 50
+  mov [rbp-376], rax
+  mov [rbp-64], rax
+  mov rax, 4
+  mov [rbp-384], rax
+  mov [rbp-56], rax
+  mov rax, [rbp-8]
+  mov [rbp-392], rax
+  mov [rbp-32], rax
+  mov [rbp-400], rax
+  mov rax, [rbp-32]
+  mov [rbp-408], rax
+  mov rax, [rbp-400]
+  mov rdi, [rbp-408]
+  imul rax, rdi
+  mov [rbp-416], rax
+  mov [rbp-40], rax
+.Lmain.5:
+  mov rax, [rbp-40]
+  mov [rbp-424], rax
+  mov [rbp-48], rax
+  mov [rbp-432], rax
+  mov rax, [rbp-56]
+  mov [rbp-440], rax
+  mov rax, [rbp-432]
+  mov rdi, [rbp-440]
+  cmp rax, rdi
+  jge .Lmain.8
+.Lmain.7:
+  mov rax, [rbp-56]
+  mov [rbp-456], rax
+  mov [rbp-72], rax
+  jmp .Lmain.4
+.Lmain.8:
+  mov rax, [rbp-64]
+  mov [rbp-464], rax
+  mov rax, [rbp-48]
+  mov [rbp-472], rax
+  mov rax, [rbp-464]
+  mov rdi, [rbp-472]
+  cmp rax, rdi
+  jge .Lmain.11
+.Lmain.10:
+  mov rax, [rbp-64]
+  mov [rbp-488], rax
+  mov [rbp-72], rax
+  jmp .Lmain.4
+.Lmain.11:
+  mov rax, [rbp-48]
+  mov [rbp-496], rax
+  mov [rbp-72], rax
+.Lmain.4:
+  mov rax, [rbp-72]
+  mov [rbp-504], rax
+  mov rax, [rbp-368]
+  mov rdi, [rbp-504]
+  add rax, rdi
+  mov [rbp-512], rax
+  mov [rbp-16], rax
+  mov rax, [rbp-8]
+  mov [rbp-520], rax
+  mov rax, 1
+  mov [rbp-528], rax
+  mov rax, [rbp-520]
+  mov rdi, [rbp-528]
+  add rax, rdi
+  mov [rbp-536], rax
+  mov [rbp-8], rax
+  jmp .Lmain.1
+.Lmain.3:
+  mov rax, 4
+  mov [rbp-544], rax
+  mov [rbp-80], rax
+  mov rax, 0
+  mov [rbp-552], rax
+  mov [rbp-88], rax
+.Lmain.17:
+  mov rax, 0
+  mov [rbp-560], rax
+  mov rax, [rbp-80]
+  mov [rbp-568], rax
+  mov rax, [rbp-560]
+  mov rdi, [rbp-568]
+  cmp rax, rdi
+  jge .Lmain.19
+.Lmain.18:
+  mov rax, [rbp-88]
+  mov [rbp-584], rax
+  mov rax, [rbp-80]
+  mov [rbp-592], rax
+  mov rax, [rbp-584]
+  mov rdi, [rbp-592]
+  add rax, rdi
+  mov [rbp-600], rax
+  mov [rbp-88], rax
+  mov rax, [rbp-80]
+  mov [rbp-608], rax
+  mov rax, -1
+  mov [rbp-616], rax
+  mov rax, [rbp-608]
+  mov rdi, [rbp-616]
+  add rax, rdi
+  mov [rbp-624], rax
+  mov [rbp-80], rax
+  jmp .Lmain.17
+.Lmain.19:
+  mov rax, [rbp-88]
+  mov [rbp-632], rax
+  mov [rbp-96], rax
+.Lmain.16:
+  mov rax, [rbp-96]
+  mov [rbp-640], rax
+  mov rax, 10
+  mov [rbp-648], rax
+  mov rax, [rbp-640]
+  mov rdi, [rbp-648]
+  cmp rax, rdi
+  je .Lmain.15
+.Lmain.14:
+  mov rax, 1
+  mov [rbp-664], rax
+  jmp .Lmain.59
+.Lmain.15:
+.Lmain.22:
+  lea rax, [rbp-24]
+  mov [rbp-672], rax
+  mov [rbp-104], rax
+  mov [rbp-680], rax
+  mov rax, [rbp-104]
+  mov [rbp-688], rax
+  mov rax, [rax]
+  mov [rbp-696], rax
+  mov rax, 1
+  mov [rbp-704], rax
+  mov rax, [rbp-696]
+  mov rdi, [rbp-704]
+  add rax, rdi
+  mov [rbp-712], rax
+  mov rdi, [rbp-680]
+  mov rax, [rbp-712]
+  mov [rdi], rax
+  mov rax, [rbp-104]
+  mov [rbp-720], rax
+  mov rax, [rax]
+  mov [rbp-728], rax
+  mov [rbp-112], rax
+.Lmain.25:
+  mov rax, [rbp-112]
+  mov [rbp-736], rax
+  mov rax, 5
+  mov [rbp-744], rax
+  mov rax, [rbp-736]
+  mov rdi, [rbp-744]
+  cmp rax, rdi
+  jge .Lmain.24
+.Lmain.23:
+  mov rax, [rbp-16]
+  mov [rbp-760], rax
+  mov rax, 1
+  mov [rbp-768], rax
+  mov rax, [rbp-760]
+  mov rdi, [rbp-768]
+  add rax, rdi
+  mov [rbp-776], rax
+  mov [rbp-16], rax
+  jmp .Lmain.22
+.Lmain.24:
+  mov rax, 2
+  mov [rbp-784], rax
+  mov [rbp-120], rax
+  mov [rbp-792], rax
+  mov rax, [rbp-120]
+  mov [rbp-800], rax
+  mov rax, [rbp-792]
+  mov rdi, [rbp-800]
+  imul rax, rdi
+  mov [rbp-808], rax
+  mov [rbp-128], rax
+.Lmain.30:
+  mov rax, [rbp-128]
+  mov [rbp-816], rax
+  mov [rbp-136], rax
+  mov [rbp-824], rax
+  mov rax, [rbp-136]
+  mov [rbp-832], rax
+  mov rax, [rbp-824]
+  mov rdi, [rbp-832]
+  imul rax, rdi
+  mov [rbp-840], rax
+  mov [rbp-144], rax
+.Lmain.29:
+  mov rax, [rbp-144]
+  mov [rbp-848], rax
+  mov rax, 16
+  mov [rbp-856], rax
+  mov rax, [rbp-848]
+  mov rdi, [rbp-856]
+  cmp rax, rdi
+  je .Lmain.28
+.Lmain.27:
+  mov rax, 2
+  mov [rbp-872], rax
+  jmp .Lmain.59
+.Lmain.28:
+  mov rax, 1
+  mov [rbp-880], rax
+  mov [rbp-152], rax
+  lea rax, [rbp-160]
+  mov [rbp-888], rax
+  mov [rbp-168], rax
+  mov [rbp-896], rax
+  mov rax, [rbp-152]
+  mov [rbp-904], rax
+  mov rax, 2
+  mov [rbp-912], rax
+  mov rax, [rbp-904]
+  mov rdi, [rbp-912]
+  add rax, rdi
+  mov [rbp-920], rax
+  mov rdi, [rbp-896]
+  mov rax, [rbp-920]
+  mov [rdi], rax
+  mov rax, [rbp-160]
+  mov [rbp-928], rax
+  mov [rbp-176], rax
+.Lmain.37:
+  mov rax, [rbp-176]
+  mov [rbp-936], rax
+  mov [rbp-184], rax
+  lea rax, [rbp-192]
+  mov [rbp-944], rax
+  mov [rbp-200], rax
+  mov [rbp-952], rax
+  mov rax, [rbp-184]
+  mov [rbp-960], rax
+  mov rax, 2
+  mov [rbp-968], rax
+  mov rax, [rbp-960]
+  mov rdi, [rbp-968]
+  add rax, rdi
+  mov [rbp-976], rax
+  mov rdi, [rbp-952]
+  mov rax, [rbp-976]
+  mov [rdi], rax
+  mov rax, [rbp-192]
+  mov [rbp-984], rax
+  mov [rbp-208], rax
+.Lmain.36:
+  mov rax, [rbp-208]
+  mov [rbp-992], rax
+  mov rax, 5
+  mov [rbp-1000], rax
+  mov rax, [rbp-992]
+  mov rdi, [rbp-1000]
+  cmp rax, rdi
+  je .Lmain.35
+.Lmain.34:
+  mov rax, 3
+  mov [rbp-1016], rax
+  jmp .Lmain.59
+.Lmain.35:
+  mov rax, [rbp-16]
+  mov [rbp-1024], rax
+  mov rax, -199
+  mov [rbp-1032], rax
+  mov rax, [rbp-1024]
+  mov rdi, [rbp-1032]
+  add rax, rdi
+  mov [rbp-1040], rax
+  mov rax, 2
+  mov [rbp-1048], rax
+  mov [rbp-216], rax
+  mov [rbp-1056], rax
+  mov rax, [rbp-216]
+  mov [rbp-1064], rax
+  mov rax, [rbp-1056]
+  mov rdi, [rbp-1064]
+  imul rax, rdi
+  mov [rbp-1072], rax
+  mov [rbp-224], rax
+.Lmain.41:
+  mov rax, [rbp-224]
+  mov [rbp-1080], rax
+  mov rax, 3
+  mov [rbp-1088], rax
+  mov [rbp-248], rax
+  mov rax, 0
+  mov [rbp-1096], rax
+  mov [rbp-240], rax
+  mov rax, 100
+  mov [rbp-1104], rax
+  mov [rbp-232], rax
+  mov [rbp-1112], rax
+  mov rax, [rbp-240]
+  mov [rbp-1120], rax
+  mov rax, [rbp-1112]
+  mov rdi, [rbp-1120]
+  cmp rax, rdi
+  jge .Lmain.45
+.Lmain.44:
+  mov rax, [rbp-240]
+  mov [rbp-1136], rax
+  mov [rbp-256], rax
+  jmp .Lmain.43
+.Lmain.45:
+  mov rax, [rbp-248]
+  mov [rbp-1144], rax
+  mov rax, [rbp-232]
+  mov [rbp-1152], rax
+  mov rax, [rbp-1144]
+  mov rdi, [rbp-1152]
+  cmp rax, rdi
+  jge .Lmain.48
+.Lmain.47:
+  mov rax, [rbp-248]
+  mov [rbp-1168], rax
+  mov [rbp-256], rax
+  jmp .Lmain.43
+.Lmain.48:
+  mov rax, [rbp-232]
+  mov [rbp-1176], rax
+  mov [rbp-256], rax
+.Lmain.43:
+  mov rax, [rbp-256]
+  mov [rbp-1184], rax
+  mov rax, [rbp-1080]
+  mov rdi, [rbp-1184]
+  imul rax, rdi
+  mov [rbp-1192], rax
+  mov rax, [rbp-1040]
+  mov rdi, [rbp-1192]
+  add rax, rdi
+  mov [rbp-1200], rax
+  mov rax, 3
+  mov [rbp-1208], rax
+  mov [rbp-264], rax
+  mov rax, 0
+  mov [rbp-1216], rax
+  mov [rbp-272], rax
+.Lmain.53:
+  mov rax, 0
+  mov [rbp-1224], rax
+  mov rax, [rbp-264]
+  mov [rbp-1232], rax
+  mov rax, [rbp-1224]
+  mov rdi, [rbp-1232]
+  cmp rax, rdi
+  jge .Lmain.55
+.Lmain.54:
+  mov rax, [rbp-272]
+  mov [rbp-1248], rax
+  mov rax, [rbp-264]
+  mov [rbp-1256], rax
+  mov rax, [rbp-1248]
+  mov rdi, [rbp-1256]
+  add rax, rdi
+  mov [rbp-1264], rax
+  mov [rbp-272], rax
+  mov rax, [rbp-264]
+  mov [rbp-1272], rax
+  mov rax, -1
+  mov [rbp-1280], rax
+  mov rax, [rbp-1272]
+  mov rdi, [rbp-1280]
+  add rax, rdi
+  mov [rbp-1288], rax
+  mov [rbp-264], rax
+  jmp .Lmain.53
+.Lmain.55:
+  mov rax, [rbp-272]
+  mov [rbp-1296], rax
+  mov [rbp-280], rax
+.Lmain.52:
+  mov rax, [rbp-280]
+  mov [rbp-1304], rax
+  mov [rbp-288], rax
+  lea rax, [rbp-296]
+  mov [rbp-1312], rax
+  mov [rbp-304], rax
+  mov [rbp-1320], rax
+  mov rax, [rbp-288]
+  mov [rbp-1328], rax
+  mov rax, 2
+  mov [rbp-1336], rax
+  mov rax, [rbp-1328]
+  mov rdi, [rbp-1336]
+  add rax, rdi
+  mov [rbp-1344], rax
+  mov rdi, [rbp-1320]
+  mov rax, [rbp-1344]
+  mov [rdi], rax
+  mov rax, [rbp-296]
+  mov [rbp-1352], rax
+  mov [rbp-312], rax
+.Lmain.51:
+  mov rax, [rbp-312]
+  mov [rbp-1360], rax
+  mov rax, [rbp-1200]
+  mov rdi, [rbp-1360]
+  sub rax, rdi
+  mov [rbp-1368], rax
+.Lmain.59:
+  mov rsp, rbp
+  pop rbp
+  ret
+.globl incremental_probe
+incremental_probe:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 48
+  mov [rbp-8], rdi
+.Lincremental_probe.0:
+  mov rax, [rbp-8]
+  mov [rbp-16], rax
+  mov rax, [rax]
+  mov [rbp-24], rax
+  mov rax, 1
+  mov [rbp-32], rax
+  mov rax, [rbp-24]
+  mov rdi, [rbp-32]
+  add rax, rdi
+  mov [rbp-40], rax
+.Lincremental_probe.2:
+  mov rsp, rbp
+  pop rbp
+  ret
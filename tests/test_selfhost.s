@@ -0,0 +1,235 @@
+.intel_syntax noprefix
+.text
+.globl tokenize
+tokenize:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 96
+  mov [rbp-8], rdi
+.Ltokenize.0:
+  mov rax, [rbp-8]
+  mov [rbp-24], rax
+  mov [rbp-16], rax
+.Ltokenize.1:
+  mov rax, 0
+  mov [rbp-32], rax
+  mov rax, [rbp-16]
+  mov [rbp-40], rax
+  mov rax, [rbp-32]
+  mov rdi, [rbp-40]
+  cmp rax, rdi
+  jge .Ltokenize.3
+.Ltokenize.2:
+  mov rax, [rbp-16]
+  mov [rbp-56], rax
+  mov rax, -1
+  mov [rbp-64], rax
+  mov rax, [rbp-56]
+  mov rdi, [rbp-64]
+  add rax, rdi
+  mov [rbp-72], rax
+  mov [rbp-16], rax
+  jmp .Ltokenize.1
+.Ltokenize.3:
+  mov rax, [rbp-16]
+  mov [rbp-80], rax
+.Ltokenize.5:
+  mov rsp, rbp
+  pop rbp
+  ret
+.globl parse
+parse:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 128
+  mov [rbp-8], rdi
+.Lparse.0:
+  mov rax, 0
+  mov [rbp-32], rax
+  mov [rbp-24], rax
+  mov rax, 0
+  mov [rbp-40], rax
+  mov [rbp-16], rax
+.Lparse.1:
+  mov rax, [rbp-16]
+  mov [rbp-48], rax
+  mov rax, [rbp-8]
+  mov [rbp-56], rax
+  mov rax, [rbp-48]
+  mov rdi, [rbp-56]
+  cmp rax, rdi
+  jge .Lparse.3
+.Lparse.2:
+  mov rax, [rbp-24]
+  mov [rbp-72], rax
+  mov rax, [rbp-16]
+  mov [rbp-80], rax
+  mov rax, [rbp-72]
+  mov rdi, [rbp-80]
+  add rax, rdi
+  mov [rbp-88], rax
+  mov [rbp-24], rax
+  mov rax, [rbp-16]
+  mov [rbp-96], rax
+  mov rax, 1
+  mov [rbp-104], rax
+  mov rax, [rbp-96]
+  mov rdi, [rbp-104]
+  add rax, rdi
+  mov [rbp-112], rax
+  mov [rbp-16], rax
+  jmp .Lparse.1
+.Lparse.3:
+  mov rax, [rbp-24]
+  mov [rbp-120], rax
+.Lparse.5:
+  mov rsp, rbp
+  pop rbp
+  ret
+.globl codegen
+codegen:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 96
+  mov [rbp-8], rdi
+.Lcodegen.0:
+  mov rax, 10
+  mov [rbp-16], rax
+  mov rax, [rbp-8]
+  mov [rbp-24], rax
+  mov rax, [rbp-16]
+  mov rdi, [rbp-24]
+  cmp rax, rdi
+  jge .Lcodegen.2
+.Lcodegen.1:
+  mov rax, [rbp-8]
+  mov [rbp-40], rax
+  mov rax, 2
+  mov [rbp-48], rax
+  mov rax, [rbp-40]
+  mov rdi, [rbp-48]
+  imul rax, rdi
+  mov [rbp-56], rax
+  jmp .Lcodegen.6
+.Lcodegen.2:
+  mov rax, [rbp-8]
+  mov [rbp-64], rax
+  mov rax, 5
+  mov [rbp-72], rax
+  mov rax, [rbp-64]
+  mov rdi, [rbp-72]
+  add rax, rdi
+  mov [rbp-80], rax
+.Lcodegen.6:
+  mov rsp, rbp
+  pop rbp
+  ret
+.globl main
+main:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 288
+.Lmain.0:
+  mov rax, 15
+  mov [rbp-80], rax
+  mov [rbp-8], rax
+  mov [rbp-88], rax
+  mov [rbp-40], rax
+  mov [rbp-96], rax
+  mov [rbp-48], rax
+.Lmain.2:
+  mov rax, 0
+  mov [rbp-104], rax
+  mov rax, [rbp-48]
+  mov [rbp-112], rax
+  mov rax, [rbp-104]
+  mov rdi, [rbp-112]
+  cmp rax, rdi
+  jge .Lmain.4
+.Lmain.3:
+  mov rax, [rbp-48]
+  mov [rbp-128], rax
+  mov rax, -1
+  mov [rbp-136], rax
+  mov rax, [rbp-128]
+  mov rdi, [rbp-136]
+  add rax, rdi
+  mov [rbp-144], rax
+  mov [rbp-48], rax
+  jmp .Lmain.2
+.Lmain.4:
+  mov rax, [rbp-48]
+  mov [rbp-152], rax
+  mov [rbp-56], rax
+.Lmain.1:
+  mov rax, [rbp-56]
+  mov [rbp-160], rax
+  mov [rbp-16], rax
+  mov rax, 10
+  mov [rbp-168], rax
+  mov rdi, [rbp-168]
+  mov rax, 0
+  call parse
+  mov [rbp-176], rax
+  mov [rbp-24], rax
+  mov [rbp-184], rax
+  mov [rbp-64], rax
+  mov rax, 10
+  mov [rbp-192], rax
+  mov rax, [rbp-64]
+  mov [rbp-200], rax
+  mov rax, [rbp-192]
+  mov rdi, [rbp-200]
+  cmp rax, rdi
+  jge .Lmain.8
+.Lmain.7:
+  mov rax, [rbp-64]
+  mov [rbp-216], rax
+  mov rax, 2
+  mov [rbp-224], rax
+  mov rax, [rbp-216]
+  mov rdi, [rbp-224]
+  imul rax, rdi
+  mov [rbp-232], rax
+  mov [rbp-72], rax
+  jmp .Lmain.6
+.Lmain.8:
+  mov rax, [rbp-64]
+  mov [rbp-240], rax
+  mov rax, 5
+  mov [rbp-248], rax
+  mov rax, [rbp-240]
+  mov rdi, [rbp-248]
+  add rax, rdi
+  mov [rbp-256], rax
+  mov [rbp-72], rax
+.Lmain.6:
+  mov rax, [rbp-72]
+  mov [rbp-264], rax
+  mov [rbp-32], rax
+  mov [rbp-272], rax
+.Lmain.13:
+  mov rsp, rbp
+  pop rbp
+  ret
+.globl incremental_probe
+incremental_probe:
+  push rbp
+  mov rbp, rsp
+  sub rsp, 48
+  mov [rbp-8], rdi
+.Lincremental_probe.0:
+  mov rax, [rbp-8]
+  mov [rbp-16], rax
+  mov rax, [rax]
+  mov [rbp-24], rax
+  mov rax, 1
+  mov [rbp-32], rax
+  mov rax, [rbp-24]
+  mov rdi, [rbp-32]
+  add rax, rdi
+  mov [rbp-40], rax
+.Lincremental_probe.2:
+  mov rsp, rbp
+  pop rbp
+  ret